@@ -1,9 +1,16 @@
 #pragma once
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
+#include "backend_options.hpp"
+#include "backpressure.hpp"
+#include "clock_source.hpp"
 #include "log_entry.hpp"
+#include "log_record.hpp"
+#include "overflow_chain.hpp"
+#include "percpu_ring.hpp"
 #include "platform.hpp"
 #include "ring_buffer.hpp"
 #include "sinks/sink_interface.hpp"
@@ -15,37 +22,336 @@
 namespace br_logger
 {
 
+static_assert(K_MAX_RECORD_SIZE <= MPSCByteRingBuffer<BR_LOG_RING_BYTES>::K_MAX_RECORD_SIZE,
+              "BR_LOG_RING_BYTES too small for the largest log record");
+static_assert(K_MAX_RECORD_SIZE <=
+                  SPSCByteRingBuffer<BR_LOG_THREAD_RING_BYTES>::K_MAX_RECORD_SIZE,
+              "BR_LOG_THREAD_RING_BYTES too small for the largest log record");
+static_assert(K_MAX_RECORD_SIZE <=
+                  MPSCByteRingBuffer<BR_LOG_PRIORITY_RING_BYTES>::K_MAX_RECORD_SIZE,
+              "BR_LOG_PRIORITY_RING_BYTES too small for the largest log record");
+static_assert(K_MAX_RECORD_SIZE <= OverflowChain::Segment::K_MAX_RECORD_SIZE,
+              "BR_LOG_OVERFLOW_SEGMENT_BYTES too small for the largest log record");
+
+// 队列拓扑
+enum class QueueTopology : uint8_t
+{
+  SHARED_MPSC = 0,      // 所有线程共用一个 MPSC 队列
+  PER_THREAD_SPSC = 1,  // 每个线程首次写日志时注册自己的 SPSC 队列，后端按时间戳归并
+  PER_CPU_RSEQ = 2,     // 每个 CPU 一个队列，rseq 预留；不支持 rseq 时退回 SHARED_MPSC
+};
+
+#if BR_LOG_PER_CPU_QUEUES
+constexpr QueueTopology K_DEFAULT_QUEUE_TOPOLOGY = QueueTopology::PER_CPU_RSEQ;
+#elif BR_LOG_PER_THREAD_QUEUES
+constexpr QueueTopology K_DEFAULT_QUEUE_TOPOLOGY = QueueTopology::PER_THREAD_SPSC;
+#else
+constexpr QueueTopology K_DEFAULT_QUEUE_TOPOLOGY = QueueTopology::SHARED_MPSC;
+#endif
+
+// 队列通道：WARN 及以上走独立的小容量高优先级队列，不会被低级别日志挤占，
+// 后端每轮先处理该队列（因此跨通道的分发顺序不再严格按时间）
+enum class QueueLane : uint8_t
+{
+  NORMAL = 0,
+  PRIORITY = 1,
+};
+
+constexpr LogLevel K_PRIORITY_LEVEL = LogLevel::WARN;
+
+
 class LoggerBackend
 {
  public:
+  using Ring = MPSCByteRingBuffer<BR_LOG_RING_BYTES>;
+  using PriorityRing = MPSCByteRingBuffer<BR_LOG_PRIORITY_RING_BYTES>;
+  using Reservation = ByteReservation;
+
   LoggerBackend();
   ~LoggerBackend();
 
   // 生产者调用（业务线程）
   bool TryPush(const LogEntry& entry);
 
-  // 管理 Sink
-  void AddSink(std::unique_ptr<ILogSink> sink);
+  // 零拷贝写入：在队列中预留 size 字节，原地写好记录后提交。
+  // level 不低于 K_PRIORITY_LEVEL 时先尝试高优先级队列，满了再退回普通队列
+  Reservation TryReserve(uint32_t size, LogLevel level = LogLevel::INFO)
+  {
+    if (level >= K_PRIORITY_LEVEL)
+    {
+      Reservation reservation = priority_ring_.TryReserve(size);
+      if (reservation)
+      {
+        return reservation;
+      }
+    }
+    // 溢出链启用后新记录先写入链中，直到后端把链取空；链也写满时退回普通队列及其背压策略，
+    // 后端按归并键在普通队列与链之间排序
+    const bool spilled = overflow_active_.load(std::memory_order_relaxed);
+    if (spilled)
+    {
+      Reservation reservation = overflow_.TryReserve(size);
+      if (reservation)
+      {
+        return reservation;
+      }
+    }
+    Reservation reservation;
+    switch (topology_.load(std::memory_order_relaxed))
+    {
+      case QueueTopology::PER_THREAD_SPSC:
+        reservation = LocalQueue().ring.TryReserve(size);
+        break;
+      case QueueTopology::PER_CPU_RSEQ:
+        reservation = percpu_->TryReserve(size);
+        break;
+      default:
+        reservation = ring_.TryReserve(size);
+        break;
+    }
+    if (!reservation && !spilled && overflow_.Enabled())
+    {
+      return Spill(size);
+    }
+    return reservation;
+  }
+  void Commit(const Reservation& reservation, uint32_t size)
+  {
+    Ring::Commit(reservation, size);
+#if BR_LOG_HAS_THREAD
+    if (idle_strategy_.load(std::memory_order_relaxed) == IdleStrategy::BLOCKING)
+    {
+      // 与后端登记睡眠后的再次检查配对：提交先于读取睡眠标志
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (worker_sleeping_.load(std::memory_order_relaxed))
+      {
+        WakeWorker();
+      }
+    }
+#endif
+  }
+
+  // 按 level 对应的背压策略预留：队列满时丢弃或等待，返回空预留表示本条被丢弃（已计入统计）
+  Reservation Reserve(uint32_t size, LogLevel level)
+  {
+    Reservation reservation = TryReserve(size, level);
+    if (reservation)
+    {
+      return reservation;
+    }
+    return ReserveSlow(size, level);
+  }
+
+  // 弹性溢出：普通队列写满时写入预分配的溢出段链，总容量不超过 capacity_bytes（0 关闭）。
+  // 须在 Start 与开始写日志之前调用；默认容量为 BR_LOG_OVERFLOW_BYTES
+  void SetOverflowCapacity(size_t capacity_bytes);
+  OverflowStats GetOverflowStats() const;
+
+  // 各通道未能写入而丢弃的条数（按记录所属通道统计）
+  uint64_t LaneDropCount(QueueLane lane) const;
 
-  // 启动/停止后端线程
+  // 背压策略，默认所有级别 DROP_NEWEST，可在运行中修改
+  void SetBackpressurePolicy(const BackpressurePolicy& policy);
+  BackpressurePolicy GetBackpressurePolicy() const;
+  BackpressureStats GetBackpressureStats() const;
+  void ResetBackpressureStats();
+
+  // 时钟源：业务线程用 ReadClock 取原始读数写入记录，后端换算为纳秒。
+  // 当前平台不支持的时钟源退回 PRECISE；选择 TSC 时会做一次约 10ms 的标定
+  void SetClockSource(ClockSource source);
+  ClockSource GetClockSource() const;
+  ClockSource ReadClock(uint64_t& ticks) const
+  {
+    ClockSource source = clock_source_.load(std::memory_order_acquire);
+    ticks = read_clock(source);
+    return source;
+  }
+
+  // 选择队列拓扑，应在 Start 与开始写日志之前调用；
+  // 请求 PER_CPU_RSEQ 但当前环境不支持 rseq 时使用 SHARED_MPSC，可用 GetQueueTopology 确认
+  void SetQueueTopology(QueueTopology topology);
+  QueueTopology GetQueueTopology() const;
+
+  // 当前已注册的线程队列数（含已退出但尚未取完的线程）
+  size_t ThreadQueueCount() const;
+
+  // 管理 Sink，须在 Start 前调用。shard 为多后端线程时写该 Sink 的分片（对线程数取模），
+  // K_AUTO_SHARD 按添加顺序轮流分配；同一个 Sink 总在同一线程上按顺序收到记录
+  static constexpr uint32_t K_AUTO_SHARD = UINT32_MAX;
+  void AddSink(std::unique_ptr<ILogSink> sink, uint32_t shard = K_AUTO_SHARD);
+
+  // 启动/停止后端线程。Start() 沿用当前的空闲策略与默认线程参数，
+  // Start(options) 按 options 设置后端线程并返回实际生效的项
   void Start();
+  AppliedBackendOptions Start(const BackendOptions& options);
+  AppliedBackendOptions GetAppliedOptions() const;
   void Stop();  // 设置 running_ = false，等待线程退出，drain 残留日志
 
+  // 后端线程的空闲等待方式，可在运行中切换
+  void SetIdleStrategy(IdleStrategy strategy);
+  IdleStrategy GetIdleStrategy() const;
+
   // 嵌入式模式：无线程，手动调用 drain
   size_t Drain(size_t max_entries = 64);
 
  private:
-  MPSCRingBuffer<LogEntry, BR_LOG_RING_SIZE> ring_;
+  struct ThreadQueue
+  {
+    SPSCByteRingBuffer<BR_LOG_THREAD_RING_BYTES> ring;
+    std::atomic<bool> retired{false};  // 所属线程已退出
+  };
+
+  Ring ring_;
+  PriorityRing priority_ring_;
   std::vector<std::unique_ptr<ILogSink>> sinks_;
+  std::vector<uint32_t> sink_shards_;   // 与 sinks_ 一一对应
+  std::vector<ILogSink*> local_sinks_;  // 取队列的线程直接写的 Sink：未分片时为全部 Sink
   std::atomic<bool> running_{false};
+  std::atomic<QueueTopology> topology_{QueueTopology::SHARED_MPSC};
+  std::unique_ptr<PerCpuRing> percpu_;  // 首次选择 PER_CPU_RSEQ 时创建
+  std::atomic<ClockSource> clock_source_{ClockSource::PRECISE};
+  ClockConverter clock_;  // 仅消费者使用
+  // 消费者复用的解码缓冲，不清零：每条记录只写入用到的字段，
+  // msg_len / tag_count 之外的 msg 与 tags 不会被读取。
+  // 解码后的记录攒满一批（或本次 Drain 结束）时通过 WriteBatch 分发。
+  // 分片时 batch_storage_ 为 BR_LOG_SHARD_BATCHES 个批槽，batch_ 指向正在填充的槽
+  std::unique_ptr<LogEntry[]> batch_storage_;
+  LogEntry* batch_ = nullptr;
+  size_t batch_size_ = 0;
+  bool sharded_ = false;
+
+  // 线程队列：注册与回收在 queues_mutex_ 下进行，
+  // 消费者在 queues_generation_ 变化时刷新自己的 active_queues_ 快照
+  const uint64_t id_;
+  mutable std::mutex queues_mutex_;
+  std::vector<std::shared_ptr<ThreadQueue>> queues_;
+  std::atomic<uint64_t> queues_generation_{0};
+  std::vector<std::shared_ptr<ThreadQueue>> active_queues_;
+  uint64_t active_generation_ = 0;
 
 #if BR_LOG_HAS_THREAD
   std::thread worker_;
   void WorkerLoop();
+  // BLOCKING：后端在 worker_seq_ 上睡眠前置位 worker_sleeping_，
+  // 生产者提交后看到该标志才递增 worker_seq_ 并唤醒，只有第一个看到的生产者进入内核
+  void WakeWorker();
+  void Park();
+
+  // Sink 分片：取队列的线程按顺序发布批槽（published_ 为已发布的批数），
+  // 各分片线程按同样顺序读取并推进自己的 consumed；所有分片都读完的批槽才会被再次填充。
+  // 分片线程在 shard_seq_ 上睡眠；后端线程等待批槽时在 progress_seq_ 上睡眠
+  struct Shard
+  {
+    std::vector<ILogSink*> sinks;
+    alignas(BR_LOG_CACHELINE_SIZE) std::atomic<uint32_t> consumed{0};
+    std::thread thread;
+  };
+  std::vector<std::unique_ptr<Shard>> shards_;
+  uint32_t slot_sizes_[BR_LOG_SHARD_BATCHES] = {};
+  alignas(BR_LOG_CACHELINE_SIZE) std::atomic<uint32_t> published_{0};
+  std::atomic<bool> shards_running_{false};
+  std::atomic<uint32_t> shard_seq_{0};
+  std::atomic<uint32_t> shard_sleepers_{0};
+  alignas(BR_LOG_CACHELINE_SIZE) std::atomic<uint32_t> progress_seq_{0};
+  std::atomic<bool> dispatcher_waiting_{false};
+
+  void StartShards(const BackendOptions& options);
+  void StopShards();
+  void ShardLoop(Shard* shard);
+  LogEntry* SlotEntries(uint32_t seq) const
+  {
+    return batch_storage_.get() + (seq % BR_LOG_SHARD_BATCHES) * BR_LOG_DISPATCH_BATCH;
+  }
+  bool SlotFree(uint32_t seq) const;
 #endif
+  std::atomic<IdleStrategy> idle_strategy_{IdleStrategy::BLOCKING};
+  // 空闲阈值只在 Start 前写入，后端线程读取
+  uint32_t idle_spin_ = BackendOptions{}.spin_iterations;
+  uint32_t idle_yield_ = BackendOptions{}.yield_iterations;
+  uint64_t idle_sleep_ns_ = BackendOptions{}.sleep_ns;
+  AppliedBackendOptions applied_options_;
+  alignas(BR_LOG_CACHELINE_SIZE) std::atomic<bool> worker_sleeping_{false};
+  std::atomic<uint32_t> worker_seq_{0};
+
+  // 背压：策略以原子量保存，只在队列满的慢路径上读取。
+  // DROP_OLDEST 通过 discard_requests_ 请求消费者丢弃队首记录；
+  // 等待中的生产者在 space_seq_ 上睡眠，消费者归还空间后若有等待者则递增并唤醒
+  struct BackpressureCounters
+  {
+    std::atomic<uint64_t> dropped_newest{0};
+    std::atomic<uint64_t> dropped_oldest{0};
+    std::atomic<uint64_t> wait_timeouts{0};
+    std::atomic<uint64_t> bounded_waits{0};
+    std::atomic<uint64_t> blocks{0};
+    std::atomic<uint64_t> wait_ns{0};
+  };
+  std::atomic<OverflowAction> overflow_actions_[BackpressurePolicy::K_LEVELS] = {};
+  std::atomic<uint32_t> spin_count_{BackpressurePolicy{}.spin_count};
+  std::atomic<uint64_t> wait_timeout_ns_{BackpressurePolicy{}.wait_timeout_ns};
+  BackpressureCounters backpressure_;
+  std::atomic<uint32_t> discard_requests_{0};
+  alignas(BR_LOG_CACHELINE_SIZE) std::atomic<uint32_t> space_seq_{0};
+  std::atomic<uint32_t> space_waiters_{0};
+
+  std::atomic<uint64_t> lane_drops_[2] = {};
+
+  // 溢出链：overflow_active_ 由首个溢出的生产者置位，链取空后由消费者清除
+  OverflowChain overflow_;
+  std::atomic<bool> overflow_active_{false};
+  Reservation Spill(uint32_t size);
+  // 消费者：读取溢出链队首，链已取空时清除 overflow_active_
+  const uint8_t* PeekOverflow(uint32_t& size);
+
+  Reservation ReserveSlow(uint32_t size, LogLevel level);
+  void CountLaneDrop(LogLevel level);
+  // 消费者：处理一条高优先级记录，队列为空时返回 false
+  bool DrainPriority();
+  bool CanWait() const;
+  // 消费者：有未处理的 DROP_OLDEST 请求时认领一个
+  bool TakeDiscardRequest();
+  // 消费者：归还空间后唤醒等待的生产者
+  void NotifySpace();
+
+  // 当前线程在本 backend 上的 SPSC 队列，首次调用时注册
+  ThreadQueue& LocalQueue();
+  void RefreshThreadQueues();
+  void ReapThreadQueues();
+  size_t DrainMerged(size_t max_entries);
+
+  // 归并堆：各非空队列的队首按 (单调纳秒, sequence_id) 排成最小堆，取走一条后只重新读取该队列。
+  // source 为 0 表示共享队列，1..N 为 active_queues_，其后为各 CPU 队列，最后一个为溢出链
+  struct MergeHead
+  {
+    uint64_t mono_ns;
+    uint64_t sequence_id;
+    const uint8_t* data;
+    size_t source;
+  };
+  std::vector<MergeHead> merge_heap_;
+  std::vector<uint8_t> merge_queued_;  // 按 source 标记其队首是否已在堆中
+  static bool MergeAfter(const MergeHead& a, const MergeHead& b);
+  const uint8_t* PeekSource(size_t source, uint32_t& size);
+  void ReleaseSource(size_t source);
+  void PushMergeHead(size_t source);
+  // 补入此前为空、现在有记录的队列
+  void RefillMergeHeap();
 
-  // 将一条 entry 分发到所有 sink
-  void Dispatch(const LogEntry& entry);
+  // 把记录解码进批缓冲；批满后须先归还队列空间再调用 DispatchBatch
+  void Decode(const uint8_t* record)
+  {
+    if (batch_size_ == 0 && sharded_)
+    {
+      AcquireSlot();
+    }
+    decode_record(record, batch_[batch_size_++], clock_);
+  }
+  // 分片时等待下一个批槽被所有分片读完
+  void AcquireSlot();
+  bool BatchFull() const { return batch_size_ == BR_LOG_DISPATCH_BATCH; }
+  void DispatchBatch();
+  // 队列取空且上次空闲之后分发过记录时通知各 Sink
+  void NotifyIdle();
+  bool dispatched_since_idle_ = false;
 };
 
 }  // namespace br_logger
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "platform.hpp"
+
+#if BR_LOG_HAS_THREAD
+#include <thread>
+#endif
+
+namespace br_logger
+{
+
+// 后端线程空闲时的等待方式
+enum class IdleStrategy : uint8_t
+{
+  BUSY_SPIN = 0,  // 一直轮询，延迟最低但始终占满一个核
+  BLOCKING = 1,   // 轮询 spin_iterations 次后在 futex 上睡眠，生产者提交时仅在后端睡眠时唤醒（默认）
+  HYBRID = 2,     // 轮询 spin_iterations 次、yield yield_iterations 次，之后每次休眠 sleep_ns
+};
+
+// 后端线程的调度类，对应 Linux 的 SCHED_OTHER / SCHED_BATCH / SCHED_IDLE
+enum class SchedClass : uint8_t
+{
+  DEFAULT = 0,  // 不修改
+  BATCH = 1,
+  IDLE = 2,
+};
+
+// Logger::Start 的后端线程参数；亲和性、调度类与线程名仅在 Linux 上生效
+struct BackendOptions
+{
+  IdleStrategy idle_strategy = IdleStrategy::BLOCKING;
+  uint32_t spin_iterations = 128;
+  uint32_t yield_iterations = 1000;
+  uint64_t sleep_ns = 100'000;
+
+  std::vector<int> cpu_affinity;  // 允许运行的 CPU 编号，为空表示不绑定
+  SchedClass sched_class = SchedClass::DEFAULT;
+  const char* thread_name = "br_log_backend";  // 超过 15 字节的部分被截断，nullptr 表示不设置
+
+  // 后端线程数。大于 1 时 Sink 按 AddSink 指定的分片分给各线程：第一个线程取队列并写 0 号分片，
+  // 其余线程各写一个分片（线程名加 "/<分片号>" 后缀），慢的格式化与 I/O 不再串行
+  uint32_t worker_count = 1;
+};
+
+// Start 实际生效的设置：未请求的项，以及请求了但失败（权限、CPU 不存在、平台不支持等）的项为 false
+struct AppliedBackendOptions
+{
+  IdleStrategy idle_strategy = IdleStrategy::BLOCKING;
+  bool affinity_applied = false;
+  bool sched_class_applied = false;
+  bool thread_name_applied = false;
+  uint32_t worker_count = 1;  // 实际运行的后端线程数，没有分到 Sink 的分片不启动线程
+};
+
+#if BR_LOG_HAS_THREAD
+// 对已创建的线程应用亲和性、调度类与线程名，结果写入 applied
+void apply_thread_options(std::thread& thread, const BackendOptions& options,
+                          AppliedBackendOptions& applied);
+#endif
+
+}  // namespace br_logger
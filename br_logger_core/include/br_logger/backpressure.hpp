@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+
+#include "log_level.hpp"
+
+namespace br_logger
+{
+
+// 队列写满时的处理方式
+enum class OverflowAction : uint8_t
+{
+  DROP_NEWEST = 0,   // 直接丢弃当前这条（默认）
+  DROP_OLDEST = 1,   // 请求后端丢弃队首最旧的记录腾出空间，等待至多 wait_timeout_ns
+  BOUNDED_WAIT = 2,  // 先自旋再在 futex 上等待，超过 wait_timeout_ns 仍无空间则丢弃
+  BLOCK = 3,         // 一直等待直到有空间；后端线程未运行时退化为丢弃
+};
+
+// 按日志级别配置的背压策略。例如 TRACE/DEBUG 直接丢弃、WARN 及以上阻塞：
+//   auto policy = BackpressurePolicy::Uniform(OverflowAction::DROP_NEWEST);
+//   policy.SetAction(LogLevel::WARN, OverflowAction::BLOCK);  // WARN/ERROR/FATAL
+struct BackpressurePolicy
+{
+  static constexpr int K_LEVELS = static_cast<int>(LogLevel::OFF);
+
+  OverflowAction actions[K_LEVELS] = {};
+  uint32_t spin_count = 128;             // 进入 futex 等待前的重试次数
+  uint64_t wait_timeout_ns = 1'000'000;  // BOUNDED_WAIT / DROP_OLDEST 的最长等待
+
+  static BackpressurePolicy Uniform(OverflowAction action)
+  {
+    BackpressurePolicy policy;
+    for (auto& a : policy.actions)
+    {
+      a = action;
+    }
+    return policy;
+  }
+
+  // 为 min_level 及以上的所有级别设置 action
+  void SetAction(LogLevel min_level, OverflowAction action)
+  {
+    for (int i = static_cast<int>(min_level); i < K_LEVELS; ++i)
+    {
+      actions[i] = action;
+    }
+  }
+
+  OverflowAction Action(LogLevel level) const
+  {
+    int i = static_cast<int>(level);
+    return i < K_LEVELS ? actions[i] : OverflowAction::DROP_NEWEST;
+  }
+};
+
+// 各处理方式的计数，用于按实际负载调整队列容量
+struct BackpressureStats
+{
+  uint64_t dropped_newest = 0;  // DROP_NEWEST 丢弃，以及无法等待时退化的丢弃
+  uint64_t dropped_oldest = 0;  // DROP_OLDEST：后端丢弃的旧记录
+  uint64_t wait_timeouts = 0;   // BOUNDED_WAIT / DROP_OLDEST 等待超时后丢弃
+  uint64_t bounded_waits = 0;   // BOUNDED_WAIT / DROP_OLDEST 进入等待的次数
+  uint64_t blocks = 0;          // BLOCK 进入等待的次数
+  uint64_t wait_ns = 0;         // 累计等待时长
+};
+
+}  // namespace br_logger
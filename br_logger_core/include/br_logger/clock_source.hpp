@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+
+#include "platform.hpp"
+#include "timestamp.hpp"
+
+#if defined(BR_LOG_PLATFORM_LINUX) && !BR_LOG_EMBEDDED
+#include <ctime>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && !BR_LOG_EMBEDDED
+#define BR_LOG_HAS_TSC 1
+#include <x86intrin.h>
+#else
+#define BR_LOG_HAS_TSC 0
+#endif
+
+namespace br_logger
+{
+
+// 业务线程的时钟源：每条日志只读取一次原始计数，后端线程再换算成
+// 单调时间（CLOCK_MONOTONIC_RAW 域）与墙钟时间
+enum class ClockSource : uint8_t
+{
+  PRECISE = 0,  // CLOCK_MONOTONIC_RAW，精度最高
+  COARSE = 1,   // CLOCK_MONOTONIC_COARSE，分辨率为一个内核 tick（通常 1-4ms），仅 Linux
+  TSC = 2,      // rdtsc，启动时标定频率，仅 x86 且需要 invariant TSC
+};
+
+// 记录中的时间已经是纳秒（例如直接推入的 LogEntry），无需换算
+constexpr uint8_t K_CLOCK_NANOS = 0xFF;
+
+// 读取 source 对应的原始计数
+inline uint64_t read_clock(ClockSource source)
+{
+#if BR_LOG_HAS_TSC
+  if (source == ClockSource::TSC)
+  {
+    return __rdtsc();
+  }
+#endif
+#if defined(BR_LOG_PLATFORM_LINUX) && !BR_LOG_EMBEDDED
+  if (source == ClockSource::COARSE)
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL +
+           static_cast<uint64_t>(ts.tv_nsec);
+  }
+#endif
+  (void)source;
+  return monotonic_now_ns();
+}
+
+// 当前平台是否支持 source；不支持的时钟源在选择时退回 PRECISE
+bool clock_source_available(ClockSource source);
+
+// 原始计数到纳秒的换算，只在后端线程使用。
+// 墙钟偏移与 TSC 频率每隔 K_REFRESH_INTERVAL_NS 重新标定一次，
+// 以跟踪 NTP 调整并逐步拉长 TSC 频率的测量基线
+class ClockConverter
+{
+ public:
+  static constexpr uint64_t K_REFRESH_INTERVAL_NS = 1'000'000'000ULL;
+
+  ClockConverter();
+
+  void Convert(uint8_t clock, uint64_t ticks, uint64_t& mono_ns, uint64_t& wall_ns);
+
+  // 距上次标定超过刷新间隔时重新标定
+  void MaybeRefresh();
+  void Refresh();
+
+ private:
+  uint64_t last_refresh_ns_ = 0;
+  int64_t raw_to_wall_ns_ = 0;
+  int64_t coarse_to_raw_ns_ = 0;
+
+  // TSC：mono = mono_base + (tsc - tsc_base) * tsc_mult >> 32
+  uint64_t tsc_base_ = 0;
+  uint64_t tsc_mono_base_ = 0;
+  uint64_t tsc_mult_ = 0;
+};
+
+}  // namespace br_logger
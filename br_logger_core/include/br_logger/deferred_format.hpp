@@ -0,0 +1,400 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "platform.hpp"
+#include "printf_format.hpp"
+
+#ifdef BR_LOG_USE_FMTLIB
+#include <fmt/format.h>
+#endif
+
+// 延迟格式化：业务线程只拷贝参数的二进制值，后端线程再做真正的格式化
+// 通过 CMake -DBR_LOG_DEFERRED_FORMAT=ON 开启
+#ifndef BR_LOG_DEFERRED_FORMAT
+#define BR_LOG_DEFERRED_FORMAT 0
+#endif
+
+namespace br_logger
+{
+
+// 后端格式化函数：根据 fmt 与编码后的参数生成消息正文，返回正文长度（不含 '\0'）
+using DeferredFormatFn = size_t (*)(const char* fmt, const char* args, size_t args_len,
+                                    char* buf, size_t buf_size);
+
+namespace detail
+{
+
+template <typename T>
+using Decay = std::decay_t<T>;
+
+// char* / const char* / char[N]：按值拷贝字符串内容，保证生命周期安全
+template <typename T>
+struct IsCStringArg
+    : std::bool_constant<std::is_same_v<Decay<T>, const char*> ||
+                         std::is_same_v<Decay<T>, char*>>
+{
+};
+
+template <typename T>
+struct IsStringArg
+#ifdef BR_LOG_USE_FMTLIB
+    : std::bool_constant<IsCStringArg<T>::value ||
+                         std::is_same_v<Decay<T>, std::string> ||
+                         std::is_same_v<Decay<T>, std::string_view>>
+#else
+    : IsCStringArg<T>
+#endif
+{
+};
+
+// 标量：算术类型、枚举、非字符指针，直接 memcpy 原始值
+template <typename T>
+struct IsScalarArg
+    : std::bool_constant<!IsStringArg<T>::value &&
+                         (std::is_arithmetic_v<Decay<T>> || std::is_enum_v<Decay<T>> ||
+                          std::is_pointer_v<Decay<T>>)>
+{
+};
+
+// 字符串编码：uint16_t 长度 + 内容 + '\0'，空指针长度记为 K_NULL_STRING
+constexpr uint16_t K_NULL_STRING = 0xFFFF;
+constexpr size_t K_STRING_OVERHEAD = sizeof(uint16_t) + 1;
+
+template <typename T>
+constexpr size_t fixed_arg_size()
+{
+  if constexpr (IsStringArg<T>::value)
+  {
+    return K_STRING_OVERHEAD;
+  }
+  else
+  {
+    return sizeof(Decay<T>);
+  }
+}
+
+template <typename... Args>
+struct IsDeferrableArgs
+    : std::bool_constant<((IsStringArg<Args>::value || IsScalarArg<Args>::value) &&
+                          ...) &&
+                         (fixed_arg_size<Args>() + ... + 0) <= BR_LOG_MAX_MSG_LEN>
+{
+};
+
+inline std::string_view string_arg_view(const char* s)
+{
+  return s ? std::string_view(s) : std::string_view();
+}
+inline std::string_view string_arg_view(const std::string& s) { return s; }
+inline std::string_view string_arg_view(std::string_view s) { return s; }
+
+class ArgWriter
+{
+ public:
+  ArgWriter(char* dst, size_t cap) : pos_(dst), end_(dst + cap) {}
+
+  template <typename T>
+  void Write(const T& arg)
+  {
+    if constexpr (IsStringArg<T>::value)
+    {
+      WriteString(arg);
+    }
+    else
+    {
+      Decay<T> value = arg;
+      std::memcpy(pos_, &value, sizeof(value));
+      pos_ += sizeof(value);
+      reserved_ -= sizeof(value);
+    }
+  }
+
+  // 固定部分已由 IsDeferrableArgs 保证放得下，字符串按剩余空间截断
+  void Reserve(size_t fixed) { reserved_ = fixed; }
+
+  char* Position() const { return pos_; }
+
+ private:
+  template <typename T>
+  void WriteString(const T& arg)
+  {
+    reserved_ -= K_STRING_OVERHEAD;
+    if constexpr (IsCStringArg<T>::value)
+    {
+      const char* str = arg;
+      if (str == nullptr)
+      {
+        uint16_t len = K_NULL_STRING;
+        std::memcpy(pos_, &len, sizeof(len));
+        pos_ += sizeof(len);
+        return;
+      }
+    }
+    std::string_view sv = string_arg_view(arg);
+    size_t avail = static_cast<size_t>(end_ - pos_) - K_STRING_OVERHEAD - reserved_;
+    if (sv.size() < avail)
+    {
+      avail = sv.size();
+    }
+    uint16_t len = static_cast<uint16_t>(avail);
+    std::memcpy(pos_, &len, sizeof(len));
+    pos_ += sizeof(len);
+    std::memcpy(pos_, sv.data(), len);
+    pos_ += len;
+    *pos_++ = '\0';
+  }
+
+  char* pos_;
+  char* end_;
+  size_t reserved_ = 0;
+};
+
+class ArgReader
+{
+ public:
+  explicit ArgReader(const char* src) : pos_(src) {}
+
+  template <typename T>
+  auto Read()
+  {
+    if constexpr (IsStringArg<T>::value)
+    {
+      uint16_t len = 0;
+      std::memcpy(&len, pos_, sizeof(len));
+      pos_ += sizeof(len);
+      const char* str = nullptr;
+      if (len != K_NULL_STRING)
+      {
+        str = pos_;
+        pos_ += len + 1;
+      }
+#ifdef BR_LOG_USE_FMTLIB
+      if constexpr (!IsCStringArg<T>::value)
+      {
+        return std::string_view(str, len);
+      }
+      else
+#endif
+      {
+        return str;
+      }
+    }
+    else
+    {
+      Decay<T> value;
+      std::memcpy(&value, pos_, sizeof(value));
+      pos_ += sizeof(value);
+      return value;
+    }
+  }
+
+ private:
+  const char* pos_;
+};
+
+template <typename T>
+size_t encoded_arg_size(const T& arg)
+{
+  if constexpr (IsStringArg<T>::value)
+  {
+    return K_STRING_OVERHEAD + string_arg_view(arg).size();
+  }
+  else
+  {
+    (void)arg;
+    return sizeof(Decay<T>);
+  }
+}
+
+// 编码参数所需的字节数上限（不超过 BR_LOG_MAX_MSG_LEN），供业务线程按需预留后原地编码
+template <typename... Args>
+size_t encoded_args_size(const Args&... args)
+{
+  size_t size = (encoded_arg_size(args) + ... + 0);
+  return size < BR_LOG_MAX_MSG_LEN ? size : BR_LOG_MAX_MSG_LEN;
+}
+
+// 把参数编码进 dst，返回编码后的字节数
+template <typename... Args>
+size_t encode_args(char* dst, size_t cap, const Args&... args)
+{
+  ArgWriter writer(dst, cap);
+  writer.Reserve((fixed_arg_size<Args>() + ... + 0));
+  (writer.Write(args), ...);
+  return static_cast<size_t>(writer.Position() - dst);
+}
+
+template <typename... Args>
+size_t format_deferred(const char* fmt, const char* args, size_t args_len, char* buf,
+                       size_t buf_size)
+{
+  (void)args_len;
+  if (buf_size == 0)
+  {
+    return 0;
+  }
+  ArgReader reader(args);
+  // 花括号初始化保证参数按从左到右的顺序解码
+  std::tuple<decltype(reader.template Read<Args>())...> values{
+      reader.template Read<Args>()...};
+#ifdef BR_LOG_USE_FMTLIB
+  size_t len = 0;
+  try
+  {
+    len = std::apply(
+        [&](const auto&... v)
+        { return fmt::format_to_n(buf, buf_size - 1, fmt::runtime(fmt), v...).size; },
+        values);
+  }
+  catch (const std::exception& e)
+  {
+    len = static_cast<size_t>(
+        std::snprintf(buf, buf_size, "<format error: %s>", e.what()));
+  }
+  if (len >= buf_size)
+  {
+    len = buf_size - 1;
+  }
+  buf[len] = '\0';
+  return len;
+#else
+  if constexpr (sizeof...(Args) == 0)
+  {
+    // 与即时路径一致：无参数时原样拷贝
+    size_t len = std::strlen(fmt);
+    if (len >= buf_size)
+    {
+      len = buf_size - 1;
+    }
+    std::memcpy(buf, fmt, len);
+    buf[len] = '\0';
+    return len;
+  }
+  else
+  {
+    int written = std::apply([&](auto... v) { return std::snprintf(buf, buf_size, fmt, v...); },
+                             values);
+    if (written <= 0)
+    {
+      buf[0] = '\0';
+      return 0;
+    }
+    return (static_cast<size_t>(written) < buf_size) ? static_cast<size_t>(written)
+                                                     : (buf_size - 1);
+  }
+#endif
+}
+
+#ifndef BR_LOG_USE_FMTLIB
+// 与 format_deferred 相同，但正文按编译期解析的 Source 格式串生成（fmt 不再使用）
+template <typename Source, typename... Args>
+size_t format_deferred_printf(const char* fmt, const char* args, size_t args_len, char* buf,
+                              size_t buf_size)
+{
+  (void)fmt;
+  (void)args_len;
+  ArgReader reader(args);
+  std::tuple<decltype(reader.template Read<Args>())...> values{
+      reader.template Read<Args>()...};
+  return std::apply([&](const auto&... v) { return format_printf<Source>(buf, buf_size, v...); },
+                    values);
+}
+#endif
+
+// 编译期格式串中消费第 arg 个参数的转换符；'*' 宽度 / 精度参数与运行期格式串返回 '\0'
+template <typename Source>
+constexpr char printf_arg_conv(size_t arg)
+{
+  if constexpr (std::is_same_v<Source, RuntimePrintf>)
+  {
+    (void)arg;
+    return '\0';
+  }
+  else
+  {
+    const auto& format = PrintfParsed<Source>::K_FORMAT;
+    for (size_t i = 0; i < format.count; ++i)
+    {
+      if (format.specs[i].conv != '\0' && static_cast<size_t>(format.specs[i].arg) == arg)
+      {
+        return format.specs[i].conv;
+      }
+    }
+    return '\0';
+  }
+}
+
+// 参数在记录中的捕获类型：被 %p 消费的 char* 只是地址，按 const void* 捕获而不拷贝内容
+template <typename Source, size_t I, typename T>
+using DeferredCapture =
+    std::conditional_t<IsCStringArg<T>::value && printf_arg_conv<Source>(I) == 'p', const void*,
+                       Decay<T>>;
+
+template <typename Capture, typename T>
+decltype(auto) capture_arg(const T& arg)
+{
+  if constexpr (std::is_same_v<Capture, const void*> && IsCStringArg<T>::value)
+  {
+    return static_cast<const void*>(arg);
+  }
+  else
+  {
+    return (arg);
+  }
+}
+
+// 一组捕获类型对应的编码 / 解码入口，业务线程与后端线程使用同一组类型
+template <typename... Captures>
+struct DeferredCodec
+{
+  static constexpr bool K_DEFERRABLE = IsDeferrableArgs<Captures...>::value;
+
+  template <typename... Args>
+  static size_t EncodedSize(const Args&... args)
+  {
+    return encoded_args_size(capture_arg<Captures>(args)...);
+  }
+
+  template <typename... Args>
+  static size_t Encode(char* dst, size_t cap, const Args&... args)
+  {
+    return encode_args(dst, cap, capture_arg<Captures>(args)...);
+  }
+
+  template <typename Source>
+  static DeferredFormatFn FormatFn()
+  {
+#ifndef BR_LOG_USE_FMTLIB
+    if constexpr (!std::is_same_v<Source, RuntimePrintf>)
+    {
+      return &format_deferred_printf<Source, Captures...>;
+    }
+    else
+#endif
+    {
+      return &format_deferred<Captures...>;
+    }
+  }
+};
+
+template <typename Source, typename... Args>
+struct DeferredCodecFor
+{
+  template <size_t... I>
+  static DeferredCodec<DeferredCapture<Source, I, Args>...> Make(std::index_sequence<I...>);
+
+  using Type = decltype(Make(std::index_sequence_for<Args...>{}));
+};
+
+}  // namespace detail
+
+}  // namespace br_logger
@@ -4,6 +4,11 @@
 namespace br_logger
 {
 
+namespace detail
+{
+struct JsonFragmentTable;
+}  // namespace detail
+
 class JsonFormatter : public IFormatter
 {
  public:
@@ -11,9 +16,8 @@ class JsonFormatter : public IFormatter
   size_t Format(const LogEntry& entry, char* buf, size_t buf_size) override;
 
  private:
-  bool pretty_;
-  static size_t EscapeJsonString(const char* src, size_t src_len, char* dst,
-                                 size_t dst_size);
+  // 键名与分隔符片段表，构造时按 pretty 在紧凑 / 缩进两套编译期常量中选定
+  const detail::JsonFragmentTable* fragments_;
 };
 
 }  // namespace br_logger
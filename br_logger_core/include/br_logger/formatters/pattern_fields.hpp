@@ -0,0 +1,308 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "../log_entry.hpp"
+#include "../log_level.hpp"
+#include "../number_format.hpp"
+#include "../tag_dictionary.hpp"
+#include "../timestamp.hpp"
+
+namespace br_logger
+{
+
+// PatternFormatter 与 StaticPatternFormatter 共用的占位符定义与输出，保证两者逐字节一致
+enum class PatternField : uint8_t
+{
+  Literal,
+  Date,          // %D
+  Time,          // %T
+  Microseconds,  // %e
+  LevelFull,     // %L
+  LevelShort,    // %l
+  FileName,      // %f
+  FilePath,      // %F
+  FuncName,      // %n
+  PrettyFunc,    // %N
+  Line,          // %#
+  ThreadId,      // %t
+  ProcessId,     // %P
+  ThreadName,    // %k
+  SequenceId,    // %q
+  Tags,          // %g
+  Message,       // %m
+  ColorStart,    // %C
+  ColorReset     // %R
+};
+
+// 占位符字符对应的字段；不是占位符时返回 Literal
+constexpr PatternField pattern_field_for(char ch)
+{
+  switch (ch)
+  {
+    case 'D':
+      return PatternField::Date;
+    case 'T':
+      return PatternField::Time;
+    case 'e':
+      return PatternField::Microseconds;
+    case 'L':
+      return PatternField::LevelFull;
+    case 'l':
+      return PatternField::LevelShort;
+    case 'f':
+      return PatternField::FileName;
+    case 'F':
+      return PatternField::FilePath;
+    case 'n':
+      return PatternField::FuncName;
+    case 'N':
+      return PatternField::PrettyFunc;
+    case '#':
+      return PatternField::Line;
+    case 't':
+      return PatternField::ThreadId;
+    case 'P':
+      return PatternField::ProcessId;
+    case 'k':
+      return PatternField::ThreadName;
+    case 'q':
+      return PatternField::SequenceId;
+    case 'g':
+      return PatternField::Tags;
+    case 'm':
+      return PatternField::Message;
+    case 'C':
+      return PatternField::ColorStart;
+    case 'R':
+      return PatternField::ColorReset;
+    default:
+      return PatternField::Literal;
+  }
+}
+
+constexpr const char* level_color(LogLevel level)
+{
+  switch (level)
+  {
+    case LogLevel::TRACE:
+      return "\033[37m";
+    case LogLevel::DEBUG:
+      return "\033[36m";
+    case LogLevel::INFO:
+      return "\033[32m";
+    case LogLevel::WARN:
+      return "\033[33m";
+    case LogLevel::ERROR:
+      return "\033[31m";
+    case LogLevel::FATAL:
+      return "\033[1;31m";
+    case LogLevel::OFF:
+      return "";
+  }
+  return "";
+}
+
+enum class PatternAlign : uint8_t
+{
+  Right,  // %8L
+  Left,   // %-8L
+  Center  // %=8L
+};
+
+namespace detail
+{
+
+// 写入 buf，超出 buf_size - 1 的部分被丢弃，始终以 '\0' 结尾；buf_size 须大于 0
+struct PatternWriter
+{
+  char* buf;
+  size_t buf_size;
+  size_t pos = 0;
+
+  void Append(const char* data, size_t len)
+  {
+    size_t avail = buf_size - 1 - pos;
+    if (len == 0 || avail == 0)
+    {
+      return;
+    }
+    size_t to_copy = (len < avail) ? len : avail;
+    std::memcpy(buf + pos, data, to_copy);
+    pos += to_copy;
+    buf[pos] = '\0';
+  }
+
+  void AppendCStr(const char* data)
+  {
+    if (data)
+    {
+      Append(data, std::strlen(data));
+    }
+  }
+
+  void AppendUint(uint64_t value)
+  {
+    char temp[K_MAX_INT_CHARS];
+    Append(temp, format_uint(temp, value));
+  }
+
+  // 把 start 起写入的字段补齐到 width（按 align 在左、右或两侧补空格）；truncate 时截到 width
+  void Pad(size_t start, size_t width, PatternAlign align, bool truncate)
+  {
+    size_t len = pos - start;
+    if (len >= width)
+    {
+      if (truncate && len > width)
+      {
+        pos = start + width;
+        buf[pos] = '\0';
+      }
+      return;
+    }
+    size_t left = 0;
+    if (align == PatternAlign::Right)
+    {
+      left = width - len;
+    }
+    else if (align == PatternAlign::Center)
+    {
+      left = (width - len) / 2;
+    }
+    size_t end = start + width;
+    if (end > buf_size - 1)
+    {
+      end = buf_size - 1;
+    }
+    size_t room = end - start;
+    if (left > room)
+    {
+      left = room;
+    }
+    size_t keep = (len < room - left) ? len : room - left;
+    if (left > 0)
+    {
+      std::memmove(buf + start + left, buf + start, keep);
+      std::memset(buf + start, ' ', left);
+    }
+    std::memset(buf + start + left + keep, ' ', end - (start + left + keep));
+    pos = end;
+    buf[pos] = '\0';
+  }
+};
+
+template <PatternField F>
+inline void append_field(PatternWriter& out, const LogEntry& entry, bool enable_color)
+{
+  const LogSite* site = entry.site;
+  if constexpr (F == PatternField::Date || F == PatternField::Time ||
+                F == PatternField::Microseconds)
+  {
+    char temp[32];
+    size_t len = 0;
+    if constexpr (F == PatternField::Date)
+    {
+      len = format_date(entry.wall_clock_ns, temp, sizeof(temp));
+    }
+    else if constexpr (F == PatternField::Time)
+    {
+      len = format_clock_time(entry.wall_clock_ns, temp, sizeof(temp));
+    }
+    else
+    {
+      len = format_micros(entry.wall_clock_ns, temp, sizeof(temp));
+    }
+    out.Append(temp, len);
+  }
+  else if constexpr (F == PatternField::LevelFull)
+  {
+    std::string_view level = to_string(entry.level);
+    out.Append(level.data(), level.size());
+  }
+  else if constexpr (F == PatternField::LevelShort)
+  {
+    char ch = to_short_char(entry.level);
+    out.Append(&ch, 1);
+  }
+  else if constexpr (F == PatternField::FileName)
+  {
+    out.AppendCStr(site ? site->file_name : nullptr);
+  }
+  else if constexpr (F == PatternField::FilePath)
+  {
+    out.AppendCStr(site ? site->file_path : nullptr);
+  }
+  else if constexpr (F == PatternField::FuncName)
+  {
+    out.AppendCStr(site ? site->function_name : nullptr);
+  }
+  else if constexpr (F == PatternField::PrettyFunc)
+  {
+    out.AppendCStr(site ? site->pretty_function : nullptr);
+  }
+  else if constexpr (F == PatternField::Line)
+  {
+    out.AppendUint(site ? site->line : 0u);
+  }
+  else if constexpr (F == PatternField::ThreadId)
+  {
+    out.AppendUint(entry.thread_id);
+  }
+  else if constexpr (F == PatternField::ProcessId)
+  {
+    out.AppendUint(entry.process_id);
+  }
+  else if constexpr (F == PatternField::ThreadName)
+  {
+    out.AppendCStr(entry.thread_name);
+  }
+  else if constexpr (F == PatternField::SequenceId)
+  {
+    out.AppendUint(entry.sequence_id);
+  }
+  else if constexpr (F == PatternField::Tags)
+  {
+    if (entry.tag_count > 0)
+    {
+      const auto& dict = TagDictionary::Instance();
+      out.Append("[", 1);
+      for (uint8_t i = 0; i < entry.tag_count; ++i)
+      {
+        if (i > 0)
+        {
+          out.Append("|", 1);
+        }
+        std::string_view key = dict.Resolve(entry.tags[i].key);
+        std::string_view value = tag_value(entry, entry.tags[i]);
+        out.Append(key.data(), key.size());
+        out.Append("=", 1);
+        out.Append(value.data(), value.size());
+      }
+      out.Append("]", 1);
+    }
+  }
+  else if constexpr (F == PatternField::Message)
+  {
+    out.Append(entry.msg, entry.msg_len);
+  }
+  else if constexpr (F == PatternField::ColorStart)
+  {
+    if (enable_color)
+    {
+      out.AppendCStr(level_color(entry.level));
+    }
+  }
+  else if constexpr (F == PatternField::ColorReset)
+  {
+    if (enable_color)
+    {
+      out.Append("\033[0m", 4);
+    }
+  }
+}
+
+}  // namespace detail
+
+}  // namespace br_logger
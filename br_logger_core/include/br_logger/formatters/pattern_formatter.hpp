@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "formatter_interface.hpp"
+#include "pattern_fields.hpp"
 
 namespace br_logger
 {
@@ -22,32 +23,9 @@ class PatternFormatter : public IFormatter
   std::string pattern_;
   bool enable_color_;
 
-  enum class OpType : uint8_t
-  {
-    Literal,
-    Date,
-    Time,
-    Microseconds,
-    LevelFull,
-    LevelShort,
-    FileName,
-    FilePath,
-    FuncName,
-    PrettyFunc,
-    Line,
-    ThreadId,
-    ProcessId,
-    ThreadName,
-    SequenceId,
-    Tags,
-    Message,
-    ColorStart,
-    ColorReset
-  };
-
   struct FormatOp
   {
-    OpType type;
+    PatternField field;
     std::string literal;
   };
 
@@ -0,0 +1,234 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#include "formatter_interface.hpp"
+#include "pattern_fields.hpp"
+
+namespace br_logger
+{
+
+namespace detail
+{
+
+struct StaticPatternOp
+{
+  PatternField field;
+  uint16_t literal_begin;  // Literal：在 StaticPattern::literals 中的区间
+  uint16_t literal_len;
+  uint16_t width;  // 0 表示不补齐
+  PatternAlign align;
+  bool truncate;
+};
+
+// 编译期解析结果：相邻的字面量（含 %% 与未知占位符）合并为一个 Literal
+template <size_t N>
+struct StaticPattern
+{
+  std::array<StaticPatternOp, N> ops{};
+  std::array<char, N> literals{};
+  size_t count = 0;
+};
+
+// 语法与 PatternFormatter 相同，另外支持 %[-|=][width][!]X：
+// 默认右对齐，'-' 左对齐，'=' 居中，'!' 表示超过 width 时截断。
+// 说明符后跟的不是占位符时原样输出，与 PatternFormatter 对同一模式的输出一致
+template <size_t N>
+constexpr StaticPattern<N> parse_static_pattern(std::string_view pattern)
+{
+  StaticPattern<N> parsed{};
+  size_t used = 0;
+  bool open = false;
+  auto add_char = [&](char ch)
+  {
+    if (!open)
+    {
+      parsed.ops[parsed.count] = {PatternField::Literal, static_cast<uint16_t>(used), 0, 0,
+                                  PatternAlign::Right, false};
+      open = true;
+    }
+    parsed.literals[used++] = ch;
+    ++parsed.ops[parsed.count].literal_len;
+  };
+  auto add_field = [&](PatternField field, uint16_t width, PatternAlign align, bool truncate)
+  {
+    if (open)
+    {
+      ++parsed.count;
+      open = false;
+    }
+    parsed.ops[parsed.count++] = {field, 0, 0, width, align, truncate};
+  };
+
+  size_t i = 0;
+  while (i < pattern.size())
+  {
+    if (pattern[i] != '%')
+    {
+      add_char(pattern[i++]);
+      continue;
+    }
+    size_t j = i + 1;
+    PatternAlign align = PatternAlign::Right;
+    if (j < pattern.size() && (pattern[j] == '-' || pattern[j] == '='))
+    {
+      align = pattern[j] == '-' ? PatternAlign::Left : PatternAlign::Center;
+      ++j;
+    }
+    uint32_t width = 0;
+    while (j < pattern.size() && pattern[j] >= '0' && pattern[j] <= '9' && width < 10000)
+    {
+      width = width * 10 + static_cast<uint32_t>(pattern[j] - '0');
+      ++j;
+    }
+    bool has_spec = j != i + 1;
+    bool truncate = false;
+    if (has_spec && j < pattern.size() && pattern[j] == '!')
+    {
+      truncate = true;
+      ++j;
+    }
+    PatternField field = j < pattern.size() ? pattern_field_for(pattern[j]) : PatternField::Literal;
+
+    if (j >= pattern.size() || (has_spec && field == PatternField::Literal))
+    {
+      // 不完整的说明符按字面量输出，从其后的字符继续解析
+      while (i < j)
+      {
+        add_char(pattern[i++]);
+      }
+      continue;
+    }
+    if (field != PatternField::Literal)
+    {
+      add_field(field, static_cast<uint16_t>(width), align, truncate);
+    }
+    else
+    {
+      if (pattern[j] != '%')
+      {
+        add_char('%');
+      }
+      add_char(pattern[j]);
+    }
+    i = j + 1;
+  }
+  if (open)
+  {
+    ++parsed.count;
+  }
+  return parsed;
+}
+
+}  // namespace detail
+
+// 模式在编译期解析的 PatternFormatter：每个操作按解析结果展开为一段直线代码，
+// 不再在每条日志上遍历操作表；宽度、对齐与截断也在编译期确定。
+// Source 须提供 static constexpr std::string_view value()，通常通过
+// StaticPatternFormatter<"..."> (C++20) 或 BR_LOG_STATIC_PATTERN_FORMATTER (C++17) 得到。
+// 不含宽度说明符的模式与同一模式的 PatternFormatter 输出逐字节一致
+template <typename Source>
+class BasicStaticPatternFormatter : public IFormatter
+{
+ public:
+  explicit BasicStaticPatternFormatter(bool enable_color = true) : enable_color_(enable_color) {}
+
+  size_t Format(const LogEntry& entry, char* buf, size_t buf_size) override
+  {
+    if (buf_size == 0)
+    {
+      return 0;
+    }
+    buf[0] = '\0';
+    detail::PatternWriter out{buf, buf_size};
+    EmitAll(out, entry, std::make_index_sequence<K_PARSED.count>{});
+    return out.pos;
+  }
+
+  static constexpr std::string_view Pattern() { return K_PATTERN; }
+  // 解析后的操作数（相邻字面量已合并）
+  static constexpr size_t OpCount() { return K_PARSED.count; }
+
+ private:
+  static constexpr std::string_view K_PATTERN = Source::value();
+  static_assert(K_PATTERN.size() <= UINT16_MAX, "pattern too long");
+  static constexpr detail::StaticPattern<K_PATTERN.size()> K_PARSED =
+      detail::parse_static_pattern<K_PATTERN.size()>(K_PATTERN);
+
+  template <size_t... I>
+  void EmitAll(detail::PatternWriter& out, const LogEntry& entry, std::index_sequence<I...>)
+  {
+    (Emit<I>(out, entry), ...);
+  }
+
+  template <size_t I>
+  void Emit(detail::PatternWriter& out, const LogEntry& entry)
+  {
+    constexpr detail::StaticPatternOp op = K_PARSED.ops[I];
+    if constexpr (op.field == PatternField::Literal)
+    {
+      out.Append(K_PARSED.literals.data() + op.literal_begin, op.literal_len);
+    }
+    else if constexpr (op.width == 0 && !op.truncate)
+    {
+      detail::append_field<op.field>(out, entry, enable_color_);
+    }
+    else
+    {
+      size_t start = out.pos;
+      detail::append_field<op.field>(out, entry, enable_color_);
+      out.Pad(start, op.width, op.align, op.truncate);
+    }
+  }
+
+  bool enable_color_;
+};
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+
+// 可作为模板实参的字符串字面量
+template <size_t N>
+struct FixedPattern
+{
+  char data[N]{};
+
+  constexpr FixedPattern(const char (&str)[N])
+  {
+    for (size_t i = 0; i < N; ++i)
+    {
+      data[i] = str[i];
+    }
+  }
+
+  constexpr std::string_view View() const { return {data, N - 1}; }
+};
+
+namespace detail
+{
+template <FixedPattern P>
+struct FixedPatternSource
+{
+  static constexpr std::string_view value() { return P.View(); }
+};
+}  // namespace detail
+
+// 用法：std::make_unique<StaticPatternFormatter<"[%D %T%e] [%-5L] %m">>(false)
+template <FixedPattern P>
+using StaticPatternFormatter = BasicStaticPatternFormatter<detail::FixedPatternSource<P>>;
+
+#endif
+
+}  // namespace br_logger
+
+// C++17 下定义名为 name 的格式化器类型：
+//   BR_LOG_STATIC_PATTERN_FORMATTER(MyFormatter, "[%-5L] %m");
+//   sink->SetFormatter(std::make_unique<MyFormatter>(false));
+#define BR_LOG_STATIC_PATTERN_FORMATTER(name, pattern)                     \
+  struct name##Source                                                      \
+  {                                                                        \
+    static constexpr std::string_view value() { return pattern; }          \
+  };                                                                       \
+  using name = ::br_logger::BasicStaticPatternFormatter<name##Source>
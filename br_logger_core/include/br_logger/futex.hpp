@@ -0,0 +1,15 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace br_logger
+{
+
+// 在 word 上等待：word 仍等于 expected 时睡眠，直到被唤醒或超时（timeout_ns 为 0 表示不超时）。
+// 可能虚假返回，调用方需重新检查条件。非 Linux 平台退化为短暂休眠
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, uint64_t timeout_ns);
+
+// 唤醒所有在 word 上等待的线程
+void futex_wake_all(std::atomic<uint32_t>& word);
+
+}  // namespace br_logger
@@ -0,0 +1,173 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace br_logger
+{
+
+namespace detail
+{
+
+// JSON 字符串转义：'"'、'\\' 与控制字符（< 0x20）需要转义，其余字节（含 UTF-8 多字节）原样输出
+
+// 每字节的转义字符：0 表示原样输出，'u' 表示 \u00XX，其余为反斜杠后的字符
+struct JsonEscapeTable
+{
+  char value[256];
+};
+
+constexpr JsonEscapeTable make_json_escape_table()
+{
+  JsonEscapeTable table{};
+  for (int c = 0; c < 0x20; ++c)
+  {
+    table.value[c] = 'u';
+  }
+  table.value[static_cast<unsigned char>('"')] = '"';
+  table.value[static_cast<unsigned char>('\\')] = '\\';
+  table.value[static_cast<unsigned char>('\n')] = 'n';
+  table.value[static_cast<unsigned char>('\r')] = 'r';
+  table.value[static_cast<unsigned char>('\t')] = 't';
+  return table;
+}
+
+inline constexpr JsonEscapeTable K_JSON_ESCAPES = make_json_escape_table();
+
+// 向量化路径每次检查的字节数；0 表示只有逐字节路径
+#if defined(__AVX2__)
+constexpr size_t K_JSON_ESCAPE_BLOCK = 32;
+#elif defined(__SSE2__) || defined(__ARM_NEON)
+constexpr size_t K_JSON_ESCAPE_BLOCK = 16;
+#else
+constexpr size_t K_JSON_ESCAPE_BLOCK = 0;
+#endif
+
+// 写入需要转义的字节 c；剩余空间放不下整个转义序列时不写并返回 false
+inline bool append_json_escape(unsigned char c, char* dst, size_t& pos, size_t dst_size)
+{
+  char escape = K_JSON_ESCAPES.value[c];
+  if (escape != 'u')
+  {
+    if (pos + 2 > dst_size)
+    {
+      return false;
+    }
+    dst[pos] = '\\';
+    dst[pos + 1] = escape;
+    pos += 2;
+    return true;
+  }
+  if (pos + 6 > dst_size)
+  {
+    return false;
+  }
+  static constexpr char K_HEX[] = "0123456789ABCDEF";
+  std::memcpy(dst + pos, "\\u00", 4);
+  dst[pos + 4] = K_HEX[c >> 4];
+  dst[pos + 5] = K_HEX[c & 0x0F];
+  pos += 6;
+  return true;
+}
+
+// 逐字节转义 src[i, src_len)，最多写 dst_size 字节且不截断转义序列，返回写入后的位置
+inline size_t escape_json_tail(const char* src, size_t i, size_t src_len, char* dst, size_t pos,
+                               size_t dst_size)
+{
+  for (; i < src_len; ++i)
+  {
+    auto c = static_cast<unsigned char>(src[i]);
+    if (K_JSON_ESCAPES.value[c] == 0)
+    {
+      if (pos >= dst_size)
+      {
+        break;
+      }
+      dst[pos++] = static_cast<char>(c);
+    }
+    else if (!append_json_escape(c, dst, pos, dst_size))
+    {
+      break;
+    }
+  }
+  return pos;
+}
+
+inline size_t escape_json_scalar(const char* src, size_t src_len, char* dst, size_t dst_size)
+{
+  return escape_json_tail(src, 0, src_len, dst, 0, dst_size);
+}
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(__ARM_NEON)
+// 把 src 起的一整块原样复制到 dst，返回其中开头连续无需转义的字节数（整块都安全时为块长）
+inline size_t copy_json_safe_prefix(const char* src, char* dst)
+{
+#if defined(__AVX2__)
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), v);
+  // max(v, 0x1F) == 0x1F 即 v <= 0x1F（无符号）
+  __m256i ctrl = _mm256_cmpeq_epi8(_mm256_max_epu8(v, _mm256_set1_epi8(0x1F)),
+                                   _mm256_set1_epi8(0x1F));
+  __m256i quote = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'));
+  __m256i backslash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+  auto mask = static_cast<uint32_t>(
+      _mm256_movemask_epi8(_mm256_or_si256(ctrl, _mm256_or_si256(quote, backslash))));
+  return mask == 0 ? K_JSON_ESCAPE_BLOCK : static_cast<size_t>(__builtin_ctz(mask));
+#elif defined(__SSE2__)
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+  __m128i ctrl = _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F));
+  __m128i quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+  __m128i backslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+  auto mask = static_cast<uint32_t>(
+      _mm_movemask_epi8(_mm_or_si128(ctrl, _mm_or_si128(quote, backslash))));
+  return mask == 0 ? K_JSON_ESCAPE_BLOCK : static_cast<size_t>(__builtin_ctz(mask));
+#else
+  uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(src));
+  vst1q_u8(reinterpret_cast<uint8_t*>(dst), v);
+  uint8x16_t hit = vorrq_u8(vcleq_u8(v, vdupq_n_u8(0x1F)),
+                            vorrq_u8(vceqq_u8(v, vdupq_n_u8('"')), vceqq_u8(v, vdupq_n_u8('\\'))));
+  // 每字节压成 4 位，得到 64 位掩码
+  uint64_t mask =
+      vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+  return mask == 0 ? K_JSON_ESCAPE_BLOCK : static_cast<size_t>(__builtin_ctzll(mask) >> 2);
+#endif
+}
+#endif
+
+// 与 escape_json_scalar 输出相同：无需转义的连续字节按块整体复制，只逐个处理需要转义的字节
+inline size_t escape_json(const char* src, size_t src_len, char* dst, size_t dst_size)
+{
+  size_t i = 0;
+  size_t pos = 0;
+#if defined(__AVX2__) || defined(__SSE2__) || defined(__ARM_NEON)
+  // 整块写入需要 dst 剩余至少一块；块中转义字符之后的字节会被后续写入覆盖
+  while (i + K_JSON_ESCAPE_BLOCK <= src_len && pos + K_JSON_ESCAPE_BLOCK <= dst_size)
+  {
+    size_t safe = copy_json_safe_prefix(src + i, dst + pos);
+    i += safe;
+    pos += safe;
+    if (safe < K_JSON_ESCAPE_BLOCK)
+    {
+      if (!append_json_escape(static_cast<unsigned char>(src[i]), dst, pos, dst_size))
+      {
+        return pos;
+      }
+      ++i;
+    }
+  }
+#endif
+  return escape_json_tail(src, i, src_len, dst, pos, dst_size);
+}
+
+}  // namespace detail
+
+}  // namespace br_logger
@@ -1,13 +1,27 @@
 #pragma once
+#include <atomic>
 #include <cstdint>
-#include <shared_mutex>
+#include <memory>
+#include <mutex>
+#include <string>
 
 #include "fixed_vector.hpp"
 #include "log_entry.hpp"
+#include "log_record.hpp"
+#include "tag_dictionary.hpp"
 
 namespace br_logger
 {
 
+// 全局 tag 的不可变快照。修改时整体复制出新快照再发布，旧快照在最后一个
+// 持有者释放后回收（RCU 风格），读者无需加锁
+struct GlobalTagSnapshot
+{
+  FixedVector<LogTag, 16> tags;
+  std::string inline_values[16];  // 与 tags 一一对应，value 未驻留时保存原文
+  size_t inline_bytes = 0;
+};
+
 // NOLINTBEGIN(readability-identifier-naming)
 class LogContext
 {
@@ -26,34 +40,63 @@ class LogContext
   static const char* GetThreadName();
   static uint32_t GetThreadId();
 
+  // tag 字符串在这里驻留为 ID，之后每条日志只复制 ID；未驻留的值随每条日志内联复制
   static void PushScopedTag(const char* key, const char* value);
   static void PopScopedTag(const char* key);
+  static void PushScopedTag(TagId key, TagId value);
+  static void PopScopedTag(TagId key);
 
   void FillTags(LogEntry& entry) const;
   void FillThreadInfo(LogEntry& entry) const;
 
+  // 直接写入队列中预留的记录：TagCount / TagTextSize 给出预留上限，
+  // FillTags 返回实际写入的 tag 数，并把未驻留的值写入 text（text_len 为写入字节数）。
+  // 每条记录的内联值合计最多 BR_LOG_TAG_INLINE_LEN 字节，超出的值以 "..." 结尾
+  size_t TagCount() const;
+  size_t TagTextSize() const;
+  size_t FillTags(LogTag* dst, size_t max_tags, char* text, size_t text_cap,
+                  size_t& text_len) const;
+  void FillThreadInfo(LogRecord& record) const;
+
+  // 因超出 BR_LOG_TAG_INLINE_LEN 而被截断的内联 tag 值个数
+  uint64_t TruncatedTagValues() const;
+
   class ScopedTag
   {
    public:
     ScopedTag(const char* key, const char* value);
+    ScopedTag(TagId key, TagId value);  // 已驻留的 ID，热路径上可避免查表
     ~ScopedTag();
     ScopedTag(const ScopedTag&) = delete;
     ScopedTag& operator=(const ScopedTag&) = delete;
 
    private:
-    const char* key_;
+    TagId key_ = 0;
+    bool active_ = false;
   };
 
  private:
-  LogContext() = default;
+  LogContext();
+
+  // 返回当前线程缓存的全局 tag 快照；代数变化时才重新获取，平时只有一次 relaxed 读
+  const GlobalTagSnapshot& GlobalTags() const;
+  void Publish(std::shared_ptr<const GlobalTagSnapshot> snapshot);
+
+  static void PushScopedTagValue(TagId key, const char* value);
 
-  mutable std::shared_mutex global_mutex_;
-  FixedVector<LogTag, 16> global_tags_;
+  mutable std::mutex global_mutex_;  // 只串行化写者与快照刷新
+  std::shared_ptr<const GlobalTagSnapshot> global_snapshot_;
+  std::atomic<uint64_t> global_generation_{0};
+  mutable std::atomic<uint64_t> truncated_tag_values_{0};
 
   char process_name_[64] = {};
   char app_version_[32] = {};
 
   static thread_local FixedVector<LogTag, BR_LOG_MAX_TAGS> tls_tags_;
+  static thread_local std::string tls_inline_values_[BR_LOG_MAX_TAGS];
+  static thread_local size_t tls_inline_bytes_;
+  static thread_local std::shared_ptr<const GlobalTagSnapshot> tls_global_snapshot_;
+  static thread_local uint64_t tls_global_generation_;
   static thread_local char tls_thread_name_[32];
   static thread_local uint32_t tls_thread_id_;
   static thread_local bool tls_thread_id_cached_;
@@ -1,19 +1,39 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <string_view>
 #include <type_traits>
 
+#include "deferred_format.hpp"
 #include "log_level.hpp"
+#include "log_site.hpp"
 #include "platform.hpp"
+#include "tag_dictionary.hpp"
 
 namespace br_logger
 {
 
+// key / value 为 TagDictionary 中的 ID，格式化时再解析为字符串。
+// value 最高位置位时表示值未驻留，低位给出它在条目 tag_text 中的偏移与长度
 struct LogTag
 {
-  char key[BR_LOG_MAX_TAG_KEY_LEN];
-  char value[BR_LOG_MAX_TAG_VAL_LEN];
+  TagId key;
+  TagId value;
 };
 
+constexpr TagId K_INLINE_TAG_VALUE = 0x80000000u;
+
+static_assert(BR_LOG_TAG_INLINE_LEN <= 0x7FFF, "inline tag offsets are encoded in 15 bits");
+
+inline bool is_inline_tag_value(TagId value) { return (value & K_INLINE_TAG_VALUE) != 0; }
+
+inline TagId make_inline_tag_value(size_t offset, size_t len)
+{
+  return K_INLINE_TAG_VALUE | static_cast<TagId>(offset << 16) | static_cast<TagId>(len);
+}
+
+// 后端复用同一个 LogEntry 解码记录且不清零：tags 只有前 tag_count 项、
+// msg 只有前 msg_len 字节（及其后的 '\0'）有效
 struct LogEntry
 {
   uint64_t timestamp_ns;
@@ -21,12 +41,8 @@ struct LogEntry
 
   LogLevel level;
 
-  const char* file_path;
-  const char* file_name;
-  const char* function_name;
-  const char* pretty_function;
-  uint32_t line;
-  uint32_t column;
+  // 调用点描述符（文件、函数、行号、格式串），静态存储，可能为空
+  const LogSite* site;
 
   uint32_t thread_id;
   uint32_t process_id;
@@ -34,9 +50,16 @@ struct LogEntry
 
   uint8_t tag_count;
   LogTag tags[BR_LOG_MAX_TAGS];
+  // 未驻留的 tag 值，只有前 tag_text_len 字节有效
+  uint16_t tag_text_len;
+  char tag_text[BR_LOG_TAG_INLINE_LEN];
 
   uint64_t sequence_id;
 
+  // 延迟格式化：format_fn 非空时 msg 中存放编码后的参数（长度为 msg_len），
+  // 后端线程调用 format_fn(site->fmt, ...) 生成正文后再分发给 Sink
+  DeferredFormatFn format_fn;
+
   uint16_t msg_len;
   char msg[BR_LOG_MAX_MSG_LEN];
 };
@@ -44,4 +67,20 @@ struct LogEntry
 static_assert(std::is_trivially_copyable_v<LogEntry>,
               "LogEntry must be trivially copyable for lock-free ring buffer");
 
+// 解析 tag 的值：驻留的值查字典，未驻留的值取自条目自带的 tag_text
+inline std::string_view tag_value(const LogEntry& entry, const LogTag& tag)
+{
+  if (!is_inline_tag_value(tag.value))
+  {
+    return TagDictionary::Instance().Resolve(tag.value);
+  }
+  size_t offset = (tag.value >> 16) & 0x7FFF;
+  size_t len = tag.value & 0xFFFF;
+  if (offset + len > entry.tag_text_len)
+  {
+    return {};
+  }
+  return std::string_view(entry.tag_text + offset, len);
+}
+
 }  // namespace br_logger
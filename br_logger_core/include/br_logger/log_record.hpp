@@ -0,0 +1,130 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "clock_source.hpp"
+#include "deferred_format.hpp"
+#include "log_entry.hpp"
+#include "log_level.hpp"
+#include "log_site.hpp"
+#include "platform.hpp"
+
+namespace br_logger
+{
+
+// 队列中的变长记录头，其后紧跟 LogTag[tag_count]、tag_text_len 字节的未驻留 tag 值
+// 与 msg_len 字节的消息（延迟格式化时为编码后的参数），只占用实际用到的字节
+struct LogRecord
+{
+  // clock 为 ClockSource 时 timestamp 是该时钟的原始读数，由后端换算；
+  // 为 K_CLOCK_NANOS 时 timestamp / wall_clock_ns 已是纳秒
+  uint64_t timestamp;
+  uint64_t wall_clock_ns;
+  uint64_t sequence_id;
+  const LogSite* site;
+  DeferredFormatFn format_fn;
+  uint32_t thread_id;
+  uint32_t process_id;
+  char thread_name[32];
+  uint16_t msg_len;
+  uint16_t tag_text_len;
+  uint8_t tag_count;
+  LogLevel level;
+  uint8_t clock;
+};
+
+constexpr size_t K_MAX_RECORD_SIZE = sizeof(LogRecord) + BR_LOG_MAX_TAGS * sizeof(LogTag) +
+                                     BR_LOG_TAG_INLINE_LEN + BR_LOG_MAX_MSG_LEN;
+
+inline size_t record_size(size_t tag_count, size_t tag_text_len, size_t msg_len)
+{
+  return sizeof(LogRecord) + tag_count * sizeof(LogTag) + tag_text_len + msg_len;
+}
+
+inline size_t record_size(size_t tag_count, size_t msg_len)
+{
+  return record_size(tag_count, 0, msg_len);
+}
+
+inline size_t record_size(const LogEntry& entry)
+{
+  return record_size(
+      entry.tag_count < BR_LOG_MAX_TAGS ? entry.tag_count : BR_LOG_MAX_TAGS,
+      entry.tag_text_len < BR_LOG_TAG_INLINE_LEN ? entry.tag_text_len : BR_LOG_TAG_INLINE_LEN,
+      entry.msg_len < BR_LOG_MAX_MSG_LEN ? entry.msg_len : BR_LOG_MAX_MSG_LEN);
+}
+
+// 将 entry 中实际使用的部分序列化到 dst，返回记录字节数
+inline size_t encode_record(const LogEntry& entry, uint8_t* dst)
+{
+  LogRecord rec;
+  rec.timestamp = entry.timestamp_ns;
+  rec.wall_clock_ns = entry.wall_clock_ns;
+  rec.clock = K_CLOCK_NANOS;
+  rec.sequence_id = entry.sequence_id;
+  rec.site = entry.site;
+  rec.format_fn = entry.format_fn;
+  rec.thread_id = entry.thread_id;
+  rec.process_id = entry.process_id;
+  std::memcpy(rec.thread_name, entry.thread_name, sizeof(rec.thread_name));
+  rec.msg_len = entry.msg_len < BR_LOG_MAX_MSG_LEN ? entry.msg_len : BR_LOG_MAX_MSG_LEN;
+  rec.tag_count = entry.tag_count < BR_LOG_MAX_TAGS ? entry.tag_count : BR_LOG_MAX_TAGS;
+  rec.tag_text_len = entry.tag_text_len < BR_LOG_TAG_INLINE_LEN ? entry.tag_text_len
+                                                                : BR_LOG_TAG_INLINE_LEN;
+  rec.level = entry.level;
+
+  std::memcpy(dst, &rec, sizeof(rec));
+  size_t pos = sizeof(rec);
+  std::memcpy(dst + pos, entry.tags, rec.tag_count * sizeof(LogTag));
+  pos += rec.tag_count * sizeof(LogTag);
+  std::memcpy(dst + pos, entry.tag_text, rec.tag_text_len);
+  pos += rec.tag_text_len;
+  std::memcpy(dst + pos, entry.msg, rec.msg_len);
+  return pos + rec.msg_len;
+}
+
+// 从记录还原 LogEntry：原始时钟读数在这里换算为纳秒，延迟格式化的记录在这里生成正文
+inline void decode_record(const uint8_t* src, LogEntry& entry, ClockConverter& clock)
+{
+  LogRecord rec;
+  std::memcpy(&rec, src, sizeof(rec));
+  if (rec.clock == K_CLOCK_NANOS)
+  {
+    entry.timestamp_ns = rec.timestamp;
+    entry.wall_clock_ns = rec.wall_clock_ns;
+  }
+  else
+  {
+    clock.Convert(rec.clock, rec.timestamp, entry.timestamp_ns, entry.wall_clock_ns);
+  }
+  entry.sequence_id = rec.sequence_id;
+  entry.site = rec.site;
+  entry.thread_id = rec.thread_id;
+  entry.process_id = rec.process_id;
+  std::memcpy(entry.thread_name, rec.thread_name, sizeof(entry.thread_name));
+  entry.level = rec.level;
+  entry.tag_count = rec.tag_count;
+
+  const uint8_t* pos = src + sizeof(rec);
+  std::memcpy(entry.tags, pos, rec.tag_count * sizeof(LogTag));
+  pos += rec.tag_count * sizeof(LogTag);
+  entry.tag_text_len = rec.tag_text_len;
+  std::memcpy(entry.tag_text, pos, rec.tag_text_len);
+  pos += rec.tag_text_len;
+
+  entry.format_fn = nullptr;
+  if (rec.format_fn)
+  {
+    const char* fmt = rec.site ? rec.site->fmt : "";
+    entry.msg_len = static_cast<uint16_t>(rec.format_fn(
+        fmt, reinterpret_cast<const char*>(pos), rec.msg_len, entry.msg, BR_LOG_MAX_MSG_LEN));
+    return;
+  }
+  size_t len = rec.msg_len < BR_LOG_MAX_MSG_LEN ? rec.msg_len : BR_LOG_MAX_MSG_LEN - 1;
+  std::memcpy(entry.msg, pos, len);
+  entry.msg[len] = '\0';
+  entry.msg_len = static_cast<uint16_t>(len);
+}
+
+}  // namespace br_logger
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+
+#include "log_level.hpp"
+#include "source_location.hpp"
+
+namespace br_logger
+{
+
+// 每个 LOG_* 调用点对应一个 static constexpr 描述符，编译期构造完成，
+// LogEntry 只携带指向它的指针
+struct LogSite
+{
+  const char* file_path;
+  const char* file_name;
+  const char* function_name;
+  const char* pretty_function;
+  uint32_t line;
+  uint32_t column;
+  LogLevel level;
+  const char* fmt;
+  uint32_t id;  // 由文件路径与行号计算，跨构建稳定
+
+  static constexpr uint32_t MakeId(const char* path, uint32_t line)
+  {
+    uint32_t hash = 2166136261u;  // FNV-1a
+    for (const char* p = path; *p != '\0'; ++p)
+    {
+      hash ^= static_cast<uint8_t>(*p);
+      hash *= 16777619u;
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+      hash ^= (line >> (i * 8)) & 0xFFu;
+      hash *= 16777619u;
+    }
+    return hash;
+  }
+};
+
+#if BR_LOG_HAS_SOURCE_LOCATION
+#define BR_LOG_MAKE_SITE(lvl, fmt_str)                                                 \
+  ::br_logger::LogSite                                                                 \
+  {                                                                                    \
+    std::source_location::current().file_name(),                                       \
+        ::br_logger::SourceLocation::ExtractFilename(                                  \
+            std::source_location::current().file_name()),                              \
+        std::source_location::current().function_name(),                               \
+        std::source_location::current().function_name(),                               \
+        std::source_location::current().line(),                                        \
+        std::source_location::current().column(), lvl, fmt_str,                        \
+        ::br_logger::LogSite::MakeId(std::source_location::current().file_name(),      \
+                                     std::source_location::current().line())           \
+  }
+#else
+#define BR_LOG_MAKE_SITE(lvl, fmt_str)                                                \
+  ::br_logger::LogSite{__FILE__,                                                      \
+                       ::br_logger::SourceLocation::ExtractFilename(__FILE__),        \
+                       __func__,                                                      \
+                       __PRETTY_FUNCTION__,                                           \
+                       static_cast<uint32_t>(__LINE__),                               \
+                       0u,                                                            \
+                       lvl,                                                           \
+                       fmt_str,                                                       \
+                       ::br_logger::LogSite::MakeId(__FILE__,                         \
+                                                    static_cast<uint32_t>(__LINE__))}
+#endif
+
+}  // namespace br_logger
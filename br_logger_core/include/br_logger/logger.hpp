@@ -3,13 +3,18 @@
 #include <cstdio>
 #include <cstring>
 #include <memory>
+#include <new>
+#include <type_traits>
 
 #include "backend.hpp"
+#include "clock_source.hpp"
+#include "deferred_format.hpp"
 #include "log_context.hpp"
 #include "log_entry.hpp"
 #include "log_level.hpp"
+#include "log_record.hpp"
+#include "log_site.hpp"
 #include "sinks/sink_interface.hpp"
-#include "source_location.hpp"
 #include "timestamp.hpp"
 
 #ifdef BR_LOG_USE_FMTLIB
@@ -24,24 +29,65 @@ class Logger
  public:
   static Logger& Instance();
 
-  void AddSink(std::unique_ptr<ILogSink> sink);
+  // shard 为 BackendOptions::worker_count > 1 时写该 Sink 的后端线程分片，默认按添加顺序轮流分配
+  void AddSink(std::unique_ptr<ILogSink> sink,
+               uint32_t shard = LoggerBackend::K_AUTO_SHARD);
   void SetLevel(LogLevel level);
   LogLevel Level() const;
 
+  // 队列拓扑，须在开始写日志之前设置；默认值由 BR_LOG_PER_THREAD_QUEUES 决定
+  void SetQueueTopology(QueueTopology topology);
+  QueueTopology GetQueueTopology() const;
+
+  // 时钟源，默认 PRECISE；不支持的时钟源退回 PRECISE
+  void SetClockSource(ClockSource source);
+  ClockSource GetClockSource() const;
+
+  // 后端线程空闲时的等待方式：BLOCKING（默认）睡眠直到有新记录，BUSY_SPIN 一直轮询，
+  // HYBRID 按 BackendOptions 中的阈值轮询、yield 后定时休眠
+  void SetIdleStrategy(IdleStrategy strategy);
+  IdleStrategy GetIdleStrategy() const;
+
+  // Start() 使用默认线程参数；Start(options) 设置后端线程的空闲策略、CPU 亲和性、
+  // 调度类与线程名，返回实际生效的项。已启动时不做修改，返回上次启动的结果
   void Start();
+  AppliedBackendOptions Start(const BackendOptions& options);
   void Stop();
 
   size_t Drain(size_t max_entries = 64);
 
+  // 队列满时的背压策略，按级别选择丢弃或等待；默认所有级别 DROP_NEWEST
+  void SetBackpressurePolicy(const BackpressurePolicy& policy);
+  BackpressurePolicy GetBackpressurePolicy() const;
+  BackpressureStats GetBackpressureStats() const;
+
+  // 业务线程未能写入队列的条数；DROP_OLDEST 在后端丢弃的旧记录见 GetBackpressureStats
   uint64_t DropCount() const;
   void ResetDropCount();
 
-  // Core log method — template, defined in header
+  // 按通道统计的丢弃条数：WARN 及以上属于 PRIORITY 通道
+  uint64_t LaneDropCount(QueueLane lane) const;
+
+  // 普通队列写满时溢出到预分配的段链，capacity_bytes 为 0 时关闭；须在 Start 前调用
+  void SetOverflowCapacity(size_t capacity_bytes);
+  OverflowStats GetOverflowStats() const;
+
+  // Core log method — template, defined in header. 格式串在运行期交给 snprintf。
+  // 记录只保存 &site，后端稍后才读取（延迟格式化时还要读 site.fmt），因此 site 与其
+  // 格式串须具有静态存储期，例如 static constexpr LogSite site = BR_LOG_MAKE_SITE(...)
   template <typename... Args>
-  void LogImpl(LogLevel level, const SourceLocation& loc, const char* fmt,
-               Args&&... args);
+  void LogImpl(const LogSite& site, Args&&... args);
+
+  // LOG_* 宏使用：Format 为 detail::RuntimePrintf 时同 LogImpl；否则为提供
+  // static constexpr const char* value() 的类型，格式串在编译期解析并检查参数类型（不用 fmtlib 时）。
+  // site 的生命周期要求同 LogImpl
+  template <typename Format, typename... Args>
+  void LogWithFormat(const LogSite& site, Args&&... args);
 
  private:
+  template <typename Format, typename... Args>
+  static uint16_t FormatMessage(char* buf, const char* fmt, Args&&... args);
+
   Logger();
   ~Logger();
 
@@ -55,79 +101,155 @@ class Logger
 // ===== log_impl template implementation =====
 
 template <typename... Args>
-void Logger::LogImpl(LogLevel level, const SourceLocation& loc, const char* fmt,
-                     Args&&... args)
+void Logger::LogImpl(const LogSite& site, Args&&... args)
 {
-  LogEntry entry{};
-
-  // 1. Timestamps
-  entry.timestamp_ns = monotonic_now_ns();
-  entry.wall_clock_ns = wall_clock_now_ns();
+  LogWithFormat<detail::RuntimePrintf>(site, std::forward<Args>(args)...);
+}
 
-  // 2. Level
-  entry.level = level;
+template <typename Format, typename... Args>
+void Logger::LogWithFormat(const LogSite& site, Args&&... args)
+{
+#ifdef BR_LOG_USE_FMTLIB
+  constexpr bool K_COMPILED = false;
+#else
+  // 无参数的消息按字面量原样输出，不解析格式串
+  constexpr bool K_COMPILED =
+      !std::is_same_v<Format, detail::RuntimePrintf> && sizeof...(Args) > 0;
+#endif
+  // 1. Timestamp: one raw clock read, converted to ns on the backend
+  uint64_t ticks = 0;
+  ClockSource clock = backend_.ReadClock(ticks);
 
-  // 3. Source location
-  entry.file_path = loc.file_path;
-  entry.file_name = loc.file_name;
-  entry.function_name = loc.function_name;
-  entry.pretty_function = loc.pretty_function;
-  entry.line = loc.line;
-  entry.column = loc.column;
+  // 2. Sequence
+  uint64_t sequence_id = sequence_.fetch_add(1, std::memory_order_relaxed);
 
-  // 4. Sequence
-  entry.sequence_id = sequence_.fetch_add(1, std::memory_order_relaxed);
+  // 3. Message: its size must be known before reserving. Literal messages and
+  //    deferred args are written straight into the record; only eagerly
+  //    formatted messages go through the (uninitialised) stack buffer
+  char staged[BR_LOG_MAX_MSG_LEN];
+  const char* msg = staged;
+  size_t msg_len = 0;
+  DeferredFormatFn format_fn = nullptr;
+  using Source = std::conditional_t<K_COMPILED, Format, detail::RuntimePrintf>;
+#if BR_LOG_DEFERRED_FORMAT
+  using Codec = typename detail::DeferredCodecFor<Source, Args...>::Type;
+  if constexpr (Codec::K_DEFERRABLE)
+  {
+    format_fn = Codec::template FormatFn<Source>();
+    msg = nullptr;
+    msg_len = Codec::EncodedSize(args...);
+  }
+  else
+#endif
+#ifndef BR_LOG_USE_FMTLIB
+      if constexpr (sizeof...(Args) == 0)
+  {
+    msg = site.fmt;
+    msg_len = std::strlen(site.fmt);
+    if (msg_len >= BR_LOG_MAX_MSG_LEN) msg_len = BR_LOG_MAX_MSG_LEN - 1;
+  }
+  else
+#endif
+  {
+    msg_len = FormatMessage<Source>(staged, site.fmt, std::forward<Args>(args)...);
+  }
 
-  // 5. Context (thread info + tags)
+  // 4. Reserve the record in the queue and fill only the fields readers use
   auto& ctx = LogContext::Instance();
-  ctx.FillThreadInfo(entry);
-  ctx.FillTags(entry);
+  size_t max_tags = ctx.TagCount();
+  size_t max_text = ctx.TagTextSize();
+  auto reservation = backend_.Reserve(
+      static_cast<uint32_t>(record_size(max_tags, max_text, msg_len)), site.level);
+  if (!reservation)
+  {
+    drop_count_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  auto* record = new (reservation.data) LogRecord;
+  record->timestamp = ticks;
+  record->clock = static_cast<uint8_t>(clock);
+  record->sequence_id = sequence_id;
+  record->site = &site;
+  record->format_fn = format_fn;
+  record->level = site.level;
+  ctx.FillThreadInfo(*record);
 
-  // 6. Format message
+  // 5. Context tags and their inline values, then message bytes right after them
+  auto* tags = reinterpret_cast<LogTag*>(reservation.data + sizeof(LogRecord));
+  auto* tag_text = reinterpret_cast<char*>(tags + max_tags);
+  size_t tag_text_len = 0;
+  size_t tag_count = ctx.FillTags(tags, max_tags, tag_text, max_text, tag_text_len);
+  if (tag_count < max_tags)
+  {
+    std::memmove(tags + tag_count, tag_text, tag_text_len);
+  }
+  record->tag_count = static_cast<uint8_t>(tag_count);
+  record->tag_text_len = static_cast<uint16_t>(tag_text_len);
+  auto* body = reinterpret_cast<char*>(tags + tag_count) + tag_text_len;
+  if (msg != nullptr)
+  {
+    std::memcpy(body, msg, msg_len);
+  }
+#if BR_LOG_DEFERRED_FORMAT
+  else if constexpr (Codec::K_DEFERRABLE)
+  {
+    msg_len = Codec::Encode(body, msg_len, args...);
+  }
+#endif
+  record->msg_len = static_cast<uint16_t>(msg_len);
+
+  // 6. Publish
+  backend_.Commit(reservation,
+                  static_cast<uint32_t>(record_size(tag_count, tag_text_len, msg_len)));
+}
+
+template <typename Format, typename... Args>
+uint16_t Logger::FormatMessage(char* buf, const char* fmt, Args&&... args)
+{
 #ifdef BR_LOG_USE_FMTLIB
-  auto result = fmt::format_to_n(entry.msg, BR_LOG_MAX_MSG_LEN - 1, fmt::runtime(fmt),
+  auto result = fmt::format_to_n(buf, BR_LOG_MAX_MSG_LEN - 1, fmt::runtime(fmt),
                                  std::forward<Args>(args)...);
-  entry.msg_len = static_cast<uint16_t>(result.size);
-  entry.msg[entry.msg_len] = '\0';
+  return static_cast<uint16_t>(
+      result.size < BR_LOG_MAX_MSG_LEN - 1 ? result.size : BR_LOG_MAX_MSG_LEN - 1);
 #else
-  if constexpr (sizeof...(args) == 0)
+  // 无参数的字面量消息由 LogImpl 直接拷贝进记录，不会走到这里
+  if constexpr (!std::is_same_v<Format, detail::RuntimePrintf>)
   {
-    std::size_t len = std::strlen(fmt);
-    if (len >= BR_LOG_MAX_MSG_LEN) len = BR_LOG_MAX_MSG_LEN - 1;
-    std::memcpy(entry.msg, fmt, len);
-    entry.msg[len] = '\0';
-    entry.msg_len = static_cast<uint16_t>(len);
+    (void)fmt;
+    return static_cast<uint16_t>(detail::format_printf<Format>(buf, BR_LOG_MAX_MSG_LEN, args...));
   }
   else
   {
-    int written = std::snprintf(entry.msg, BR_LOG_MAX_MSG_LEN, fmt, args...);
-    entry.msg_len = (written > 0) ? static_cast<uint16_t>(written) : 0;
+    int written = std::snprintf(buf, BR_LOG_MAX_MSG_LEN, fmt, args...);
+    if (written >= BR_LOG_MAX_MSG_LEN) written = BR_LOG_MAX_MSG_LEN - 1;
+    return (written > 0) ? static_cast<uint16_t>(written) : 0;
   }
 #endif
-
-  // 7. Enqueue
-  if (!backend_.TryPush(entry))
-  {
-    drop_count_.fetch_add(1, std::memory_order_relaxed);
-  }
 }
 
 }  // namespace br_logger
 
 // ===== Logging macros =====
 
-#define BR_LOG_CALL(lvl, fmt_str, ...)                                                   \
-  do                                                                                     \
-  {                                                                                      \
-    constexpr auto _hpc_lvl = ::br_logger::LogLevel::lvl;                                \
-    if (static_cast<int>(_hpc_lvl) >= BR_LOG_ACTIVE_LEVEL)                               \
-    {                                                                                    \
-      auto& _br_logger = ::br_logger::Logger::Instance();                                \
-      if (_hpc_lvl >= _br_logger.Level())                                                \
-      {                                                                                  \
-        _br_logger.LogImpl(_hpc_lvl, BR_LOG_CURRENT_LOCATION(), fmt_str, ##__VA_ARGS__); \
-      }                                                                                  \
-    }                                                                                    \
+#define BR_LOG_CALL(lvl, fmt_str, ...)                                              \
+  do                                                                                \
+  {                                                                                 \
+    constexpr auto _hpc_lvl = ::br_logger::LogLevel::lvl;                           \
+    if (static_cast<int>(_hpc_lvl) >= BR_LOG_ACTIVE_LEVEL)                          \
+    {                                                                               \
+      static constexpr ::br_logger::LogSite _br_site =                              \
+          BR_LOG_MAKE_SITE(_hpc_lvl, fmt_str);                                      \
+      struct _br_format                                                             \
+      {                                                                             \
+        static constexpr const char* value() { return _br_site.fmt; }               \
+      };                                                                            \
+      auto& _br_logger = ::br_logger::Logger::Instance();                           \
+      if (_hpc_lvl >= _br_logger.Level())                                           \
+      {                                                                             \
+        _br_logger.LogWithFormat<_br_format>(_br_site, ##__VA_ARGS__);              \
+      }                                                                             \
+    }                                                                               \
   } while (0)
 
 #define LOG_TRACE(fmt, ...) BR_LOG_CALL(TRACE, fmt, ##__VA_ARGS__)
@@ -0,0 +1,136 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace br_logger
+{
+
+namespace detail
+{
+
+// 格式化器与时间戳共用的数字渲染，替代对简单整数调用 snprintf（每次都要解析格式串）
+
+// 整数最长 20 位（UINT64_MAX），有符号再加一位负号
+constexpr size_t K_MAX_INT_CHARS = 21;
+// 浮点最短往返表示的上限（如 -2.2250738585072014e-308）
+constexpr size_t K_MAX_DOUBLE_CHARS = 32;
+
+// "00" "01" ... "99"：每次除以 100 写两位
+inline constexpr char K_DIGIT_PAIRS[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+inline unsigned digit_count(uint64_t value)
+{
+  unsigned n = 1;
+  for (;;)
+  {
+    if (value < 10)
+    {
+      return n;
+    }
+    if (value < 100)
+    {
+      return n + 1;
+    }
+    if (value < 1000)
+    {
+      return n + 2;
+    }
+    if (value < 10000)
+    {
+      return n + 3;
+    }
+    value /= 10000;
+    n += 4;
+  }
+}
+
+// 从 end 向前写出 value 的全部数字
+inline void write_digits_backward(char* end, uint64_t value)
+{
+  while (value >= 100)
+  {
+    auto pair = static_cast<unsigned>(value % 100);
+    value /= 100;
+    end -= 2;
+    std::memcpy(end, K_DIGIT_PAIRS + pair * 2, 2);
+  }
+  if (value >= 10)
+  {
+    std::memcpy(end - 2, K_DIGIT_PAIRS + value * 2, 2);
+  }
+  else
+  {
+    end[-1] = static_cast<char>('0' + value);
+  }
+}
+
+// 十进制写入 dst（至少 K_MAX_INT_CHARS 字节），不补 '\0'，返回长度；与 "%u" / PRIu64 输出相同
+inline size_t format_uint(char* dst, uint64_t value)
+{
+  unsigned n = digit_count(value);
+  write_digits_backward(dst + n, value);
+  return n;
+}
+
+inline size_t format_int(char* dst, int64_t value)
+{
+  if (value >= 0)
+  {
+    return format_uint(dst, static_cast<uint64_t>(value));
+  }
+  dst[0] = '-';
+  return 1 + format_uint(dst + 1, 0 - static_cast<uint64_t>(value));
+}
+
+// 写入恰好 width 位、左侧补零的 value（超出 width 的高位被丢弃），如 width = 6 时同 "%06u"
+inline void format_fixed(char* dst, uint32_t value, unsigned width)
+{
+  char* end = dst + width;
+  while (end - dst >= 2)
+  {
+    end -= 2;
+    std::memcpy(end, K_DIGIT_PAIRS + (value % 100) * 2, 2);
+    value /= 100;
+  }
+  if (end != dst)
+  {
+    *dst = static_cast<char>('0' + value % 10);
+  }
+}
+
+// 浮点的最短往返表示（std::to_chars），dst 至少 K_MAX_DOUBLE_CHARS 字节，不补 '\0'，返回长度。
+// 标准库不支持浮点 to_chars 时退回 "%.17g"
+inline size_t format_double(char* dst, double value)
+{
+#if defined(__cpp_lib_to_chars)
+  auto result = std::to_chars(dst, dst + K_MAX_DOUBLE_CHARS, value);
+  return static_cast<size_t>(result.ptr - dst);
+#else
+  char temp[K_MAX_DOUBLE_CHARS + 1];
+  int n = std::snprintf(temp, sizeof(temp), "%.17g", value);
+  size_t len = n > 0 ? static_cast<size_t>(n) : 0;
+  if (len > K_MAX_DOUBLE_CHARS)
+  {
+    len = K_MAX_DOUBLE_CHARS;
+  }
+  std::memcpy(dst, temp, len);
+  return len;
+#endif
+}
+
+}  // namespace detail
+
+}  // namespace br_logger
@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "platform.hpp"
+#include "ring_buffer.hpp"
+
+namespace br_logger
+{
+
+struct OverflowStats
+{
+  size_t capacity_bytes = 0;       // 预分配的溢出段总容量
+  size_t segment_bytes = 0;        // 单个溢出段的容量
+  size_t segments_in_use = 0;      // 当前链上的段数
+  size_t high_water_segments = 0;  // 链上段数的历史最大值
+  uint64_t spilled_records = 0;    // 写入溢出段的记录数
+};
+
+// 主队列写满时的弹性溢出链：段在配置容量时一次性从堆上预分配，
+// 运行中只在空闲池与链之间移动，不再分配内存。
+// 生产者写链尾的段，写满后从池中取新段接到链尾并封存旧段；
+// 消费者按顺序读链头，链头封存且取空后归还给池
+class OverflowChain
+{
+ public:
+  using Segment = MPSCByteRingBuffer<BR_LOG_OVERFLOW_SEGMENT_BYTES>;
+
+  OverflowChain() = default;
+  OverflowChain(const OverflowChain&) = delete;
+  OverflowChain& operator=(const OverflowChain&) = delete;
+
+  // 预分配 capacity_bytes / 段容量 个段（0 表示关闭）。须在没有生产者与消费者时调用
+  void Configure(size_t capacity_bytes);
+  bool Enabled() const { return !nodes_.empty(); }
+
+  // 生产者：在链尾预留 size 字节，所有段都已用完时返回空预留
+  ByteReservation TryReserve(uint32_t size);
+
+  // 消费者：按写入顺序读取记录，取完后调用 Release
+  const uint8_t* Peek(uint32_t& size);
+  void Release() { head_->ring.Release(); }
+
+  OverflowStats Stats() const;
+
+ private:
+  struct Node
+  {
+    Segment ring;
+    std::atomic<Node*> next{nullptr};
+    std::atomic<bool> sealed{false};
+    std::atomic<uint32_t> writers{0};  // 正在该段上预留的生产者数
+  };
+
+  // 链头已封存、无生产者在预留且全部记录都已取走
+  static bool Retired(Node& node);
+
+  std::vector<std::unique_ptr<Node>> nodes_;
+  std::mutex mutex_;           // 保护 free_ 与换段
+  std::vector<Node*> free_;
+  std::atomic<Node*> tail_{nullptr};
+  Node* head_ = nullptr;       // 仅消费者使用
+  std::atomic<size_t> in_use_{0};
+  std::atomic<size_t> high_water_{0};
+  std::atomic<uint64_t> spilled_{0};
+};
+
+}  // namespace br_logger
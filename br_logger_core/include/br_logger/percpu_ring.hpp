@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "platform.hpp"
+#include "ring_buffer.hpp"
+
+namespace br_logger
+{
+
+// 每个 CPU 一个字节环。生产者在 rseq 临界区内比较并推进当前 CPU 环的写位置，
+// 被抢占、迁移或收到信号时由内核中止临界区并重试，整个预留过程没有原子读-改-写。
+// 预留完成后的写入与提交与普通字节环相同，期间即使线程被迁移也不影响正确性。
+// 仅在 BR_LOG_HAS_RSEQ 且 glibc 已为线程注册 rseq 时可用，见 Available()
+class PerCpuRing
+{
+ public:
+  using Ring = MPSCByteRingBuffer<BR_LOG_CPU_RING_BYTES>;
+
+  PerCpuRing();
+
+  // 当前进程能否使用 rseq（内核支持且 glibc 已注册）
+  static bool Available();
+
+  // 在当前 CPU 的环上预留 size 字节；环已满或 CPU 编号超出范围时返回空预留
+  ByteReservation TryReserve(uint32_t size);
+
+  size_t CpuCount() const { return rings_.size(); }
+  Ring& operator[](size_t cpu) { return *rings_[cpu]; }
+
+ private:
+  std::vector<std::unique_ptr<Ring>> rings_;
+};
+
+}  // namespace br_logger
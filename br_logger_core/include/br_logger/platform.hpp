@@ -31,6 +31,117 @@
 #endif
 #endif
 
+// ===== 变长记录队列的字节容量（默认按每条约 128 字节估算） =====
+#ifndef BR_LOG_RING_BYTES
+#define BR_LOG_RING_BYTES (BR_LOG_RING_SIZE * 128)
+#endif
+
+// ===== 队列拓扑默认值：都为 0 时使用共享 MPSC 队列（运行时可切换） =====
+#ifndef BR_LOG_PER_THREAD_QUEUES
+#define BR_LOG_PER_THREAD_QUEUES 0
+#endif
+#ifndef BR_LOG_PER_CPU_QUEUES
+#define BR_LOG_PER_CPU_QUEUES 0
+#endif
+
+// ===== 每线程 SPSC 队列的字节容量 =====
+#ifndef BR_LOG_THREAD_RING_BYTES
+#if BR_LOG_EMBEDDED
+#define BR_LOG_THREAD_RING_BYTES (16 * 1024)
+#else
+#define BR_LOG_THREAD_RING_BYTES (128 * 1024)
+#endif
+#endif
+
+// ===== 每 CPU 队列（rseq）的字节容量 =====
+#ifndef BR_LOG_CPU_RING_BYTES
+#define BR_LOG_CPU_RING_BYTES (128 * 1024)
+#endif
+
+// ===== WARN 及以上级别专用的高优先级队列字节容量 =====
+#ifndef BR_LOG_PRIORITY_RING_BYTES
+#if BR_LOG_EMBEDDED
+#define BR_LOG_PRIORITY_RING_BYTES (8 * 1024)
+#else
+#define BR_LOG_PRIORITY_RING_BYTES (64 * 1024)
+#endif
+#endif
+
+// ===== 后端每批分发给 Sink 的最大条数（ILogSink::WriteBatch）=====
+#ifndef BR_LOG_DISPATCH_BATCH
+#if BR_LOG_EMBEDDED
+#define BR_LOG_DISPATCH_BATCH 4
+#else
+#define BR_LOG_DISPATCH_BATCH 32
+#endif
+#endif
+
+// ===== 多后端线程时分片共享的批槽数，慢分片落后这么多批后后端线程等待 =====
+#ifndef BR_LOG_SHARD_BATCHES
+#if BR_LOG_EMBEDDED
+#define BR_LOG_SHARD_BATCHES 2
+#else
+#define BR_LOG_SHARD_BATCHES 8
+#endif
+#endif
+
+// ===== 文件 Sink 的写缓冲：容量、按字节与按时间的写出阈值 =====
+#ifndef BR_LOG_FILE_BUFFER_BYTES
+#if BR_LOG_EMBEDDED
+#define BR_LOG_FILE_BUFFER_BYTES (8 * 1024)
+#else
+#define BR_LOG_FILE_BUFFER_BYTES (64 * 1024)
+#endif
+#endif
+#ifndef BR_LOG_FILE_FLUSH_BYTES
+#define BR_LOG_FILE_FLUSH_BYTES (BR_LOG_FILE_BUFFER_BYTES / 2)
+#endif
+#ifndef BR_LOG_FILE_FLUSH_AGE_MS
+#define BR_LOG_FILE_FLUSH_AGE_MS 100
+#endif
+
+// ===== AsyncSinkAdapter 每个被包装 Sink 的独立队列字节容量 =====
+#ifndef BR_LOG_ASYNC_SINK_QUEUE_BYTES
+#if BR_LOG_EMBEDDED
+#define BR_LOG_ASYNC_SINK_QUEUE_BYTES (16 * 1024)
+#else
+#define BR_LOG_ASYNC_SINK_QUEUE_BYTES (256 * 1024)
+#endif
+#endif
+
+// ===== ParallelFormatAdapter 同时在途（格式化中或等待输出）的批数 =====
+#ifndef BR_LOG_FORMAT_JOBS
+#if BR_LOG_EMBEDDED
+#define BR_LOG_FORMAT_JOBS 2
+#else
+#define BR_LOG_FORMAT_JOBS 8
+#endif
+#endif
+
+// ===== 主队列写满后的弹性溢出段：总容量（0 表示关闭）与单段容量 =====
+#ifndef BR_LOG_OVERFLOW_BYTES
+#define BR_LOG_OVERFLOW_BYTES 0
+#endif
+#ifndef BR_LOG_OVERFLOW_SEGMENT_BYTES
+#if BR_LOG_EMBEDDED
+#define BR_LOG_OVERFLOW_SEGMENT_BYTES (8 * 1024)
+#else
+#define BR_LOG_OVERFLOW_SEGMENT_BYTES (64 * 1024)
+#endif
+#endif
+
+// ===== rseq（restartable sequences）：Linux x86_64，需要 glibc 2.35+ 注册 rseq =====
+#ifndef BR_LOG_HAS_RSEQ
+#if defined(BR_LOG_PLATFORM_LINUX) && defined(__x86_64__) && defined(__has_include)
+#if __has_include(<sys/rseq.h>)
+#define BR_LOG_HAS_RSEQ 1
+#endif
+#endif
+#endif
+#ifndef BR_LOG_HAS_RSEQ
+#define BR_LOG_HAS_RSEQ 0
+#endif
+
 // ===== 日志消息最大长度 =====
 #ifndef BR_LOG_MAX_MSG_LEN
 #if BR_LOG_EMBEDDED
@@ -44,11 +155,21 @@
 #ifndef BR_LOG_MAX_TAGS
 #define BR_LOG_MAX_TAGS 8
 #endif
-#ifndef BR_LOG_MAX_TAG_KEY_LEN
-#define BR_LOG_MAX_TAG_KEY_LEN 32
+// tag 驻留表最多保存的不同字符串数（key 与 value 共用）
+#ifndef BR_LOG_TAG_DICT_CAPACITY
+#if BR_LOG_EMBEDDED
+#define BR_LOG_TAG_DICT_CAPACITY 1024
+#else
+#define BR_LOG_TAG_DICT_CAPACITY 65536
+#endif
+#endif
+// 每条日志中未驻留的 tag 值（只出现一次的值，或驻留表已满后的新值）可占用的字节数
+#ifndef BR_LOG_TAG_INLINE_LEN
+#if BR_LOG_EMBEDDED
+#define BR_LOG_TAG_INLINE_LEN 64
+#else
+#define BR_LOG_TAG_INLINE_LEN 512
 #endif
-#ifndef BR_LOG_MAX_TAG_VAL_LEN
-#define BR_LOG_MAX_TAG_VAL_LEN 64
 #endif
 
 // ===== 编译信息注入（CMake 设置） =====
@@ -0,0 +1,953 @@
+#pragma once
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "number_format.hpp"
+
+namespace br_logger
+{
+
+namespace detail
+{
+
+// 编译期解析的 printf：LOG_* 宏把格式串包装成类型 Source（提供 static constexpr const char* value()），
+// 格式串在编译期拆成字面量与转换说明，参数类型与转换不匹配时编译失败；
+// 运行期按说明直接调用对应类型的写入函数，不再逐字符解析格式串。输出与 snprintf 相同。
+// 支持 C99 的标志 / 宽度 / 精度（含 *）/ 长度修饰符与 d i o u x X c s p f F e E g G a A，
+// 不支持 %n、%lc / %ls 与位置参数 %1$d
+
+// 运行期格式串（Logger::LogImpl 直接调用时）：仍使用 snprintf
+struct RuntimePrintf
+{
+};
+
+enum class PrintfLength : uint8_t
+{
+  None,
+  HH,
+  H,
+  L,
+  LL,
+  J,
+  Z,
+  T,
+  LongDouble  // L
+};
+
+constexpr uint8_t K_PRINTF_LEFT = 1;   // '-'
+constexpr uint8_t K_PRINTF_PLUS = 2;   // '+'
+constexpr uint8_t K_PRINTF_SPACE = 4;  // ' '
+constexpr uint8_t K_PRINTF_ALT = 8;    // '#'
+constexpr uint8_t K_PRINTF_ZERO = 16;  // '0'
+
+enum class PrintfError : uint8_t
+{
+  None,
+  Incomplete,         // 格式串以不完整的转换说明结尾
+  UnknownConversion,  // 未知的转换字符
+  Unsupported,        // %n、%lc / %ls、位置参数
+  BadLength,          // 长度修饰符不适用于该转换
+  TooFewArgs,
+  TooManyArgs,
+  IntegerExpected,
+  IntegerSizeMismatch,  // 整数大小与长度修饰符不符，例如 %d 传 int64_t
+  CharExpected,
+  FloatExpected,
+  LongDoubleMismatch,  // long double 须配 L，L 须配 long double
+  StringExpected,
+  PointerExpected,
+  StarExpectsInt  // '*' 宽度 / 精度须为 int
+};
+
+// 一段字面量加其后的一个转换说明；conv 为 '\0' 时只有字面量（格式串末尾）
+struct PrintfSpec
+{
+  uint16_t literal_begin;
+  uint16_t literal_len;
+  char conv;
+  uint8_t flags;
+  PrintfLength length;
+  int32_t width;       // -1 表示未指定
+  int32_t precision;   // -1 表示未指定
+  int16_t width_arg;   // '*' 宽度对应的参数下标，-1 表示无
+  int16_t precision_arg;
+  int16_t arg;
+};
+
+template <size_t N>
+struct PrintfFormat
+{
+  std::array<PrintfSpec, N + 1> specs{};
+  std::array<char, N + 1> literals{};  // %% 已还原为 %
+  size_t count = 0;
+  size_t arg_count = 0;
+  PrintfError error = PrintfError::None;
+};
+
+constexpr size_t printf_strlen(const char* str)
+{
+  size_t n = 0;
+  while (str[n] != '\0')
+  {
+    ++n;
+  }
+  return n;
+}
+
+constexpr bool printf_is_integer_conv(char c)
+{
+  return c == 'd' || c == 'i' || c == 'o' || c == 'u' || c == 'x' || c == 'X';
+}
+
+constexpr bool printf_is_float_conv(char c)
+{
+  return c == 'f' || c == 'F' || c == 'e' || c == 'E' || c == 'g' || c == 'G' || c == 'a' ||
+         c == 'A';
+}
+
+template <size_t N>
+constexpr PrintfFormat<N> parse_printf(const char* fmt)
+{
+  PrintfFormat<N> out{};
+  size_t used = 0;
+  size_t literal_begin = 0;
+  int16_t arg = 0;
+  size_t i = 0;
+  auto fail = [&](PrintfError error)
+  {
+    out.error = error;
+    return out;
+  };
+  while (i < N)
+  {
+    if (fmt[i] != '%')
+    {
+      out.literals[used++] = fmt[i++];
+      continue;
+    }
+    if (i + 1 < N && fmt[i + 1] == '%')
+    {
+      out.literals[used++] = '%';
+      i += 2;
+      continue;
+    }
+    PrintfSpec spec{static_cast<uint16_t>(literal_begin),
+                    static_cast<uint16_t>(used - literal_begin),
+                    '\0',
+                    0,
+                    PrintfLength::None,
+                    -1,
+                    -1,
+                    -1,
+                    -1,
+                    -1};
+    size_t j = i + 1;
+    for (; j < N; ++j)
+    {
+      char c = fmt[j];
+      uint8_t flag = c == '-'   ? K_PRINTF_LEFT
+                     : c == '+' ? K_PRINTF_PLUS
+                     : c == ' ' ? K_PRINTF_SPACE
+                     : c == '#' ? K_PRINTF_ALT
+                     : c == '0' ? K_PRINTF_ZERO
+                                : 0;
+      if (flag == 0)
+      {
+        break;
+      }
+      spec.flags |= flag;
+    }
+    if (j < N && fmt[j] == '*')
+    {
+      spec.width_arg = arg++;
+      ++j;
+    }
+    else if (j < N && fmt[j] >= '1' && fmt[j] <= '9')
+    {
+      spec.width = 0;
+      while (j < N && fmt[j] >= '0' && fmt[j] <= '9')
+      {
+        spec.width = spec.width * 10 + (fmt[j++] - '0');
+      }
+      if (j < N && fmt[j] == '$')
+      {
+        return fail(PrintfError::Unsupported);
+      }
+    }
+    if (j < N && fmt[j] == '.')
+    {
+      ++j;
+      spec.precision = 0;
+      if (j < N && fmt[j] == '*')
+      {
+        spec.precision_arg = arg++;
+        ++j;
+      }
+      else
+      {
+        while (j < N && fmt[j] >= '0' && fmt[j] <= '9')
+        {
+          spec.precision = spec.precision * 10 + (fmt[j++] - '0');
+        }
+      }
+    }
+    if (j < N)
+    {
+      switch (fmt[j])
+      {
+        case 'h':
+          spec.length = (j + 1 < N && fmt[j + 1] == 'h') ? PrintfLength::HH : PrintfLength::H;
+          j += spec.length == PrintfLength::HH ? 2 : 1;
+          break;
+        case 'l':
+          spec.length = (j + 1 < N && fmt[j + 1] == 'l') ? PrintfLength::LL : PrintfLength::L;
+          j += spec.length == PrintfLength::LL ? 2 : 1;
+          break;
+        case 'j':
+          spec.length = PrintfLength::J;
+          ++j;
+          break;
+        case 'z':
+          spec.length = PrintfLength::Z;
+          ++j;
+          break;
+        case 't':
+          spec.length = PrintfLength::T;
+          ++j;
+          break;
+        case 'L':
+          spec.length = PrintfLength::LongDouble;
+          ++j;
+          break;
+        default:
+          break;
+      }
+    }
+    if (j >= N)
+    {
+      return fail(PrintfError::Incomplete);
+    }
+    char conv = fmt[j];
+    if (conv == 'n' || ((conv == 'c' || conv == 's') && spec.length == PrintfLength::L))
+    {
+      return fail(PrintfError::Unsupported);
+    }
+    if (!printf_is_integer_conv(conv) && !printf_is_float_conv(conv) && conv != 'c' &&
+        conv != 's' && conv != 'p')
+    {
+      return fail(PrintfError::UnknownConversion);
+    }
+    bool length_ok = printf_is_integer_conv(conv)
+                         ? spec.length != PrintfLength::LongDouble
+                     : printf_is_float_conv(conv)
+                         ? (spec.length == PrintfLength::None || spec.length == PrintfLength::L ||
+                            spec.length == PrintfLength::LongDouble)
+                         : spec.length == PrintfLength::None;
+    if (!length_ok)
+    {
+      return fail(PrintfError::BadLength);
+    }
+    spec.conv = conv;
+    spec.arg = arg++;
+    out.specs[out.count++] = spec;
+    literal_begin = used;
+    i = j + 1;
+  }
+  out.specs[out.count++] = PrintfSpec{static_cast<uint16_t>(literal_begin),
+                                      static_cast<uint16_t>(used - literal_begin),
+                                      '\0',
+                                      0,
+                                      PrintfLength::None,
+                                      -1,
+                                      -1,
+                                      -1,
+                                      -1,
+                                      -1};
+  out.arg_count = static_cast<size_t>(arg);
+  return out;
+}
+
+// 参数按 printf 的默认提升归类：小于 int 的整数提升为 int，float 提升为 double
+enum class PrintfArgKind : uint8_t
+{
+  Integer,
+  Floating,
+  LongDouble,
+  CString,
+  Pointer,
+  NullPointer,
+  Other
+};
+
+struct PrintfArg
+{
+  PrintfArgKind kind;
+  uint8_t size;
+};
+
+template <typename T>
+constexpr PrintfArg printf_arg()
+{
+  using D = std::decay_t<T>;
+  if constexpr (std::is_integral_v<D> || std::is_enum_v<D>)
+  {
+    return {PrintfArgKind::Integer,
+            static_cast<uint8_t>(sizeof(D) < sizeof(int) ? sizeof(int) : sizeof(D))};
+  }
+  else if constexpr (std::is_same_v<D, long double>)
+  {
+    return {PrintfArgKind::LongDouble, sizeof(long double)};
+  }
+  else if constexpr (std::is_floating_point_v<D>)
+  {
+    return {PrintfArgKind::Floating, sizeof(double)};
+  }
+  else if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>)
+  {
+    return {PrintfArgKind::CString, sizeof(D)};
+  }
+  else if constexpr (std::is_pointer_v<D> && !std::is_function_v<std::remove_pointer_t<D>>)
+  {
+    return {PrintfArgKind::Pointer, sizeof(D)};
+  }
+  else if constexpr (std::is_same_v<D, std::nullptr_t>)
+  {
+    return {PrintfArgKind::NullPointer, sizeof(void*)};
+  }
+  else
+  {
+    return {PrintfArgKind::Other, 0};
+  }
+}
+
+constexpr size_t printf_length_size(PrintfLength length)
+{
+  switch (length)
+  {
+    case PrintfLength::L:
+      return sizeof(long);
+    case PrintfLength::LL:
+      return sizeof(long long);
+    case PrintfLength::J:
+      return sizeof(intmax_t);
+    case PrintfLength::Z:
+      return sizeof(size_t);
+    case PrintfLength::T:
+      return sizeof(ptrdiff_t);
+    default:
+      return sizeof(int);
+  }
+}
+
+template <size_t N, size_t A>
+constexpr PrintfError check_printf(const PrintfFormat<N>& format,
+                                   const std::array<PrintfArg, A>& args)
+{
+  if (format.error != PrintfError::None)
+  {
+    return format.error;
+  }
+  if (format.arg_count > A)
+  {
+    return PrintfError::TooFewArgs;
+  }
+  if (format.arg_count < A)
+  {
+    return PrintfError::TooManyArgs;
+  }
+  for (size_t i = 0; i < format.count; ++i)
+  {
+    const PrintfSpec& spec = format.specs[i];
+    if (spec.conv == '\0')
+    {
+      continue;
+    }
+    for (int16_t star : {spec.width_arg, spec.precision_arg})
+    {
+      if (star >= 0 && (args[static_cast<size_t>(star)].kind != PrintfArgKind::Integer ||
+                        args[static_cast<size_t>(star)].size != sizeof(int)))
+      {
+        return PrintfError::StarExpectsInt;
+      }
+    }
+    const PrintfArg& arg = args[static_cast<size_t>(spec.arg)];
+    if (printf_is_integer_conv(spec.conv))
+    {
+      if (arg.kind != PrintfArgKind::Integer)
+      {
+        return PrintfError::IntegerExpected;
+      }
+      if (arg.size != printf_length_size(spec.length))
+      {
+        return PrintfError::IntegerSizeMismatch;
+      }
+    }
+    else if (printf_is_float_conv(spec.conv))
+    {
+      bool long_double = spec.length == PrintfLength::LongDouble;
+      if (arg.kind == PrintfArgKind::LongDouble || long_double)
+      {
+        if (arg.kind != PrintfArgKind::LongDouble || !long_double)
+        {
+          return arg.kind == PrintfArgKind::LongDouble || arg.kind == PrintfArgKind::Floating
+                     ? PrintfError::LongDoubleMismatch
+                     : PrintfError::FloatExpected;
+        }
+      }
+      else if (arg.kind != PrintfArgKind::Floating)
+      {
+        return PrintfError::FloatExpected;
+      }
+    }
+    else if (spec.conv == 'c')
+    {
+      if (arg.kind != PrintfArgKind::Integer || arg.size != sizeof(int))
+      {
+        return PrintfError::CharExpected;
+      }
+    }
+    else if (spec.conv == 's')
+    {
+      if (arg.kind != PrintfArgKind::CString && arg.kind != PrintfArgKind::NullPointer)
+      {
+        return PrintfError::StringExpected;
+      }
+    }
+    else if (arg.kind != PrintfArgKind::Pointer && arg.kind != PrintfArgKind::CString &&
+             arg.kind != PrintfArgKind::NullPointer)
+    {
+      return PrintfError::PointerExpected;
+    }
+  }
+  return PrintfError::None;
+}
+
+template <typename Source>
+struct PrintfParsed
+{
+  static constexpr size_t K_LENGTH = printf_strlen(Source::value());
+  static_assert(K_LENGTH <= UINT16_MAX, "BR_LOG printf: format string too long");
+  static constexpr PrintfFormat<K_LENGTH> K_FORMAT = parse_printf<K_LENGTH>(Source::value());
+};
+
+// 不触发 static_assert 的检查结果，供测试与 static_assert 使用
+template <typename Source, typename... Args>
+constexpr PrintfError printf_error()
+{
+  return check_printf(PrintfParsed<Source>::K_FORMAT,
+                      std::array<PrintfArg, sizeof...(Args)>{printf_arg<Args>()...});
+}
+
+template <typename Source, typename... Args>
+struct PrintfChecked : PrintfParsed<Source>
+{
+  static constexpr PrintfError K_ERROR = printf_error<Source, Args...>();
+  static_assert(K_ERROR != PrintfError::Incomplete,
+                "BR_LOG printf: format string ends inside a conversion specification");
+  static_assert(K_ERROR != PrintfError::UnknownConversion,
+                "BR_LOG printf: unknown conversion specifier");
+  static_assert(K_ERROR != PrintfError::Unsupported,
+                "BR_LOG printf: %n, %lc, %ls and positional arguments are not supported");
+  static_assert(K_ERROR != PrintfError::BadLength,
+                "BR_LOG printf: length modifier does not apply to this conversion");
+  static_assert(K_ERROR != PrintfError::TooFewArgs,
+                "BR_LOG printf: format string expects more arguments");
+  static_assert(K_ERROR != PrintfError::TooManyArgs,
+                "BR_LOG printf: more arguments than conversions in the format string");
+  static_assert(K_ERROR != PrintfError::IntegerExpected,
+                "BR_LOG printf: %d/%i/%o/%u/%x/%X expects an integer argument");
+  static_assert(K_ERROR != PrintfError::IntegerSizeMismatch,
+                "BR_LOG printf: integer size does not match the length modifier "
+                "(use %ld/%lld/%zu or the PRId64 family)");
+  static_assert(K_ERROR != PrintfError::CharExpected,
+                "BR_LOG printf: %c expects a char or int argument");
+  static_assert(K_ERROR != PrintfError::FloatExpected,
+                "BR_LOG printf: %f/%e/%g/%a expects a floating-point argument");
+  static_assert(K_ERROR != PrintfError::LongDoubleMismatch,
+                "BR_LOG printf: long double needs the L modifier and L needs long double");
+  static_assert(K_ERROR != PrintfError::StringExpected,
+                "BR_LOG printf: %s expects a const char* argument");
+  static_assert(K_ERROR != PrintfError::PointerExpected,
+                "BR_LOG printf: %p expects a pointer argument");
+  static_assert(K_ERROR != PrintfError::StarExpectsInt,
+                "BR_LOG printf: '*' width or precision expects an int argument");
+};
+
+// 写入 buf，超出 buf_size - 1 的部分被丢弃，始终以 '\0' 结尾；buf_size 须大于 0
+struct PrintfWriter
+{
+  char* buf;
+  size_t buf_size;
+  size_t pos = 0;
+
+  void Append(const char* data, size_t len)
+  {
+    size_t avail = buf_size - 1 - pos;
+    size_t n = len < avail ? len : avail;
+    if (n == 0)
+    {
+      return;  // 空字段的 data 可能为空指针
+    }
+    std::memcpy(buf + pos, data, n);
+    pos += n;
+  }
+
+  void Fill(char ch, size_t count)
+  {
+    size_t avail = buf_size - 1 - pos;
+    size_t n = count < avail ? count : avail;
+    if (n == 0)
+    {
+      return;
+    }
+    std::memset(buf + pos, ch, n);
+    pos += n;
+  }
+
+  // 按 width 补齐 prefix + zeros 个 '0' + body；pad_zero 时在 prefix 与 body 之间补 '0'
+  void Field(const char* prefix, size_t prefix_len, size_t zeros, const char* body,
+             size_t body_len, uint8_t flags, int width, bool pad_zero)
+  {
+    size_t len = prefix_len + zeros + body_len;
+    size_t pad = width > 0 && static_cast<size_t>(width) > len ? static_cast<size_t>(width) - len : 0;
+    if ((flags & K_PRINTF_LEFT) == 0 && !pad_zero)
+    {
+      Fill(' ', pad);
+    }
+    Append(prefix, prefix_len);
+    if ((flags & K_PRINTF_LEFT) == 0 && pad_zero)
+    {
+      zeros += pad;
+    }
+    Fill('0', zeros);
+    Append(body, body_len);
+    if ((flags & K_PRINTF_LEFT) != 0)
+    {
+      Fill(' ', pad);
+    }
+  }
+
+  // 少见组合（如 %#g、%05s）交给 snprintf 处理单个转换
+  // fmt 为 printf_single_spec 生成的 "%<flags>*.*<conv>"；width 为 -1 表示未指定，
+  // flags 中运行期由负的 '*' 宽度带来的左对齐通过负宽度传入
+  template <typename T>
+  void Snprintf(const char* fmt, uint8_t flags, int width, int precision, T value)
+  {
+    if (width < 0)
+    {
+      width = 0;
+    }
+    else if (flags & K_PRINTF_LEFT)
+    {
+      width = -width;
+    }
+    size_t cap = buf_size - pos;
+    int n = std::snprintf(buf + pos, cap, fmt, width, precision, value);
+    if (n > 0)
+    {
+      pos += static_cast<size_t>(n) < cap ? static_cast<size_t>(n) : cap - 1;
+    }
+  }
+};
+
+// 单个转换说明的 snprintf 格式串："%<flags>*.*<length><conv>"，精度未指定时传 -1（按未指定处理）
+struct PrintfSingleSpec
+{
+  char text[16];
+};
+
+constexpr PrintfSingleSpec printf_single_spec(const PrintfSpec& spec)
+{
+  PrintfSingleSpec out{};
+  size_t n = 0;
+  out.text[n++] = '%';
+  const char flag_chars[] = {'-', '+', ' ', '#', '0'};
+  for (int i = 0; i < 5; ++i)
+  {
+    if (spec.flags & (1 << i))
+    {
+      out.text[n++] = flag_chars[i];
+    }
+  }
+  out.text[n++] = '*';
+  out.text[n++] = '.';
+  out.text[n++] = '*';
+  if (spec.length == PrintfLength::LongDouble)
+  {
+    out.text[n++] = 'L';
+  }
+  out.text[n++] = spec.conv;
+  return out;
+}
+
+template <PrintfLength Length>
+struct PrintfSignedType
+{
+  using Type = int;
+};
+template <>
+struct PrintfSignedType<PrintfLength::HH>
+{
+  using Type = signed char;
+};
+template <>
+struct PrintfSignedType<PrintfLength::H>
+{
+  using Type = short;
+};
+template <>
+struct PrintfSignedType<PrintfLength::L>
+{
+  using Type = long;
+};
+template <>
+struct PrintfSignedType<PrintfLength::LL>
+{
+  using Type = long long;
+};
+template <>
+struct PrintfSignedType<PrintfLength::J>
+{
+  using Type = intmax_t;
+};
+template <>
+struct PrintfSignedType<PrintfLength::Z>
+{
+  using Type = std::make_signed_t<size_t>;
+};
+template <>
+struct PrintfSignedType<PrintfLength::T>
+{
+  using Type = ptrdiff_t;
+};
+
+template <typename T>
+constexpr auto printf_integer_value(T value)
+{
+  if constexpr (std::is_enum_v<T>)
+  {
+    return static_cast<std::underlying_type_t<T>>(value);
+  }
+  else
+  {
+    return value;
+  }
+}
+
+inline size_t printf_radix_digits(char* end, uint64_t value, unsigned shift, const char* digits)
+{
+  char* p = end;
+  uint64_t mask = (1u << shift) - 1;
+  do
+  {
+    *--p = digits[value & mask];
+    value >>= shift;
+  } while (value != 0);
+  return static_cast<size_t>(end - p);
+}
+
+// 整数：先按长度修饰符截取（同 printf 对提升后参数的处理），再按转换的符号性解释
+template <char Conv, PrintfLength Length, typename T>
+void printf_write_integer(PrintfWriter& out, T arg, uint8_t flags, int width, int precision)
+{
+  using Signed = typename PrintfSignedType<Length>::Type;
+  using Unsigned = std::make_unsigned_t<Signed>;
+  auto value = printf_integer_value(arg);
+  bool negative = false;
+  uint64_t magnitude = 0;
+  if constexpr (Conv == 'd' || Conv == 'i')
+  {
+    auto v = static_cast<Signed>(value);
+    negative = v < 0;
+    magnitude = negative ? 0 - static_cast<uint64_t>(static_cast<int64_t>(v))
+                         : static_cast<uint64_t>(v);
+  }
+  else
+  {
+    magnitude = static_cast<Unsigned>(value);
+  }
+
+  char digits[24];
+  char* end = digits + sizeof(digits);
+  size_t len = 0;
+  if (!(precision == 0 && magnitude == 0))
+  {
+    if constexpr (Conv == 'x')
+    {
+      len = printf_radix_digits(end, magnitude, 4, "0123456789abcdef");
+    }
+    else if constexpr (Conv == 'X')
+    {
+      len = printf_radix_digits(end, magnitude, 4, "0123456789ABCDEF");
+    }
+    else if constexpr (Conv == 'o')
+    {
+      len = printf_radix_digits(end, magnitude, 3, "01234567");
+    }
+    else
+    {
+      len = digit_count(magnitude);
+      write_digits_backward(end, magnitude);
+    }
+  }
+  size_t zeros = precision > 0 && static_cast<size_t>(precision) > len
+                     ? static_cast<size_t>(precision) - len
+                     : 0;
+  char prefix[2] = {};
+  size_t prefix_len = 0;
+  if constexpr (Conv == 'd' || Conv == 'i')
+  {
+    if (negative)
+    {
+      prefix[prefix_len++] = '-';
+    }
+    else if (flags & K_PRINTF_PLUS)
+    {
+      prefix[prefix_len++] = '+';
+    }
+    else if (flags & K_PRINTF_SPACE)
+    {
+      prefix[prefix_len++] = ' ';
+    }
+  }
+  else if constexpr (Conv == 'x' || Conv == 'X')
+  {
+    if ((flags & K_PRINTF_ALT) && magnitude != 0)
+    {
+      prefix[prefix_len++] = '0';
+      prefix[prefix_len++] = Conv;
+    }
+  }
+  else if constexpr (Conv == 'o')
+  {
+    if ((flags & K_PRINTF_ALT) && zeros == 0 && (len == 0 || end[-static_cast<ptrdiff_t>(len)] != '0'))
+    {
+      zeros = 1;
+    }
+  }
+  out.Field(prefix, prefix_len, zeros, end - len, len, flags, width,
+            (flags & K_PRINTF_ZERO) != 0 && precision < 0);
+}
+
+template <char Conv, typename T>
+void printf_write_float(PrintfWriter& out, T value, uint8_t flags, int width, int precision,
+                        const char* single_spec)
+{
+#if defined(__cpp_lib_to_chars)
+  constexpr bool K_HEX = Conv == 'a' || Conv == 'A';
+  constexpr std::chars_format K_FORMAT = (Conv == 'f' || Conv == 'F')   ? std::chars_format::fixed
+                                         : (Conv == 'e' || Conv == 'E') ? std::chars_format::scientific
+                                         : (Conv == 'g' || Conv == 'G') ? std::chars_format::general
+                                                                        : std::chars_format::hex;
+  char text[128];
+  std::to_chars_result result{};
+  if (K_HEX && precision < 0)
+  {
+    result = std::to_chars(text, text + sizeof(text), value, K_FORMAT);
+  }
+  else
+  {
+    result = std::to_chars(text, text + sizeof(text), value, K_FORMAT, precision < 0 ? 6 : precision);
+  }
+  if (result.ec != std::errc())
+  {
+    // 超长的定点输出（如 %.100f 或 1e300 的 %f）
+    out.Snprintf(single_spec, flags, width, precision, value);
+    return;
+  }
+  const char* body = text;
+  auto body_len = static_cast<size_t>(result.ptr - text);
+  char prefix[3] = {};
+  size_t prefix_len = 0;
+  if (*body == '-')
+  {
+    prefix[prefix_len++] = '-';
+    ++body;
+    --body_len;
+  }
+  else if (flags & K_PRINTF_PLUS)
+  {
+    prefix[prefix_len++] = '+';
+  }
+  else if (flags & K_PRINTF_SPACE)
+  {
+    prefix[prefix_len++] = ' ';
+  }
+  if constexpr (K_HEX)
+  {
+    prefix[prefix_len++] = '0';
+    prefix[prefix_len++] = Conv == 'A' ? 'X' : 'x';
+  }
+  if constexpr (Conv == 'F' || Conv == 'E' || Conv == 'G' || Conv == 'A')
+  {
+    for (char* p = text; p != result.ptr; ++p)
+    {
+      if (*p >= 'a' && *p <= 'z')
+      {
+        *p = static_cast<char>(*p - 'a' + 'A');
+      }
+    }
+  }
+  bool finite = std::isfinite(value);
+  if (!finite && K_HEX)
+  {
+    prefix_len -= 2;  // inf / nan 不带 0x
+  }
+  out.Field(prefix, prefix_len, 0, body, body_len, flags, width,
+            (flags & K_PRINTF_ZERO) != 0 && finite);
+#else
+  out.Snprintf(single_spec, flags, width, precision, value);
+#endif
+}
+
+template <typename Parsed, size_t I, typename Tuple>
+void printf_emit(PrintfWriter& out, const Tuple& args)
+{
+  constexpr PrintfSpec spec = Parsed::K_FORMAT.specs[I];
+  if constexpr (spec.literal_len > 0)
+  {
+    out.Append(Parsed::K_FORMAT.literals.data() + spec.literal_begin, spec.literal_len);
+  }
+  if constexpr (spec.conv != '\0')
+  {
+    static constexpr PrintfSingleSpec K_SINGLE = printf_single_spec(spec);
+    uint8_t flags = spec.flags;
+    int width = spec.width;
+    int precision = spec.precision;
+    if constexpr (spec.width_arg >= 0)
+    {
+      int w = static_cast<int>(std::get<spec.width_arg>(args));
+      if (w < 0)
+      {
+        flags |= K_PRINTF_LEFT;
+        w = w == INT32_MIN ? INT32_MAX : -w;
+      }
+      width = w;
+    }
+    if constexpr (spec.precision_arg >= 0)
+    {
+      int p = static_cast<int>(std::get<spec.precision_arg>(args));
+      precision = p < 0 ? -1 : p;
+    }
+    const auto& value = std::get<spec.arg>(args);
+    if constexpr (printf_is_integer_conv(spec.conv))
+    {
+      printf_write_integer<spec.conv, spec.length>(out, value, flags, width, precision);
+    }
+    else if constexpr (printf_is_float_conv(spec.conv))
+    {
+      if constexpr ((spec.flags & K_PRINTF_ALT) != 0)
+      {
+        out.Snprintf(K_SINGLE.text, flags, width, precision, value);
+      }
+      else if constexpr (spec.length == PrintfLength::LongDouble)
+      {
+        printf_write_float<spec.conv>(out, static_cast<long double>(value), flags, width,
+                                      precision, K_SINGLE.text);
+      }
+      else
+      {
+        printf_write_float<spec.conv>(out, static_cast<double>(value), flags, width, precision,
+                                      K_SINGLE.text);
+      }
+    }
+    else if constexpr ((spec.flags & (K_PRINTF_PLUS | K_PRINTF_SPACE | K_PRINTF_ALT |
+                                      K_PRINTF_ZERO)) != 0)
+    {
+      if constexpr (spec.conv == 'c')
+      {
+        out.Snprintf(K_SINGLE.text, flags, width, precision, static_cast<int>(value));
+      }
+      else if constexpr (spec.conv == 's')
+      {
+        out.Snprintf(K_SINGLE.text, flags, width, precision, static_cast<const char*>(value));
+      }
+      else
+      {
+        out.Snprintf(K_SINGLE.text, flags, width, precision, static_cast<const void*>(value));
+      }
+    }
+    else if constexpr (spec.conv == 'c')
+    {
+      auto ch = static_cast<char>(static_cast<unsigned char>(static_cast<int>(value)));
+      out.Field(nullptr, 0, 0, &ch, 1, flags, width, false);
+    }
+    else if constexpr (spec.conv == 's')
+    {
+      const char* str = value;
+      size_t len = 0;
+      if (str == nullptr)
+      {
+        // 与 glibc 相同：精度放不下 "(null)" 时输出空串
+        str = "(null)";
+        len = precision < 0 || precision >= 6 ? 6 : 0;
+      }
+      else if (precision < 0)
+      {
+        len = std::strlen(str);
+      }
+      else
+      {
+        const void* nul = std::memchr(str, '\0', static_cast<size_t>(precision));
+        len = nul ? static_cast<size_t>(static_cast<const char*>(nul) - str)
+                  : static_cast<size_t>(precision);
+      }
+      out.Field(nullptr, 0, 0, str, len, flags, width, false);
+    }
+    else
+    {
+      const void* ptr = value;
+      if (ptr == nullptr)
+      {
+        out.Field(nullptr, 0, 0, "(nil)", 5, flags, width, false);
+      }
+      else
+      {
+        char digits[2 * sizeof(void*)];
+        size_t len = printf_radix_digits(digits + sizeof(digits),
+                                         reinterpret_cast<uintptr_t>(ptr), 4, "0123456789abcdef");
+        size_t zeros = precision > 0 && static_cast<size_t>(precision) > len
+                           ? static_cast<size_t>(precision) - len
+                           : 0;
+        out.Field("0x", 2, zeros, digits + sizeof(digits) - len, len, flags, width, false);
+      }
+    }
+  }
+}
+
+template <typename Parsed, typename Tuple, size_t... I>
+void printf_emit_all(PrintfWriter& out, const Tuple& args, std::index_sequence<I...>)
+{
+  (printf_emit<Parsed, I>(out, args), ...);
+}
+
+// 按 Source 的格式串把 args 写入 buf，语义同 snprintf 但返回实际写入的长度（不含 '\0'）
+template <typename Source, typename... Args>
+size_t format_printf(char* buf, size_t buf_size, const Args&... args)
+{
+  using Checked = PrintfChecked<Source, Args...>;
+  if (buf_size == 0)
+  {
+    return 0;
+  }
+  PrintfWriter out{buf, buf_size};
+  if constexpr (Checked::K_ERROR == PrintfError::None)
+  {
+    printf_emit_all<Checked>(out, std::forward_as_tuple(args...),
+                             std::make_index_sequence<Checked::K_FORMAT.count>{});
+  }
+  buf[out.pos] = '\0';
+  return out.pos;
+}
+
+}  // namespace detail
+
+}  // namespace br_logger
@@ -2,6 +2,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
 
 #include "platform.hpp"
@@ -24,7 +25,17 @@ class MPSCRingBuffer
     }
   }
 
-  bool TryPush(const T& item)
+  // 生产者预留的槽位，data 为空表示队列已满
+  struct Reservation
+  {
+    T* data = nullptr;
+    uint32_t pos = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+  };
+
+  // 预留一个槽位，调用方直接在 data 上填充内容后调用 Commit
+  Reservation TryReserve()
   {
     uint32_t pos = write_pos_.load(std::memory_order_relaxed);
     for (;;)
@@ -36,32 +47,106 @@ class MPSCRingBuffer
         if (write_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed,
                                              std::memory_order_relaxed))
         {
-          slot.data = item;
-          slot.sequence.store(pos + 1, std::memory_order_release);
-          return true;
+          return Reservation{&slot.data, pos};
         }
         continue;
       }
       if (seq < pos)
       {
-        return false;
+        return Reservation{};
       }
       pos = write_pos_.load(std::memory_order_relaxed);
     }
   }
 
+  void Commit(const Reservation& reservation)
+  {
+    buffer_[reservation.pos & (Capacity - 1)].sequence.store(reservation.pos + 1,
+                                                             std::memory_order_release);
+  }
+
+  bool TryPush(const T& item)
+  {
+    Reservation reservation = TryReserve();
+    if (!reservation)
+    {
+      return false;
+    }
+    *reservation.data = item;
+    Commit(reservation);
+    return true;
+  }
+
+  // 消费者直接读取队首槽位，处理完后调用 Release 归还；队列为空返回 nullptr
+  const T* Peek() const
+  {
+    const Slot& slot = buffer_[read_pos_ & (Capacity - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) == read_pos_ + 1)
+    {
+      return &slot.data;
+    }
+    return nullptr;
+  }
+
+  void Release()
+  {
+    buffer_[read_pos_ & (Capacity - 1)].sequence.store(read_pos_ + Capacity,
+                                                       std::memory_order_release);
+    ++read_pos_;
+  }
+
   bool TryPop(T& item)
   {
-    Slot& slot = buffer_[read_pos_ & (Capacity - 1)];
-    uint32_t seq = slot.sequence.load(std::memory_order_acquire);
-    if (seq == read_pos_ + 1)
+    const T* data = Peek();
+    if (data == nullptr)
+    {
+      return false;
+    }
+    item = *data;
+    Release();
+    return true;
+  }
+
+  // 批量读取：返回从队首起连续就绪的槽位数（至多 max），用 PeekAt 访问，
+  // 处理完后调用 ReleaseBatch 一并归还
+  size_t PeekBatch(size_t max) const
+  {
+    size_t n = 0;
+    while (n < max && n < Capacity)
+    {
+      uint32_t pos = read_pos_ + static_cast<uint32_t>(n);
+      if (buffer_[pos & (Capacity - 1)].sequence.load(std::memory_order_acquire) != pos + 1)
+      {
+        break;
+      }
+      ++n;
+    }
+    return n;
+  }
+
+  const T& PeekAt(size_t i) const
+  {
+    return buffer_[(read_pos_ + static_cast<uint32_t>(i)) & (Capacity - 1)].data;
+  }
+
+  void ReleaseBatch(size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      Release();
+    }
+  }
+
+  // 一次取出至多 max 个元素，返回取出的个数
+  size_t TryPopBatch(T* out, size_t max)
+  {
+    size_t n = PeekBatch(max);
+    for (size_t i = 0; i < n; ++i)
     {
-      item = slot.data;
-      slot.sequence.store(read_pos_ + Capacity, std::memory_order_release);
-      ++read_pos_;
-      return true;
+      out[i] = PeekAt(i);
     }
-    return false;
+    ReleaseBatch(n);
+    return n;
   }
 
   bool Empty() const
@@ -84,4 +169,259 @@ class MPSCRingBuffer
   alignas(BR_LOG_CACHELINE_SIZE) uint32_t read_pos_{};
 };
 
+// 字节环形队列中一次预留的连续空间，data 为空表示空间不足。
+// 提交只需写入 state 指向的状态字，因此与具体的队列实例无关。
+struct ByteReservation
+{
+  uint8_t* data = nullptr;
+  std::atomic<uint32_t>* state = nullptr;
+  uint32_t blocks = 0;
+
+  explicit operator bool() const { return data != nullptr; }
+};
+
+// 变长记录的环形队列：按 cacheline 大小的块分配空间，
+// 生产者只占用 ceil(size / K_BLOCK_SIZE) 个块，消费者按记录逐条遍历。
+// 每个块对应一个状态字，只有记录的首块会被写入 (块数 << 16 | 字节数)，
+// 消费后清零，因此残留数据永远不会被误认为已提交的记录。
+// MultiProducer 为 false 时写位置只由一个线程推进，预留不需要 CAS，
+// 并缓存读位置以减少与消费者之间的 cacheline 往返。
+template <size_t CapacityBytes, bool MultiProducer>
+class ByteRingBuffer
+{
+ public:
+  using Reservation = ByteReservation;
+
+  static constexpr size_t K_BLOCK_SIZE = BR_LOG_CACHELINE_SIZE;
+  static constexpr uint32_t K_BLOCKS = static_cast<uint32_t>(CapacityBytes / K_BLOCK_SIZE);
+  static constexpr uint32_t K_MAX_RECORD_SIZE =
+      (K_BLOCKS / 2) * K_BLOCK_SIZE < 0xFFFF ? (K_BLOCKS / 2) * K_BLOCK_SIZE : 0xFFFF;
+
+  static_assert((CapacityBytes & (CapacityBytes - 1)) == 0, "Capacity must be power of 2");
+  static_assert(CapacityBytes >= 4 * K_BLOCK_SIZE, "Capacity too small");
+
+  ByteRingBuffer() : write_pos_(0), read_pos_(0)
+  {
+    for (uint32_t i = 0; i < K_BLOCKS; ++i)
+    {
+      state_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // 预留 size 字节的连续空间，调用方直接写入 data 后调用 Commit
+  Reservation TryReserve(uint32_t size)
+  {
+    if (size == 0 || size > K_MAX_RECORD_SIZE)
+    {
+      return Reservation{};
+    }
+    uint32_t blocks = BlocksFor(size);
+    uint32_t pos = write_pos_.load(std::memory_order_relaxed);
+    uint32_t pad = 0;
+    for (;;)
+    {
+      if (!PlanReserve(pos, blocks, pad))
+      {
+        return Reservation{};
+      }
+      if constexpr (MultiProducer)
+      {
+        if (write_pos_.compare_exchange_weak(pos, pos + pad + blocks,
+                                             std::memory_order_relaxed,
+                                             std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else
+      {
+        write_pos_.store(pos + pad + blocks, std::memory_order_relaxed);
+        break;
+      }
+    }
+    return FinishReserve(pos, pad, blocks);
+  }
+
+  // 以下三个接口供自定义的写位置推进方式（如 rseq 临界区）使用：
+  // PlanReserve 检查从 pos 开始能否放下 blocks 个块并给出尾部填充块数，
+  // 调用方把写位置从 pos 推进到 pos + pad + blocks 后再调用 FinishReserve
+  std::atomic<uint32_t>& WritePosition() { return write_pos_; }
+
+  bool PlanReserve(uint32_t pos, uint32_t blocks, uint32_t& pad)
+  {
+    uint32_t tail_room = K_BLOCKS - (pos & (K_BLOCKS - 1));
+    pad = (blocks > tail_room) ? tail_room : 0;
+    return HasRoom(pos, pad + blocks);
+  }
+
+  Reservation FinishReserve(uint32_t pos, uint32_t pad, uint32_t blocks)
+  {
+    if (pad > 0)
+    {
+      // 尾部放不下：插入一条只占位的填充记录，真正的记录从头开始
+      state_[pos & (K_BLOCKS - 1)].store(pad << 16, std::memory_order_release);
+      pos += pad;
+    }
+    uint32_t idx = pos & (K_BLOCKS - 1);
+    return Reservation{&data_[static_cast<size_t>(idx) * K_BLOCK_SIZE], &state_[idx], blocks};
+  }
+
+  // 提交预留的记录，size 为实际写入的字节数，可小于预留大小；
+  // size 为 0 时该段空间按填充记录处理，相当于放弃本次预留
+  static void Commit(const Reservation& reservation, uint32_t size)
+  {
+    reservation.state->store((reservation.blocks << 16) | size, std::memory_order_release);
+  }
+
+  // 写入一条 size 字节的记录，空间不足时返回 false
+  bool TryPush(const void* data, uint32_t size)
+  {
+    Reservation reservation = TryReserve(size);
+    if (!reservation)
+    {
+      return false;
+    }
+    std::memcpy(reservation.data, data, size);
+    Commit(reservation, size);
+    return true;
+  }
+
+  // 消费者直接读取队首记录，处理完后调用 Release 归还空间；队列为空返回 nullptr
+  const uint8_t* Peek(uint32_t& size)
+  {
+    for (;;)
+    {
+      uint32_t pos = read_pos_.load(std::memory_order_relaxed);
+      uint32_t idx = pos & (K_BLOCKS - 1);
+      uint32_t state = state_[idx].load(std::memory_order_acquire);
+      if (state == 0)
+      {
+        return nullptr;
+      }
+      size = state & 0xFFFF;
+      if (size > 0)
+      {
+        return &data_[static_cast<size_t>(idx) * K_BLOCK_SIZE];
+      }
+      Release();  // 跳过填充记录
+    }
+  }
+
+  void Release()
+  {
+    uint32_t pos = read_pos_.load(std::memory_order_relaxed);
+    uint32_t idx = pos & (K_BLOCKS - 1);
+    uint32_t blocks = state_[idx].load(std::memory_order_relaxed) >> 16;
+    state_[idx].store(0, std::memory_order_relaxed);
+    read_pos_.store(pos + blocks, std::memory_order_release);
+  }
+
+  // 批量读取：cursor 从 ReadCursor() 开始，PeekNext 依次返回其后已提交的记录并前移 cursor，
+  // 读到的记录在 ReleaseTo(cursor) 之前保持有效；ReleaseTo 一次性归还，只发布一次读位置
+  uint32_t ReadCursor() const { return read_pos_.load(std::memory_order_relaxed); }
+
+  const uint8_t* PeekNext(uint32_t& cursor, uint32_t& size)
+  {
+    for (;;)
+    {
+      if (cursor - read_pos_.load(std::memory_order_relaxed) >= K_BLOCKS)
+      {
+        return nullptr;  // 已读到一整圈，剩下的块还未归还
+      }
+      uint32_t idx = cursor & (K_BLOCKS - 1);
+      uint32_t state = state_[idx].load(std::memory_order_acquire);
+      if (state == 0)
+      {
+        return nullptr;
+      }
+      cursor += state >> 16;
+      size = state & 0xFFFF;
+      if (size > 0)
+      {
+        return &data_[static_cast<size_t>(idx) * K_BLOCK_SIZE];
+      }
+    }
+  }
+
+  void ReleaseTo(uint32_t cursor)
+  {
+    uint32_t pos = read_pos_.load(std::memory_order_relaxed);
+    if (pos == cursor)
+    {
+      return;
+    }
+    while (pos != cursor)
+    {
+      uint32_t idx = pos & (K_BLOCKS - 1);
+      pos += state_[idx].load(std::memory_order_relaxed) >> 16;
+      state_[idx].store(0, std::memory_order_relaxed);
+    }
+    read_pos_.store(cursor, std::memory_order_release);
+  }
+
+  // 取出一条记录，返回记录字节数（超出 out_size 的部分被截断），队列为空返回 0
+  uint32_t TryPop(void* out, uint32_t out_size)
+  {
+    uint32_t size = 0;
+    const uint8_t* data = Peek(size);
+    if (data == nullptr)
+    {
+      return 0;
+    }
+    std::memcpy(out, data, size < out_size ? size : out_size);
+    Release();
+    return size;
+  }
+
+  bool Empty() const
+  {
+    uint32_t pos = read_pos_.load(std::memory_order_relaxed);
+    return state_[pos & (K_BLOCKS - 1)].load(std::memory_order_acquire) == 0;
+  }
+
+  // 所有预留过的空间都已归还，包括尚未提交的预留；仅消费者调用
+  bool Drained() const
+  {
+    return read_pos_.load(std::memory_order_relaxed) ==
+           write_pos_.load(std::memory_order_acquire);
+  }
+
+  size_t GetCapacity() const { return CapacityBytes; }
+
+  static constexpr uint32_t BlocksFor(uint32_t size)
+  {
+    return static_cast<uint32_t>((size + K_BLOCK_SIZE - 1) / K_BLOCK_SIZE);
+  }
+
+ private:
+  bool HasRoom(uint32_t pos, uint32_t blocks)
+  {
+    if constexpr (!MultiProducer)
+    {
+      if (pos - cached_read_pos_ + blocks <= K_BLOCKS)
+      {
+        return true;
+      }
+    }
+    uint32_t read_pos = read_pos_.load(std::memory_order_acquire);
+    if constexpr (!MultiProducer)
+    {
+      cached_read_pos_ = read_pos;
+    }
+    return pos - read_pos + blocks <= K_BLOCKS;
+  }
+
+  alignas(BR_LOG_CACHELINE_SIZE) uint8_t data_[CapacityBytes];
+  std::atomic<uint32_t> state_[K_BLOCKS];
+  alignas(BR_LOG_CACHELINE_SIZE) std::atomic<uint32_t> write_pos_;
+  uint32_t cached_read_pos_ = 0;  // 仅单生产者使用
+  alignas(BR_LOG_CACHELINE_SIZE) std::atomic<uint32_t> read_pos_;
+};
+
+template <size_t CapacityBytes>
+using MPSCByteRingBuffer = ByteRingBuffer<CapacityBytes, true>;
+
+template <size_t CapacityBytes>
+using SPSCByteRingBuffer = ByteRingBuffer<CapacityBytes, false>;
+
 }  // namespace br_logger
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <memory>
+
+#include "../backpressure.hpp"
+#include "../clock_source.hpp"
+#include "../platform.hpp"
+#include "../ring_buffer.hpp"
+#include "sink_interface.hpp"
+
+#if BR_LOG_HAS_THREAD
+#include <thread>
+
+namespace br_logger
+{
+
+struct AsyncSinkOptions
+{
+  // 队列满时的处理：DROP_NEWEST 丢弃（默认）；BOUNDED_WAIT 至多等待 wait_timeout_ns；
+  // BLOCK 一直等待，慢 Sink 会反压到后端。DROP_OLDEST 按 DROP_NEWEST 处理
+  OverflowAction overflow_action = OverflowAction::DROP_NEWEST;
+  uint64_t wait_timeout_ns = 1'000'000;
+};
+
+struct AsyncSinkStats
+{
+  uint64_t enqueued = 0;       // 进入队列的条数
+  uint64_t dropped = 0;        // 队列满被丢弃的条数（含等待超时）
+  uint64_t wait_timeouts = 0;  // BOUNDED_WAIT 等待超时的次数
+};
+
+// 把任意 Sink 放到独立线程上运行：后端只把记录编码进本适配器的有界队列，
+// 慢 Sink（网络文件系统、阻塞的管道）不会拖住后端和其他 Sink。
+// 被包装的 Sink 的格式化器与级别应在包装前设置好；Flush 会等待队列中已有的记录写完
+class AsyncSinkAdapter : public ILogSink
+{
+ public:
+  using Queue = SPSCByteRingBuffer<BR_LOG_ASYNC_SINK_QUEUE_BYTES>;
+
+  explicit AsyncSinkAdapter(std::unique_ptr<ILogSink> sink,
+                            const AsyncSinkOptions& options = AsyncSinkOptions{});
+  ~AsyncSinkAdapter() override;
+
+  AsyncSinkAdapter(const AsyncSinkAdapter&) = delete;
+  AsyncSinkAdapter& operator=(const AsyncSinkAdapter&) = delete;
+
+  void Write(const LogEntry& entry) override;
+  void WriteBatch(const LogEntry* entries, size_t count) override;
+  void Flush() override;
+
+  AsyncSinkStats Stats() const;
+  ILogSink& Inner() { return *sink_; }
+
+ private:
+  bool Enqueue(const LogEntry& entry);
+  bool WaitForSpace(uint32_t size);
+  void WakeWorker();
+  void WorkerLoop();
+  size_t DrainQueue();
+
+  std::unique_ptr<ILogSink> sink_;
+  AsyncSinkOptions options_;
+  std::unique_ptr<Queue> queue_;
+  std::unique_ptr<LogEntry[]> batch_;  // 仅工作线程使用
+  ClockConverter clock_;               // 队列中的记录已是纳秒，只用于满足解码接口
+
+  std::atomic<bool> running_{true};
+  // 工作线程睡眠前置位 worker_sleeping_，生产者看到后递增 worker_seq_ 并唤醒；
+  // 等待空间的生产者在 space_seq_ 上睡眠，工作线程归还空间后唤醒
+  alignas(BR_LOG_CACHELINE_SIZE) std::atomic<bool> worker_sleeping_{false};
+  std::atomic<uint32_t> worker_seq_{0};
+  std::atomic<bool> space_waiting_{false};
+  std::atomic<uint32_t> space_seq_{0};
+  // Flush：请求序号由调用方递增，工作线程写完队列并刷新 Sink 后更新完成序号
+  std::atomic<uint32_t> flush_requested_{0};
+  std::atomic<uint32_t> flush_done_{0};
+
+  std::atomic<uint64_t> enqueued_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> wait_timeouts_{0};
+
+  std::thread worker_;
+};
+
+}  // namespace br_logger
+
+#endif  // BR_LOG_HAS_THREAD
@@ -1,5 +1,6 @@
 #pragma once
 #include <optional>
+#include <vector>
 
 #include "sink_interface.hpp"
 
@@ -12,9 +13,14 @@ class ConsoleSink : public ILogSink
   explicit ConsoleSink(std::optional<bool> force_color = std::nullopt);
 
   void Write(const LogEntry& entry) override;
+  void WriteBatch(const LogEntry* entries, size_t count) override;
+  void WriteFormatted(const FormattedBatch& batch) override;
   void Flush() override;
 
  private:
+  // 整批格式化到 batch_buf_，stdout / stderr 各自连续的一段只调用一次 fwrite
+  std::vector<char> batch_buf_;
+
   bool use_color_;
   bool stdout_is_tty_;
   bool stderr_is_tty_;
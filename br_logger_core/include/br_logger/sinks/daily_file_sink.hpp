@@ -2,6 +2,7 @@
 #include <ctime>
 #include <string>
 
+#include "fd_writer.hpp"
 #include "sink_interface.hpp"
 
 namespace br_logger
@@ -15,7 +16,12 @@ class DailyFileSink : public ILogSink
   ~DailyFileSink();
 
   void Write(const LogEntry& entry) override;
+  void WriteBatch(const LogEntry* entries, size_t count) override;
+  void WriteFormatted(const FormattedBatch& batch) override;
   void Flush() override;
+  void OnIdle() override;
+
+  FdWriterStats WriterStats() const { return writer_.Stats(); }
 
   std::string MakeFilename(std::time_t t) const;
 
@@ -26,6 +32,7 @@ class DailyFileSink : public ILogSink
   bool use_utc_;
   int fd_;
   int current_day_;
+  FdWriter writer_;
 
   void OpenFileForToday();
   void CleanupOldFiles();
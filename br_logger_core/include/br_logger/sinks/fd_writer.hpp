@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace br_logger
+{
+
+struct FdWriterStats
+{
+  uint64_t syscalls = 0;       // write / writev 调用次数（含部分写入后的重试）
+  uint64_t bytes_written = 0;  // 成功写入 fd 的字节数
+  uint64_t write_errors = 0;   // 出错后丢弃缓冲的次数
+};
+
+// 文件 Sink 共用的带缓冲 fd 写入器：行先格式化进对齐的缓冲区，
+// 缓冲超过 flush_bytes 或最早的数据超过 flush_age_ns 时一次写出；
+// 放不下的大块数据与缓冲内容合并为一次 writev。
+// 写入处理 EINTR 与部分写入；其他错误时丢弃本次数据，避免后端线程卡死。
+// 不拥有 fd，不做 fsync，由 Sink 负责打开、关闭与落盘
+class FdWriter
+{
+ public:
+  static constexpr size_t K_ALIGNMENT = 4096;
+
+  // capacity 向上取整到 K_ALIGNMENT；flush_age_ns 为 0 表示只按字节阈值写出
+  FdWriter(size_t capacity, size_t flush_bytes, uint64_t flush_age_ns);
+  ~FdWriter();
+
+  FdWriter(const FdWriter&) = delete;
+  FdWriter& operator=(const FdWriter&) = delete;
+
+  // 切换到新的 fd；调用方应先 Flush 旧 fd 的缓冲。file_size 为文件已有的大小
+  void Reset(int fd, size_t file_size);
+  int Fd() const { return fd_; }
+
+  // 在缓冲区末尾预留至少 max_len 字节用于原地格式化，不够时先写出已缓冲的数据；
+  // 写好后用 Commit 提交实际长度。max_len 不能超过容量
+  char* Reserve(size_t max_len);
+  void Commit(size_t len);
+
+  // 追加任意长度的数据，放不下时与已缓冲的数据一起 writev
+  void Append(const char* data, size_t len);
+
+  // 达到字节或时间阈值时写出，now_ns 为调用方的单调时钟。缓冲的时长从写入后第一次
+  // 调用本函数时开始计算，写入器自身不读时钟（嵌入式模式下时钟来自 br_log_monotonic_ns）
+  void FlushIfDue(uint64_t now_ns);
+  // 写出全部缓冲，返回是否成功
+  bool Flush();
+
+  // 逻辑文件大小：已写入加上仍在缓冲中的字节，用于按大小轮转
+  size_t FileSize() const { return file_size_; }
+  size_t Buffered() const { return used_; }
+  FdWriterStats Stats() const { return stats_; }
+
+ private:
+  bool WriteFully(const char* data, size_t len, const char* tail, size_t tail_len);
+
+  char* buf_;
+  size_t capacity_;
+  size_t flush_bytes_;
+  uint64_t flush_age_ns_;
+  size_t used_ = 0;
+  uint64_t first_buffered_ns_ = 0;  // 缓冲非空后第一次 FlushIfDue 的时刻
+  bool has_buffered_ = false;       // first_buffered_ns_ 是否已记录
+  int fd_ = -1;
+  size_t file_size_ = 0;
+  FdWriterStats stats_;
+};
+
+}  // namespace br_logger
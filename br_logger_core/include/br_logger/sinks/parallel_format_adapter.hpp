@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "../platform.hpp"
+#include "sink_interface.hpp"
+
+#if BR_LOG_HAS_THREAD
+#include <thread>
+
+namespace br_logger
+{
+
+struct ParallelFormatOptions
+{
+  // 格式化线程数；0 表示在调用 WriteBatch 的线程上格式化（与直接使用被包装 Sink 的开销相当）
+  uint32_t threads = 2;
+  const char* thread_name = "br_log_format";  // 超过 15 字节的部分被截断，nullptr 表示不设置
+};
+
+// 把昂贵的格式化（例如带转义的 JsonFormatter）分给一组线程：每次 WriteBatch 的记录拷进一个批，
+// 各线程并行把批格式化进自己的输出缓冲；输出阶段在调用线程上按提交顺序把格式化好的批
+// 交给被包装 Sink 的 WriteFormatted，因此输出顺序与输入一致。
+// 最多 BR_LOG_FORMAT_JOBS 个批同时在途，都未完成时调用线程等待最早的一批。
+// formatter 会被多个线程同时调用，须可重入（内置的 PatternFormatter / JsonFormatter 均满足）
+class ParallelFormatAdapter : public ILogSink
+{
+ public:
+  ParallelFormatAdapter(std::unique_ptr<ILogSink> sink, std::unique_ptr<IFormatter> formatter,
+                        const ParallelFormatOptions& options = ParallelFormatOptions{});
+  ~ParallelFormatAdapter() override;
+
+  ParallelFormatAdapter(const ParallelFormatAdapter&) = delete;
+  ParallelFormatAdapter& operator=(const ParallelFormatAdapter&) = delete;
+
+  void Write(const LogEntry& entry) override;
+  void WriteBatch(const LogEntry* entries, size_t count) override;
+  // 先输出所有在途的批，再调用被包装 Sink 的 Flush / OnIdle
+  void Flush() override;
+  void OnIdle() override;
+
+  ILogSink& Inner() { return *sink_; }
+
+ private:
+  // 单行输出上限，与 ILogSink::format_buf_ 一致
+  static constexpr size_t K_LINE_BYTES = sizeof(format_buf_);
+
+  struct Job
+  {
+    LogEntry entries[BR_LOG_DISPATCH_BATCH];
+    uint32_t offsets[BR_LOG_DISPATCH_BATCH + 1];
+    size_t count = 0;
+    std::unique_ptr<char[]> text;
+    std::atomic<uint32_t> done{0};  // 第 seq 次提交格式化完成后写入 seq + 1
+  };
+
+  Job& JobAt(uint32_t seq) { return jobs_[seq % BR_LOG_FORMAT_JOBS]; }
+  void Submit();
+  void FormatJob(Job& job);
+  // 按提交顺序输出已完成的批；wait 为 true 时等待全部在途的批
+  void EmitReady(bool wait);
+  void WaitDone(const Job& job, uint32_t expected);
+  void PoolLoop();
+
+  std::unique_ptr<ILogSink> sink_;
+  std::unique_ptr<Job[]> jobs_;
+  uint32_t emitted_ = 0;     // 仅调用线程使用：已输出的批数
+  Job* filling_ = nullptr;   // 正在填充、尚未提交的批
+
+  // 调用线程递增 submitted_ 提交批；格式化线程通过 claimed_ 认领，空闲时在 work_seq_ 上睡眠。
+  // 调用线程等待批完成时置位 emitter_waiting_，在 done_seq_ 上睡眠
+  alignas(BR_LOG_CACHELINE_SIZE) std::atomic<uint32_t> submitted_{0};
+  std::atomic<uint32_t> work_seq_{0};
+  std::atomic<uint32_t> sleepers_{0};
+  alignas(BR_LOG_CACHELINE_SIZE) std::atomic<uint32_t> claimed_{0};
+  alignas(BR_LOG_CACHELINE_SIZE) std::atomic<bool> emitter_waiting_{false};
+  std::atomic<uint32_t> done_seq_{0};
+  std::atomic<bool> running_{true};
+
+  std::vector<std::thread> pool_;
+};
+
+}  // namespace br_logger
+
+#endif  // BR_LOG_HAS_THREAD
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 
+#include "fd_writer.hpp"
 #include "sink_interface.hpp"
 
 namespace br_logger
@@ -18,14 +19,19 @@ class RotatingFileSink : public ILogSink
   ~RotatingFileSink();
 
   void Write(const LogEntry& entry) override;
+  void WriteBatch(const LogEntry* entries, size_t count) override;
+  void WriteFormatted(const FormattedBatch& batch) override;
   void Flush() override;
+  void OnIdle() override;
+
+  FdWriterStats WriterStats() const { return writer_.Stats(); }
 
  private:
   std::string base_path_;
   size_t max_file_size_;
   size_t max_files_;
-  size_t current_size_;
   int fd_;
+  FdWriter writer_;  // 行直接格式化进写缓冲，FileSize() 含未写出的字节
 
   void OpenFile();
   void Rotate();
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 #include "../formatters/formatter_interface.hpp"
@@ -8,6 +10,17 @@
 namespace br_logger
 {
 
+// 已在别处（ParallelFormatAdapter 的格式化线程）格式化好的一批日志。
+// 第 i 条的输出为 text[offsets[i], offsets[i + 1])，含行尾 '\n'，为空表示格式化结果为空；
+// 各行在 text 中连续存放，entries 已按目标 Sink 的级别过滤
+struct FormattedBatch
+{
+  const LogEntry* entries;
+  const char* text;
+  const uint32_t* offsets;  // count + 1 项
+  size_t count;
+};
+
 class ILogSink
 {
  public:
@@ -16,9 +29,30 @@ class ILogSink
   // 写入一条日志（由后端线程调用）
   virtual void Write(const LogEntry& entry) = 0;
 
+  // 按顺序写入一批日志（由后端线程调用）。默认逐条调用 Write，
+  // 可重写为把整批格式化进一个缓冲区后一次输出
+  virtual void WriteBatch(const LogEntry* entries, size_t count)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      Write(entries[i]);
+    }
+  }
+
+  // 写入一批已格式化的日志（由 ParallelFormatAdapter 调用）。默认忽略 text 按 WriteBatch 重新格式化，
+  // 可重写为直接输出 text
+  virtual void WriteFormatted(const FormattedBatch& batch)
+  {
+    WriteBatch(batch.entries, batch.count);
+  }
+
   // 刷新缓冲区
   virtual void Flush() = 0;
 
+  // 后端取空队列时调用（由后端线程调用）：带写缓冲的 Sink 在此把缓冲写出，
+  // 空闲期间不会有日志滞留在内存里。不要求落盘
+  virtual void OnIdle() {}
+
   // 设置该 Sink 的格式化器
   void SetFormatter(std::unique_ptr<IFormatter> formatter)
   {
@@ -40,10 +74,16 @@ class ILogSink
 
   // 通用格式化，返回格式化后的长度
   size_t DoFormat(const LogEntry& entry)
+  {
+    return DoFormat(entry, format_buf_, sizeof(format_buf_));
+  }
+
+  // 格式化到调用方的缓冲区，批量输出时直接写入批缓冲
+  size_t DoFormat(const LogEntry& entry, char* buf, size_t buf_size)
   {
     if (formatter_)
     {
-      return formatter_->Format(entry, format_buf_, sizeof(format_buf_));
+      return formatter_->Format(entry, buf, buf_size);
     }
     return 0;
   }
@@ -1,6 +1,10 @@
 #pragma once
 #include <cstdint>
 
+#if __cplusplus >= 202002L && __has_include(<source_location>)
+#include <source_location>
+#endif
+
 namespace br_logger
 {
 
@@ -28,7 +32,6 @@ struct SourceLocation
 };
 
 #if __cplusplus >= 202002L && __has_include(<source_location>)
-#include <source_location>
 #define BR_LOG_HAS_SOURCE_LOCATION 1
 #define BR_LOG_CURRENT_LOCATION()                                                        \
   ::br_logger::SourceLocation                                                            \
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "platform.hpp"
+
+namespace br_logger
+{
+
+using TagId = uint32_t;
+
+// 进程级的 tag 字符串驻留表：key 与 value 各自只在第一次出现时保存一份，
+// 日志条目中只携带 ID，由后端格式化时解析。字符串只增不删，
+// 解析得到的指针在进程生命周期内有效。
+// 为避免请求 ID 这类只出现一次的值占满驻留表，value 从第二次出现起才驻留，
+// 未驻留的值由调用方随日志条目内联携带
+class TagDictionary
+{
+ public:
+  static constexpr size_t K_SEGMENT_SIZE = 256;
+  static constexpr size_t K_SEEN_SLOTS = 1024;
+  static constexpr size_t K_MAX_SEGMENTS =
+      (BR_LOG_TAG_DICT_CAPACITY + K_SEGMENT_SIZE - 1) / K_SEGMENT_SIZE;
+
+  // 空字符串固定为 0；驻留表已满时返回 K_OVERFLOW_ID
+  static constexpr TagId K_EMPTY_ID = 0;
+  static constexpr TagId K_OVERFLOW_ID = 1;
+
+  static TagDictionary& Instance();
+
+  // 返回 str 的 ID，第一次出现时分配；同一线程重复驻留相同字符串不加锁
+  TagId Intern(std::string_view str);
+
+  // 值的驻留：已驻留或此前见过一次时返回 true 并给出 ID；第一次出现或驻留表已满时
+  // 返回 false，由调用方内联携带该值
+  bool InternValue(std::string_view str, TagId& id);
+
+  // 只查找不分配，不存在时返回 false
+  bool Find(std::string_view str, TagId& id) const;
+
+  // 无锁解析，供后端格式化使用；未知 ID 返回空字符串
+  std::string_view Resolve(TagId id) const;
+
+  // 已驻留的字符串数（含两个保留项）
+  size_t Size() const { return size_.load(std::memory_order_acquire); }
+
+ private:
+  TagDictionary();
+
+  struct Segment
+  {
+    std::string_view strings[K_SEGMENT_SIZE];
+  };
+
+  TagId InternLocked(std::string_view str);
+
+  mutable std::mutex mutex_;
+  std::deque<std::string> storage_;  // deque 追加时不移动已有元素，视图保持有效
+  std::unordered_map<std::string_view, TagId> index_;
+  std::atomic<Segment*> segments_[K_MAX_SEGMENTS] = {};
+  std::atomic<size_t> size_{0};
+  std::atomic<size_t> seen_once_[K_SEEN_SLOTS] = {};  // 只见过一次的值的哈希，直接映射
+};
+
+}  // namespace br_logger
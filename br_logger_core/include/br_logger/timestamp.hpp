@@ -7,8 +7,13 @@ namespace br_logger
 
 uint64_t monotonic_now_ns();
 uint64_t wall_clock_now_ns();
-size_t format_timestamp(uint64_t wall_ns, char* buf, size_t buf_size);
-size_t format_date(uint64_t wall_ns, char* buf, size_t buf_size);
-size_t format_time(uint64_t wall_ns, char* buf, size_t buf_size);
+
+// 本地时间文本，截断语义同 snprintf。日期与时分秒按秒在每个线程内缓存，
+// 同一秒内的记录只渲染小数部分；UTC 偏移在本地整点或 TZ 变化时才重新查询
+size_t format_timestamp(uint64_t wall_ns, char* buf, size_t buf_size);  // YYYY-MM-DD HH:MM:SS.uuuuuu
+size_t format_date(uint64_t wall_ns, char* buf, size_t buf_size);       // YYYY-MM-DD
+size_t format_time(uint64_t wall_ns, char* buf, size_t buf_size);       // HH:MM:SS.uuuuuu
+size_t format_clock_time(uint64_t wall_ns, char* buf, size_t buf_size); // HH:MM:SS
+size_t format_micros(uint64_t wall_ns, char* buf, size_t buf_size);     // .uuuuuu
 
 }  // namespace br_logger
@@ -1,5 +1,11 @@
 #include "br_logger/backend.hpp"
 
+#include <algorithm>
+#include <cstdio>
+
+#include "br_logger/futex.hpp"
+#include "br_logger/timestamp.hpp"
+
 #if BR_LOG_HAS_THREAD
 #include <chrono>
 #endif
@@ -7,37 +13,460 @@
 namespace br_logger
 {
 
-LoggerBackend::LoggerBackend() = default;
+namespace
+{
+
+std::atomic<uint64_t> g_next_backend_id{1};
+
+#if BR_LOG_HAS_THREAD
+// 后端线程自身（例如 sink 内部写日志）不能等待队列空间，否则会等待自己
+thread_local bool tls_backend_worker = false;
+#endif
+
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+// 归并键：各记录的时钟域可能不同（TSC 计数、纳秒），统一换算成单调纳秒后再比较，
+// 相同时比较序号
+struct MergeKey
+{
+  uint64_t mono_ns;
+  uint64_t sequence_id;
+};
+
+MergeKey merge_key(const uint8_t* data, ClockConverter& clock)
+{
+  const auto* record = reinterpret_cast<const LogRecord*>(data);
+  MergeKey key{record->timestamp, record->sequence_id};
+  if (record->clock != K_CLOCK_NANOS)
+  {
+    uint64_t wall_ns = 0;
+    clock.Convert(record->clock, record->timestamp, key.mono_ns, wall_ns);
+  }
+  return key;
+}
+
+bool key_before(const MergeKey& a, const MergeKey& b)
+{
+  if (a.mono_ns != b.mono_ns)
+  {
+    return a.mono_ns < b.mono_ns;
+  }
+  return a.sequence_id < b.sequence_id;
+}
+
+}  // namespace
+
+LoggerBackend::LoggerBackend()
+    : batch_storage_(new LogEntry[BR_LOG_DISPATCH_BATCH]),
+      batch_(batch_storage_.get()),
+      id_(g_next_backend_id.fetch_add(1, std::memory_order_relaxed))
+{
+  SetQueueTopology(K_DEFAULT_QUEUE_TOPOLOGY);
+  SetOverflowCapacity(BR_LOG_OVERFLOW_BYTES);
+}
 
 LoggerBackend::~LoggerBackend() { Stop(); }
 
-bool LoggerBackend::TryPush(const LogEntry& entry) { return ring_.TryPush(entry); }
+bool LoggerBackend::TryPush(const LogEntry& entry)
+{
+  uint32_t size = static_cast<uint32_t>(record_size(entry));
+  Reservation reservation = TryReserve(size, entry.level);
+  if (!reservation)
+  {
+    CountLaneDrop(entry.level);
+    return false;
+  }
+  encode_record(entry, reservation.data);
+  Commit(reservation, size);
+  return true;
+}
+
+void LoggerBackend::SetBackpressurePolicy(const BackpressurePolicy& policy)
+{
+  for (int i = 0; i < BackpressurePolicy::K_LEVELS; ++i)
+  {
+    overflow_actions_[i].store(policy.actions[i], std::memory_order_relaxed);
+  }
+  spin_count_.store(policy.spin_count, std::memory_order_relaxed);
+  wait_timeout_ns_.store(policy.wait_timeout_ns, std::memory_order_relaxed);
+}
+
+BackpressurePolicy LoggerBackend::GetBackpressurePolicy() const
+{
+  BackpressurePolicy policy;
+  for (int i = 0; i < BackpressurePolicy::K_LEVELS; ++i)
+  {
+    policy.actions[i] = overflow_actions_[i].load(std::memory_order_relaxed);
+  }
+  policy.spin_count = spin_count_.load(std::memory_order_relaxed);
+  policy.wait_timeout_ns = wait_timeout_ns_.load(std::memory_order_relaxed);
+  return policy;
+}
+
+BackpressureStats LoggerBackend::GetBackpressureStats() const
+{
+  BackpressureStats stats;
+  stats.dropped_newest = backpressure_.dropped_newest.load(std::memory_order_relaxed);
+  stats.dropped_oldest = backpressure_.dropped_oldest.load(std::memory_order_relaxed);
+  stats.wait_timeouts = backpressure_.wait_timeouts.load(std::memory_order_relaxed);
+  stats.bounded_waits = backpressure_.bounded_waits.load(std::memory_order_relaxed);
+  stats.blocks = backpressure_.blocks.load(std::memory_order_relaxed);
+  stats.wait_ns = backpressure_.wait_ns.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void LoggerBackend::ResetBackpressureStats()
+{
+  backpressure_.dropped_newest.store(0, std::memory_order_relaxed);
+  backpressure_.dropped_oldest.store(0, std::memory_order_relaxed);
+  backpressure_.wait_timeouts.store(0, std::memory_order_relaxed);
+  backpressure_.bounded_waits.store(0, std::memory_order_relaxed);
+  backpressure_.blocks.store(0, std::memory_order_relaxed);
+  backpressure_.wait_ns.store(0, std::memory_order_relaxed);
+  for (auto& drops : lane_drops_)
+  {
+    drops.store(0, std::memory_order_relaxed);
+  }
+}
+
+bool LoggerBackend::CanWait() const
+{
+#if BR_LOG_HAS_THREAD
+  return running_.load(std::memory_order_relaxed) && !tls_backend_worker;
+#else
+  return false;
+#endif
+}
+
+LoggerBackend::Reservation LoggerBackend::ReserveSlow(uint32_t size, LogLevel level)
+{
+  int index = static_cast<int>(level);
+  OverflowAction action = index < BackpressurePolicy::K_LEVELS
+                              ? overflow_actions_[index].load(std::memory_order_relaxed)
+                              : OverflowAction::DROP_NEWEST;
+  if (action == OverflowAction::DROP_NEWEST || !CanWait())
+  {
+    backpressure_.dropped_newest.fetch_add(1, std::memory_order_relaxed);
+    CountLaneDrop(level);
+    return Reservation{};
+  }
+
+  const bool drop_oldest = action == OverflowAction::DROP_OLDEST;
+  const bool bounded = action != OverflowAction::BLOCK;
+  (bounded ? backpressure_.bounded_waits : backpressure_.blocks)
+      .fetch_add(1, std::memory_order_relaxed);
+  const uint32_t spins = spin_count_.load(std::memory_order_relaxed);
+  const uint64_t timeout_ns = wait_timeout_ns_.load(std::memory_order_relaxed);
+  const uint64_t start = monotonic_now_ns();
+  uint32_t requested = 0;
+  Reservation reservation{};
+  for (;;)
+  {
+    if (drop_oldest)
+    {
+      // 每轮请求消费者丢弃一条最旧的记录，直到放得下为止
+      discard_requests_.fetch_add(1, std::memory_order_relaxed);
+      ++requested;
+    }
+    for (uint32_t i = 0; i < spins && !reservation; ++i)
+    {
+      cpu_relax();
+      reservation = TryReserve(size, level);
+    }
+    if (reservation || !running_.load(std::memory_order_relaxed))
+    {
+      break;
+    }
+    uint64_t elapsed = monotonic_now_ns() - start;
+    if (bounded && elapsed >= timeout_ns)
+    {
+      break;
+    }
+    // 先登记为等待者再检查一次，避免错过消费者在两者之间发出的唤醒
+    uint32_t seq = space_seq_.load(std::memory_order_acquire);
+    space_waiters_.fetch_add(1, std::memory_order_seq_cst);
+    reservation = TryReserve(size, level);
+    if (!reservation)
+    {
+      futex_wait(space_seq_, seq, bounded ? timeout_ns - elapsed : 0);
+    }
+    space_waiters_.fetch_sub(1, std::memory_order_relaxed);
+    if (reservation)
+    {
+      break;
+    }
+  }
+
+  // 撤回尚未被消费者处理的丢弃请求，避免之后误删记录
+  uint32_t pending = discard_requests_.load(std::memory_order_relaxed);
+  while (requested > 0 && pending > 0)
+  {
+    if (discard_requests_.compare_exchange_weak(pending, pending - 1,
+                                                std::memory_order_relaxed))
+    {
+      --requested;
+    }
+  }
+
+  backpressure_.wait_ns.fetch_add(monotonic_now_ns() - start, std::memory_order_relaxed);
+  if (!reservation)
+  {
+    (running_.load(std::memory_order_relaxed) ? backpressure_.wait_timeouts
+                                              : backpressure_.dropped_newest)
+        .fetch_add(1, std::memory_order_relaxed);
+    CountLaneDrop(level);
+  }
+  return reservation;
+}
+
+void LoggerBackend::SetOverflowCapacity(size_t capacity_bytes)
+{
+  overflow_.Configure(capacity_bytes);
+  overflow_active_.store(false, std::memory_order_relaxed);
+}
+
+OverflowStats LoggerBackend::GetOverflowStats() const { return overflow_.Stats(); }
+
+LoggerBackend::Reservation LoggerBackend::Spill(uint32_t size)
+{
+  overflow_active_.store(true, std::memory_order_relaxed);
+  return overflow_.TryReserve(size);
+}
+
+void LoggerBackend::CountLaneDrop(LogLevel level)
+{
+  QueueLane lane = level >= K_PRIORITY_LEVEL ? QueueLane::PRIORITY : QueueLane::NORMAL;
+  lane_drops_[static_cast<int>(lane)].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t LoggerBackend::LaneDropCount(QueueLane lane) const
+{
+  return lane_drops_[static_cast<int>(lane)].load(std::memory_order_relaxed);
+}
+
+bool LoggerBackend::TakeDiscardRequest()
+{
+  // 只有消费者递减，读到非零后 fetch_sub 不会下溢；生产者撤回使用 CAS
+  uint32_t pending = discard_requests_.load(std::memory_order_relaxed);
+  while (pending > 0)
+  {
+    if (discard_requests_.compare_exchange_weak(pending, pending - 1,
+                                                std::memory_order_relaxed))
+    {
+      backpressure_.dropped_oldest.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void LoggerBackend::NotifySpace()
+{
+  // 与生产者登记等待者后的再次检查配对：归还空间的写入先于读取等待者数
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (space_waiters_.load(std::memory_order_relaxed) > 0)
+  {
+    space_seq_.fetch_add(1, std::memory_order_release);
+    futex_wake_all(space_seq_);
+  }
+}
+
+void LoggerBackend::SetClockSource(ClockSource source)
+{
+  if (!clock_source_available(source))
+  {
+    source = ClockSource::PRECISE;
+  }
+  clock_source_.store(source, std::memory_order_release);
+}
+
+ClockSource LoggerBackend::GetClockSource() const
+{
+  return clock_source_.load(std::memory_order_relaxed);
+}
+
+void LoggerBackend::SetQueueTopology(QueueTopology topology)
+{
+  if (topology == QueueTopology::PER_CPU_RSEQ)
+  {
+    if (!PerCpuRing::Available())
+    {
+      topology = QueueTopology::SHARED_MPSC;
+    }
+    else if (!percpu_)
+    {
+      percpu_ = std::make_unique<PerCpuRing>();
+    }
+  }
+  topology_.store(topology, std::memory_order_relaxed);
+}
+
+QueueTopology LoggerBackend::GetQueueTopology() const
+{
+  return topology_.load(std::memory_order_relaxed);
+}
 
-void LoggerBackend::AddSink(std::unique_ptr<ILogSink> sink)
+size_t LoggerBackend::ThreadQueueCount() const
 {
+  std::lock_guard<std::mutex> lock(queues_mutex_);
+  return queues_.size();
+}
+
+LoggerBackend::ThreadQueue& LoggerBackend::LocalQueue()
+{
+  // 线程退出时把本线程的所有队列标记为 retired，由消费者取完后回收；
+  // 队列由 shared_ptr 共同持有，backend 与线程谁先销毁都是安全的
+  struct Registry
+  {
+    struct Slot
+    {
+      uint64_t backend_id;
+      std::shared_ptr<ThreadQueue> queue;
+    };
+    std::vector<Slot> slots;
+    uint64_t last_id = 0;
+    ThreadQueue* last_queue = nullptr;
+
+    ~Registry()
+    {
+      for (auto& slot : slots)
+      {
+        slot.queue->retired.store(true, std::memory_order_release);
+      }
+    }
+  };
+  static thread_local Registry registry;
+
+  if (registry.last_id == id_)
+  {
+    return *registry.last_queue;
+  }
+  auto it = std::find_if(registry.slots.begin(), registry.slots.end(),
+                         [this](const Registry::Slot& slot) { return slot.backend_id == id_; });
+  if (it == registry.slots.end())
+  {
+    auto queue = std::make_shared<ThreadQueue>();
+    {
+      std::lock_guard<std::mutex> lock(queues_mutex_);
+      queues_.push_back(queue);
+    }
+    queues_generation_.fetch_add(1, std::memory_order_release);
+    registry.slots.push_back(Registry::Slot{id_, std::move(queue)});
+    it = registry.slots.end() - 1;
+  }
+  registry.last_id = id_;
+  registry.last_queue = it->queue.get();
+  return *registry.last_queue;
+}
+
+void LoggerBackend::RefreshThreadQueues()
+{
+  uint64_t generation = queues_generation_.load(std::memory_order_acquire);
+  if (generation == active_generation_)
+  {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(queues_mutex_);
+  active_queues_ = queues_;
+  active_generation_ = generation;
+}
+
+void LoggerBackend::ReapThreadQueues()
+{
+  bool reaped = false;
+  for (auto& queue : active_queues_)
+  {
+    // 先确认线程已退出再检查是否为空，之后不会再有新的记录
+    if (queue->retired.load(std::memory_order_acquire) && queue->ring.Empty())
+    {
+      std::lock_guard<std::mutex> lock(queues_mutex_);
+      queues_.erase(std::remove(queues_.begin(), queues_.end(), queue), queues_.end());
+      reaped = true;
+    }
+  }
+  if (reaped)
+  {
+    queues_generation_.fetch_add(1, std::memory_order_release);
+  }
+}
+
+void LoggerBackend::SetIdleStrategy(IdleStrategy strategy)
+{
+  idle_strategy_.store(strategy, std::memory_order_relaxed);
+#if BR_LOG_HAS_THREAD
+  WakeWorker();  // 正在睡眠的后端按新策略重新等待
+#endif
+}
+
+IdleStrategy LoggerBackend::GetIdleStrategy() const
+{
+  return idle_strategy_.load(std::memory_order_relaxed);
+}
+
+void LoggerBackend::AddSink(std::unique_ptr<ILogSink> sink, uint32_t shard)
+{
+  local_sinks_.push_back(sink.get());
   sinks_.push_back(std::move(sink));
+  sink_shards_.push_back(shard);
 }
 
 void LoggerBackend::Start()
+{
+  BackendOptions options;
+  options.idle_strategy = GetIdleStrategy();
+  Start(options);
+}
+
+AppliedBackendOptions LoggerBackend::Start(const BackendOptions& options)
 {
   if (running_.load(std::memory_order_relaxed))
   {
-    return;
+    return applied_options_;
   }
+  idle_strategy_.store(options.idle_strategy, std::memory_order_relaxed);
+  idle_spin_ = options.spin_iterations;
+  idle_yield_ = options.yield_iterations;
+  idle_sleep_ns_ = options.sleep_ns;
+  applied_options_ = AppliedBackendOptions{};
+  applied_options_.idle_strategy = options.idle_strategy;
   running_.store(true, std::memory_order_relaxed);
 #if BR_LOG_HAS_THREAD
+  StartShards(options);
   worker_ = std::thread(&LoggerBackend::WorkerLoop, this);
+  apply_thread_options(worker_, options, applied_options_);
 #endif
+  return applied_options_;
+}
+
+AppliedBackendOptions LoggerBackend::GetAppliedOptions() const
+{
+  AppliedBackendOptions applied = applied_options_;
+  applied.idle_strategy = GetIdleStrategy();
+  return applied;
 }
 
 void LoggerBackend::Stop()
 {
   running_.store(false, std::memory_order_relaxed);
+  // 唤醒仍在等待空间的生产者，它们看到 running_ 为 false 后放弃
+  space_seq_.fetch_add(1, std::memory_order_release);
+  futex_wake_all(space_seq_);
 #if BR_LOG_HAS_THREAD
+  worker_sleeping_.store(false, std::memory_order_relaxed);
+  worker_seq_.fetch_add(1, std::memory_order_release);
+  futex_wake_all(worker_seq_);
   if (worker_.joinable())
   {
     worker_.join();
   }
+  StopShards();
 #endif
   while (Drain(64) > 0)
   {
@@ -49,28 +478,483 @@ void LoggerBackend::Stop()
 }
 
 size_t LoggerBackend::Drain(size_t max_entries)
+{
+  clock_.MaybeRefresh();
+  RefreshThreadQueues();
+  if (!active_queues_.empty() || percpu_)
+  {
+    return DrainMerged(max_entries);
+  }
+
+  // 共享队列按批读取：解码后先不归还，攒满一批或本次结束时一次性归还再分发
+  size_t count = 0;
+  uint32_t size = 0;
+  uint32_t cursor = ring_.ReadCursor();
+  while (count < max_entries)
+  {
+    if (DrainPriority())
+    {
+      ++count;
+    }
+    else
+    {
+      // 溢出链中的记录晚于溢出前写入主队列的记录，但链写满后退回主队列的记录又晚于链中的记录：
+      // 链非空时比较两者队首，取更早的一条，相同时先取主队列
+      uint32_t next = cursor;
+      const uint8_t* record = ring_.PeekNext(next, size);
+      const uint8_t* spilled = nullptr;
+      if (record == nullptr || overflow_active_.load(std::memory_order_relaxed))
+      {
+        uint32_t spilled_size = 0;
+        spilled = PeekOverflow(spilled_size);
+      }
+      bool from_overflow =
+          spilled != nullptr &&
+          (record == nullptr || key_before(merge_key(spilled, clock_), merge_key(record, clock_)));
+      if (from_overflow)
+      {
+        record = spilled;
+      }
+      else if (record != nullptr)
+      {
+        cursor = next;
+      }
+      else
+      {
+        break;
+      }
+      ++count;
+      if (!TakeDiscardRequest())
+      {
+        Decode(record);
+      }
+      if (from_overflow)
+      {
+        overflow_.Release();
+      }
+    }
+    if (BatchFull())
+    {
+      ring_.ReleaseTo(cursor);
+      DispatchBatch();
+    }
+  }
+  ring_.ReleaseTo(cursor);
+  DispatchBatch();
+  if (count > 0)
+  {
+    NotifySpace();
+  }
+  if (count < max_entries)
+  {
+    NotifyIdle();
+  }
+  return count;
+}
+
+// 多路归并：共享队列、各线程队列、各 CPU 队列与溢出链的队首按 (单调纳秒, sequence_id) 取最小者。
+// 只比较当前可见的队首：堆中只有非空队列，空队列在堆取空或每分发一批后才重新检查，
+// 稍后才提交的更早记录无法被重新排到前面
+size_t LoggerBackend::DrainMerged(size_t max_entries)
 {
   size_t count = 0;
-  LogEntry entry{};
-  while (count < max_entries && ring_.TryPop(entry))
+  merge_heap_.clear();
+  merge_queued_.assign(2 + active_queues_.size() + (percpu_ ? percpu_->CpuCount() : 0), 0);
+  RefillMergeHeap();
+  while (count < max_entries)
   {
-    Dispatch(entry);
+    if (DrainPriority())
+    {
+      ++count;
+      if (BatchFull())
+      {
+        DispatchBatch();
+      }
+      continue;
+    }
+    if (merge_heap_.empty())
+    {
+      RefillMergeHeap();
+    }
+    if (merge_heap_.empty())
+    {
+      break;
+    }
+    std::pop_heap(merge_heap_.begin(), merge_heap_.end(), MergeAfter);
+    MergeHead head = merge_heap_.back();
+    merge_heap_.pop_back();
+    merge_queued_[head.source] = 0;
+    // DROP_OLDEST 的请求丢弃全局最旧的记录，不一定来自请求者自己的队列
+    if (!TakeDiscardRequest())
+    {
+      Decode(head.data);
+    }
+    ReleaseSource(head.source);
+    PushMergeHead(head.source);
     ++count;
+    if (BatchFull())
+    {
+      DispatchBatch();
+      RefillMergeHeap();
+    }
   }
+  DispatchBatch();
+  if (count > 0)
+  {
+    NotifySpace();
+  }
+  if (count < max_entries)
+  {
+    NotifyIdle();
+  }
+  ReapThreadQueues();
   return count;
 }
 
-void LoggerBackend::Dispatch(const LogEntry& entry)
+bool LoggerBackend::MergeAfter(const MergeHead& a, const MergeHead& b)
 {
-  for (auto& sink : sinks_)
+  if (a.mono_ns != b.mono_ns)
+  {
+    return a.mono_ns > b.mono_ns;
+  }
+  if (a.sequence_id != b.sequence_id)
+  {
+    return a.sequence_id > b.sequence_id;
+  }
+  return a.source > b.source;  // 相同时按队列下标，溢出链排在最后
+}
+
+const uint8_t* LoggerBackend::PeekSource(size_t source, uint32_t& size)
+{
+  if (source == 0)
+  {
+    return ring_.Peek(size);
+  }
+  if (source <= active_queues_.size())
+  {
+    return active_queues_[source - 1]->ring.Peek(size);
+  }
+  if (source == merge_queued_.size() - 1)
+  {
+    return PeekOverflow(size);
+  }
+  return (*percpu_)[source - 1 - active_queues_.size()].Peek(size);
+}
+
+void LoggerBackend::ReleaseSource(size_t source)
+{
+  if (source == 0)
+  {
+    ring_.Release();
+  }
+  else if (source <= active_queues_.size())
+  {
+    active_queues_[source - 1]->ring.Release();
+  }
+  else if (source == merge_queued_.size() - 1)
+  {
+    overflow_.Release();
+  }
+  else
+  {
+    (*percpu_)[source - 1 - active_queues_.size()].Release();
+  }
+}
+
+void LoggerBackend::PushMergeHead(size_t source)
+{
+  uint32_t size = 0;
+  const uint8_t* data = PeekSource(source, size);
+  if (data == nullptr)
+  {
+    return;
+  }
+  MergeKey key = merge_key(data, clock_);
+  merge_heap_.push_back(MergeHead{key.mono_ns, key.sequence_id, data, source});
+  merge_queued_[source] = 1;
+  std::push_heap(merge_heap_.begin(), merge_heap_.end(), MergeAfter);
+}
+
+void LoggerBackend::RefillMergeHeap()
+{
+  for (size_t source = 0; source < merge_queued_.size(); ++source)
+  {
+    if (merge_queued_[source] == 0)
+    {
+      PushMergeHead(source);
+    }
+  }
+}
+
+const uint8_t* LoggerBackend::PeekOverflow(uint32_t& size)
+{
+  if (!overflow_.Enabled())
+  {
+    return nullptr;
+  }
+  const uint8_t* record = overflow_.Peek(size);
+  if (record == nullptr && overflow_active_.load(std::memory_order_relaxed))
+  {
+    // 链已取空：之后的记录回到普通队列。清除前正在写入链的记录仍会在之后被取走
+    overflow_active_.store(false, std::memory_order_relaxed);
+  }
+  return record;
+}
+
+bool LoggerBackend::DrainPriority()
+{
+  uint32_t size = 0;
+  const uint8_t* record = priority_ring_.Peek(size);
+  if (record == nullptr)
+  {
+    return false;
+  }
+  Decode(record);
+  priority_ring_.Release();
+  return true;
+}
+
+void LoggerBackend::DispatchBatch()
+{
+  if (batch_size_ == 0)
+  {
+    return;
+  }
+#if BR_LOG_HAS_THREAD
+  uint32_t seq = published_.load(std::memory_order_relaxed);
+  if (sharded_)
+  {
+    // 先发布给其他分片，再写本线程的 Sink，各分片并行处理同一批
+    slot_sizes_[seq % BR_LOG_SHARD_BATCHES] = static_cast<uint32_t>(batch_size_);
+    published_.store(seq + 1, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (shard_sleepers_.load(std::memory_order_relaxed) > 0)
+    {
+      shard_seq_.fetch_add(1, std::memory_order_release);
+      futex_wake_all(shard_seq_);
+    }
+  }
+#endif
+  for (ILogSink* sink : local_sinks_)
+  {
+    sink->WriteBatch(batch_, batch_size_);
+  }
+#if BR_LOG_HAS_THREAD
+  if (sharded_)
+  {
+    batch_ = SlotEntries(seq + 1);
+  }
+#endif
+  batch_size_ = 0;
+  dispatched_since_idle_ = true;
+}
+
+void LoggerBackend::NotifyIdle()
+{
+  if (!dispatched_since_idle_)
+  {
+    return;
+  }
+  dispatched_since_idle_ = false;
+  for (ILogSink* sink : local_sinks_)
   {
-    sink->Write(entry);
+    sink->OnIdle();
   }
 }
 
+void LoggerBackend::AcquireSlot()
+{
+#if BR_LOG_HAS_THREAD
+  uint32_t seq = published_.load(std::memory_order_relaxed);
+  while (!SlotFree(seq))
+  {
+    // 登记等待后再检查一次，避免错过分片在两者之间推进进度
+    uint32_t progress = progress_seq_.load(std::memory_order_acquire);
+    dispatcher_waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (SlotFree(seq))
+    {
+      dispatcher_waiting_.store(false, std::memory_order_relaxed);
+      return;
+    }
+    futex_wait(progress_seq_, progress, 0);
+  }
+#endif
+}
+
 #if BR_LOG_HAS_THREAD
+void LoggerBackend::WakeWorker()
+{
+  if (worker_sleeping_.exchange(false, std::memory_order_relaxed))
+  {
+    worker_seq_.fetch_add(1, std::memory_order_release);
+    futex_wake_all(worker_seq_);
+  }
+}
+
+// 登记睡眠后再取一次，避免错过登记之前刚提交、未看到睡眠标志的记录
+void LoggerBackend::Park()
+{
+  uint32_t seq = worker_seq_.load(std::memory_order_acquire);
+  worker_sleeping_.store(true, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (Drain(64) > 0 || !running_.load(std::memory_order_relaxed) ||
+      idle_strategy_.load(std::memory_order_relaxed) != IdleStrategy::BLOCKING)
+  {
+    worker_sleeping_.store(false, std::memory_order_relaxed);
+    return;
+  }
+  futex_wait(worker_seq_, seq, 0);
+  worker_sleeping_.store(false, std::memory_order_relaxed);
+}
+
+bool LoggerBackend::SlotFree(uint32_t seq) const
+{
+  for (const auto& shard : shards_)
+  {
+    if (seq - shard->consumed.load(std::memory_order_acquire) >= BR_LOG_SHARD_BATCHES)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void LoggerBackend::StartShards(const BackendOptions& options)
+{
+  uint32_t workers = options.worker_count > 0 ? options.worker_count : 1;
+  std::vector<std::vector<ILogSink*>> groups(workers);
+  for (size_t i = 0; i < sinks_.size(); ++i)
+  {
+    uint32_t shard = sink_shards_[i] == K_AUTO_SHARD ? static_cast<uint32_t>(i) : sink_shards_[i];
+    groups[shard % workers].push_back(sinks_[i].get());
+  }
+  local_sinks_ = groups[0];
+  for (uint32_t i = 1; i < workers; ++i)
+  {
+    if (groups[i].empty())
+    {
+      continue;
+    }
+    auto shard = std::make_unique<Shard>();
+    shard->sinks = std::move(groups[i]);
+    shards_.push_back(std::move(shard));
+  }
+  applied_options_.worker_count = static_cast<uint32_t>(shards_.size()) + 1;
+  if (shards_.empty())
+  {
+    return;
+  }
+
+  batch_storage_.reset(new LogEntry[BR_LOG_DISPATCH_BATCH * BR_LOG_SHARD_BATCHES]);
+  published_.store(0, std::memory_order_relaxed);
+  batch_ = SlotEntries(0);
+  sharded_ = true;
+  shards_running_.store(true, std::memory_order_relaxed);
+  BackendOptions shard_options = options;
+  char name[40];  // 容纳完整的 "%.12s/%zu"，设置线程名时再截断到 15 字节
+  for (size_t i = 0; i < shards_.size(); ++i)
+  {
+    Shard* shard = shards_[i].get();
+    shard->thread = std::thread(&LoggerBackend::ShardLoop, this, shard);
+    if (options.thread_name != nullptr)
+    {
+      std::snprintf(name, sizeof(name), "%.12s/%zu", options.thread_name, i + 1);
+      shard_options.thread_name = name;
+    }
+    AppliedBackendOptions ignored;
+    apply_thread_options(shard->thread, shard_options, ignored);
+  }
+}
+
+// 须在取队列的线程退出后调用：此时已发布的批数不再变化，分片线程读完后退出
+void LoggerBackend::StopShards()
+{
+  if (shards_.empty())
+  {
+    return;
+  }
+  shards_running_.store(false, std::memory_order_release);
+  shard_seq_.fetch_add(1, std::memory_order_release);
+  futex_wake_all(shard_seq_);
+  for (auto& shard : shards_)
+  {
+    shard->thread.join();
+  }
+  shards_.clear();
+  sharded_ = false;
+  local_sinks_.clear();
+  for (auto& sink : sinks_)
+  {
+    local_sinks_.push_back(sink.get());
+  }
+  batch_ = batch_storage_.get();
+}
+
+void LoggerBackend::ShardLoop(Shard* shard)
+{
+  tls_backend_worker = true;
+  bool dispatched = false;
+  for (;;)
+  {
+    uint32_t next = shard->consumed.load(std::memory_order_relaxed);
+    if (next != published_.load(std::memory_order_acquire))
+    {
+      LogEntry* entries = SlotEntries(next);
+      size_t count = slot_sizes_[next % BR_LOG_SHARD_BATCHES];
+      for (ILogSink* sink : shard->sinks)
+      {
+        sink->WriteBatch(entries, count);
+      }
+      shard->consumed.store(next + 1, std::memory_order_release);
+      // 与后端线程登记等待后的再次检查配对
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (dispatcher_waiting_.load(std::memory_order_relaxed) &&
+          dispatcher_waiting_.exchange(false, std::memory_order_relaxed))
+      {
+        progress_seq_.fetch_add(1, std::memory_order_release);
+        futex_wake_all(progress_seq_);
+      }
+      dispatched = true;
+      continue;
+    }
+    if (dispatched)
+    {
+      for (ILogSink* sink : shard->sinks)
+      {
+        sink->OnIdle();
+      }
+      dispatched = false;
+      continue;
+    }
+    if (!shards_running_.load(std::memory_order_acquire))
+    {
+      // 停止前发布的批此时都已可见
+      if (next == published_.load(std::memory_order_acquire))
+      {
+        break;
+      }
+      continue;
+    }
+    if (idle_strategy_.load(std::memory_order_relaxed) == IdleStrategy::BUSY_SPIN)
+    {
+      cpu_relax();
+      continue;
+    }
+    uint32_t seq = shard_seq_.load(std::memory_order_acquire);
+    shard_sleepers_.fetch_add(1, std::memory_order_seq_cst);
+    if (next == published_.load(std::memory_order_relaxed) &&
+        shards_running_.load(std::memory_order_relaxed))
+    {
+      futex_wait(shard_seq_, seq, 0);
+    }
+    shard_sleepers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
 void LoggerBackend::WorkerLoop()
 {
+  tls_backend_worker = true;
   uint32_t idle_count = 0;
   while (running_.load(std::memory_order_relaxed))
   {
@@ -78,22 +962,27 @@ void LoggerBackend::WorkerLoop()
     if (drained > 0)
     {
       idle_count = 0;
+      continue;
     }
-    else
+    IdleStrategy strategy = idle_strategy_.load(std::memory_order_relaxed);
+    if (strategy == IdleStrategy::BUSY_SPIN || idle_count < idle_spin_)
     {
       ++idle_count;
-      if (idle_count < 100)
-      {
-        // busy spin
-      }
-      else if (idle_count < 1000)
-      {
-        std::this_thread::yield();
-      }
-      else
-      {
-        std::this_thread::sleep_for(std::chrono::microseconds(100));
-      }
+      cpu_relax();
+    }
+    else if (strategy == IdleStrategy::BLOCKING)
+    {
+      Park();
+      idle_count = 0;
+    }
+    else if (idle_count - idle_spin_ < idle_yield_)
+    {
+      ++idle_count;
+      std::this_thread::yield();
+    }
+    else
+    {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(idle_sleep_ns_));
     }
   }
   while (Drain(64) > 0)
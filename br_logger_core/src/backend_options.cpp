@@ -0,0 +1,79 @@
+#include "br_logger/backend_options.hpp"
+
+#if BR_LOG_HAS_THREAD && defined(BR_LOG_PLATFORM_LINUX)
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstring>
+#endif
+
+namespace br_logger
+{
+
+#if BR_LOG_HAS_THREAD
+
+#if defined(BR_LOG_PLATFORM_LINUX)
+
+namespace
+{
+
+bool set_affinity(pthread_t handle, const std::vector<int>& cpus)
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus)
+  {
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+    {
+      return false;
+    }
+    CPU_SET(cpu, &set);
+  }
+  return pthread_setaffinity_np(handle, sizeof(set), &set) == 0;
+}
+
+bool set_sched_class(pthread_t handle, SchedClass sched_class)
+{
+  int policy = sched_class == SchedClass::IDLE ? SCHED_IDLE : SCHED_BATCH;
+  sched_param param{};
+  param.sched_priority = 0;
+  return pthread_setschedparam(handle, policy, &param) == 0;
+}
+
+bool set_name(pthread_t handle, const char* name)
+{
+  char truncated[16];
+  std::strncpy(truncated, name, sizeof(truncated) - 1);
+  truncated[sizeof(truncated) - 1] = '\0';
+  return pthread_setname_np(handle, truncated) == 0;
+}
+
+}  // namespace
+
+void apply_thread_options(std::thread& thread, const BackendOptions& options,
+                          AppliedBackendOptions& applied)
+{
+  pthread_t handle = thread.native_handle();
+  if (!options.cpu_affinity.empty())
+  {
+    applied.affinity_applied = set_affinity(handle, options.cpu_affinity);
+  }
+  if (options.sched_class != SchedClass::DEFAULT)
+  {
+    applied.sched_class_applied = set_sched_class(handle, options.sched_class);
+  }
+  if (options.thread_name != nullptr)
+  {
+    applied.thread_name_applied = set_name(handle, options.thread_name);
+  }
+}
+
+#else
+
+void apply_thread_options(std::thread&, const BackendOptions&, AppliedBackendOptions&) {}
+
+#endif
+
+#endif
+
+}  // namespace br_logger
@@ -0,0 +1,201 @@
+#include "br_logger/clock_source.hpp"
+
+#include <atomic>
+#include <mutex>
+
+#if BR_LOG_HAS_TSC
+#include <cpuid.h>
+#endif
+
+namespace br_logger
+{
+
+namespace
+{
+
+#if BR_LOG_HAS_TSC
+
+struct TscCalibration
+{
+  bool valid = false;
+  uint64_t tsc0 = 0;
+  uint64_t mono0 = 0;
+  uint64_t mult = 0;  // 每个 tick 的纳秒数 << 32
+};
+
+bool has_invariant_tsc()
+{
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (__get_cpuid(0x80000000u, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007u)
+  {
+    return false;
+  }
+  __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx);
+  return (edx & (1u << 8)) != 0;
+}
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef __int128 Int128;
+__extension__ typedef unsigned __int128 UInt128;
+#endif
+
+uint64_t tsc_mult(uint64_t ticks, uint64_t ns)
+{
+  if (ticks == 0)
+  {
+    return 0;
+  }
+#if defined(__SIZEOF_INT128__)
+  return static_cast<uint64_t>((static_cast<UInt128>(ns) << 32) / ticks);
+#else
+  return static_cast<uint64_t>(static_cast<long double>(ns) * 4294967296.0L /
+                               static_cast<long double>(ticks));
+#endif
+}
+
+// (delta * mult) >> 32，结果向负无穷取整
+int64_t mul_shift(int64_t delta, uint64_t mult)
+{
+#if defined(__SIZEOF_INT128__)
+  return static_cast<int64_t>((static_cast<Int128>(delta) * static_cast<Int128>(mult)) >> 32);
+#else
+  // 按 32 位拆分做 64x64 乘法，只保留右移后的部分
+  uint64_t mag = delta < 0 ? 0 - static_cast<uint64_t>(delta) : static_cast<uint64_t>(delta);
+  uint64_t mag_hi = mag >> 32, mag_lo = mag & 0xFFFFFFFFULL;
+  uint64_t mult_hi = mult >> 32, mult_lo = mult & 0xFFFFFFFFULL;
+  uint64_t low = mag_lo * mult_lo;
+  uint64_t q = ((mag_hi * mult_hi) << 32) + mag_hi * mult_lo + mag_lo * mult_hi + (low >> 32);
+  if (delta >= 0)
+  {
+    return static_cast<int64_t>(q);
+  }
+  return -static_cast<int64_t>(q) - ((low & 0xFFFFFFFFULL) != 0 ? 1 : 0);
+#endif
+}
+
+// 标定完成后才发布，后端据此判断能否换算 TSC 记录且不会主动触发标定
+std::atomic<const TscCalibration*> g_tsc_ready{nullptr};
+
+// 启动标定：在约 10ms 的窗口内同时读取 TSC 与 CLOCK_MONOTONIC_RAW，
+// 起点保存下来供之后的刷新使用更长的基线
+const TscCalibration& tsc_calibration()
+{
+  static TscCalibration calib;
+  static std::once_flag once;
+  std::call_once(once,
+                 []()
+                 {
+                   if (!has_invariant_tsc())
+                   {
+                     return;
+                   }
+                   calib.tsc0 = __rdtsc();
+                   calib.mono0 = monotonic_now_ns();
+                   uint64_t mono = calib.mono0;
+                   while (mono - calib.mono0 < 10'000'000ULL)
+                   {
+                     mono = monotonic_now_ns();
+                   }
+                   calib.mult = tsc_mult(__rdtsc() - calib.tsc0, mono - calib.mono0);
+                   calib.valid = calib.mult > 0;
+                   if (calib.valid)
+                   {
+                     g_tsc_ready.store(&calib, std::memory_order_release);
+                   }
+                 });
+  return calib;
+}
+
+#endif
+
+}  // namespace
+
+bool clock_source_available(ClockSource source)
+{
+  switch (source)
+  {
+    case ClockSource::PRECISE:
+      return true;
+    case ClockSource::COARSE:
+#if defined(BR_LOG_PLATFORM_LINUX) && !BR_LOG_EMBEDDED
+      return true;
+#else
+      return false;
+#endif
+    case ClockSource::TSC:
+#if BR_LOG_HAS_TSC
+      return tsc_calibration().valid;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+ClockConverter::ClockConverter() { Refresh(); }
+
+void ClockConverter::Convert(uint8_t clock, uint64_t ticks, uint64_t& mono_ns,
+                             uint64_t& wall_ns)
+{
+  switch (static_cast<ClockSource>(clock))
+  {
+    case ClockSource::COARSE:
+      mono_ns = ticks + static_cast<uint64_t>(coarse_to_raw_ns_);
+      break;
+    case ClockSource::TSC:
+    {
+      if (tsc_mult_ == 0)
+      {
+        // 运行中才切换到 TSC：首条 TSC 记录到达时补做一次标定
+        Refresh();
+      }
+      // 刷新前写入的记录 ticks 可能小于基点，按有符号差值换算
+      int64_t delta = static_cast<int64_t>(ticks - tsc_base_);
+#if BR_LOG_HAS_TSC
+      int64_t ns = mul_shift(delta, tsc_mult_);
+#else
+      int64_t ns = delta;
+#endif
+      mono_ns = tsc_mono_base_ + static_cast<uint64_t>(ns);
+      break;
+    }
+    default:
+      mono_ns = ticks;
+      break;
+  }
+  wall_ns = mono_ns + static_cast<uint64_t>(raw_to_wall_ns_);
+}
+
+void ClockConverter::MaybeRefresh()
+{
+  if (monotonic_now_ns() - last_refresh_ns_ >= K_REFRESH_INTERVAL_NS)
+  {
+    Refresh();
+  }
+}
+
+void ClockConverter::Refresh()
+{
+  uint64_t raw = monotonic_now_ns();
+  uint64_t wall = wall_clock_now_ns();
+  raw_to_wall_ns_ = static_cast<int64_t>(wall - raw);
+  coarse_to_raw_ns_ = static_cast<int64_t>(raw - read_clock(ClockSource::COARSE));
+  last_refresh_ns_ = raw;
+
+#if BR_LOG_HAS_TSC
+  // 只有选择过 TSC 才会完成标定，这里不主动触发 10ms 的标定等待
+  const TscCalibration* calib = g_tsc_ready.load(std::memory_order_acquire);
+  if (calib != nullptr)
+  {
+    uint64_t tsc = __rdtsc();
+    uint64_t mono = monotonic_now_ns();
+    tsc_mult_ = (mono - calib->mono0 > 100'000'000ULL)
+                    ? tsc_mult(tsc - calib->tsc0, mono - calib->mono0)
+                    : calib->mult;
+    tsc_base_ = tsc;
+    tsc_mono_base_ = mono;
+  }
+#endif
+}
+
+}  // namespace br_logger
@@ -1,10 +1,10 @@
 #include "../../include/br_logger/formatters/json_formatter.hpp"
 
-#include <cinttypes>
-#include <cstdio>
 #include <cstring>
 
+#include "../../include/br_logger/json_escape.hpp"
 #include "../../include/br_logger/log_level.hpp"
+#include "../../include/br_logger/number_format.hpp"
 #include "../../include/br_logger/timestamp.hpp"
 
 static size_t safe_append(char* buf, size_t buf_size, size_t pos, const char* src,
@@ -20,97 +20,74 @@ static size_t safe_append(char* buf, size_t buf_size, size_t pos, const char* sr
   return pos + n;
 }
 
-static size_t safe_append_str(char* buf, size_t buf_size, size_t pos, const char* s)
+namespace br_logger
 {
-  return safe_append(buf, buf_size, pos, s, std::strlen(s));
-}
 
-br_logger::JsonFormatter::JsonFormatter(bool pretty) : pretty_(pretty) {}
+namespace detail
+{
 
-size_t br_logger::JsonFormatter::EscapeJsonString(const char* src, size_t src_len,
-                                                  char* dst, size_t dst_size)
+// 各字段之前的常量片段（上一字段的收尾、键名与分隔符）按输出顺序预先拼好，Format 只按序写入
+enum JsonFragment : uint8_t
 {
-  if (dst_size == 0)
-  {
-    return 0;
-  }
-  size_t pos = 0;
-  const char* hex_digits = "0123456789ABCDEF";
-  for (size_t i = 0; i < src_len; ++i)
+  K_JSON_OPEN,     // {"ts":"
+  K_JSON_LEVEL,    // ","level":"
+  K_JSON_FILE,     // ","file":"
+  K_JSON_LINE,     // ","line":
+  K_JSON_FUNC,     // ,"func":"
+  K_JSON_TID,      // ","tid":
+  K_JSON_PID,      // ,"pid":
+  K_JSON_THREAD,   // ,"thread":"
+  K_JSON_SEQ,      // ","seq":
+  K_JSON_TAGS,     // ,"tags":{
+  K_JSON_TAG_SEP,  // ":"（标签键值之间）
+  K_JSON_MSG,      // },"msg":"
+  K_JSON_CLOSE,    // "}
+  K_JSON_FRAGMENT_COUNT
+};
+
+// 片段存成定宽槽，剩余空间足够时整槽复制（定长 memcpy，编译为几条 mov），再按实际长度前移
+constexpr size_t K_JSON_FRAGMENT_WIDTH = 24;
+
+struct JsonFragmentText
+{
+  char text[K_JSON_FRAGMENT_WIDTH] = {};
+  uint8_t len = 0;
+
+  constexpr JsonFragmentText(std::string_view fragment)
   {
-    unsigned char c = static_cast<unsigned char>(src[i]);
-    if (pos >= dst_size)
-    {
-      break;
-    }
-    switch (c)
+    for (size_t i = 0; i < fragment.size(); ++i)
     {
-      case '"':
-        if (pos + 2 > dst_size)
-        {
-          return pos;
-        }
-        dst[pos++] = '\\';
-        dst[pos++] = '"';
-        break;
-      case '\\':
-        if (pos + 2 > dst_size)
-        {
-          return pos;
-        }
-        dst[pos++] = '\\';
-        dst[pos++] = '\\';
-        break;
-      case '\n':
-        if (pos + 2 > dst_size)
-        {
-          return pos;
-        }
-        dst[pos++] = '\\';
-        dst[pos++] = 'n';
-        break;
-      case '\r':
-        if (pos + 2 > dst_size)
-        {
-          return pos;
-        }
-        dst[pos++] = '\\';
-        dst[pos++] = 'r';
-        break;
-      case '\t':
-        if (pos + 2 > dst_size)
-        {
-          return pos;
-        }
-        dst[pos++] = '\\';
-        dst[pos++] = 't';
-        break;
-      default:
-        if (c <= 0x1F)
-        {
-          if (pos + 6 > dst_size)
-          {
-            return pos;
-          }
-          dst[pos++] = '\\';
-          dst[pos++] = 'u';
-          dst[pos++] = hex_digits[(c >> 12) & 0x0F];
-          dst[pos++] = hex_digits[(c >> 8) & 0x0F];
-          dst[pos++] = hex_digits[(c >> 4) & 0x0F];
-          dst[pos++] = hex_digits[c & 0x0F];
-        }
-        else
-        {
-          if (pos + 1 > dst_size)
-          {
-            return pos;
-          }
-          dst[pos++] = static_cast<char>(c);
-        }
-        break;
+      text[i] = fragment[i];
     }
+    len = static_cast<uint8_t>(fragment.size());
   }
-  return pos;
+};
+
+struct JsonFragmentTable
+{
+  JsonFragmentText fragments[K_JSON_FRAGMENT_COUNT];
+};
+
+constexpr JsonFragmentTable K_COMPACT_FRAGMENTS{{
+    {"{\"ts\":\""},      {"\",\"level\":\""}, {"\",\"file\":\""}, {"\",\"line\":"},
+    {",\"func\":\""},    {"\",\"tid\":"},     {",\"pid\":"},       {",\"thread\":\""},
+    {"\",\"seq\":"},     {",\"tags\":{"},     {"\":\""},           {"},\"msg\":\""},
+    {"\"}"}}};
+
+constexpr JsonFragmentTable K_PRETTY_FRAGMENTS{{
+    {"{\n  \"ts\": \""},   {"\",\n  \"level\": \""}, {"\",\n  \"file\": \""},
+    {"\",\n  \"line\": "}, {",\n  \"func\": \""},    {"\",\n  \"tid\": "},
+    {",\n  \"pid\": "},    {",\n  \"thread\": \""},  {"\",\n  \"seq\": "},
+    {",\n  \"tags\": {"},  {"\": \""},               {"},\n  \"msg\": \""},
+    {"\"\n}"}}};
+
+}  // namespace detail
+
+}  // namespace br_logger
+
+br_logger::JsonFormatter::JsonFormatter(bool pretty)
+    : fragments_(pretty ? &detail::K_PRETTY_FRAGMENTS : &detail::K_COMPACT_FRAGMENTS)
+{
 }
 
 size_t br_logger::JsonFormatter::Format(const LogEntry& entry, char* buf, size_t buf_size)
@@ -120,153 +97,92 @@ size_t br_logger::JsonFormatter::Format(const LogEntry& entry, char* buf, size_t
     return 0;
   }
 
+  // 始终保持 pos <= buf_size - 1，末尾留给 '\0'
   size_t pos = 0;
-  char tmp[128];
+  const size_t limit = buf_size - 1;
+  char tmp[detail::K_MAX_INT_CHARS];
 
   auto append_escaped = [&](const char* src, size_t src_len)
+  { pos += detail::escape_json(src, src_len, buf + pos, limit - pos); };
+  auto append_fragment = [&](detail::JsonFragment fragment)
   {
-    if (pos >= buf_size - 1)
+    const detail::JsonFragmentText& text = fragments_->fragments[fragment];
+    if (limit - pos >= detail::K_JSON_FRAGMENT_WIDTH)
     {
-      return;
+      std::memcpy(buf + pos, text.text, detail::K_JSON_FRAGMENT_WIDTH);
+      pos += text.len;
     }
-    size_t avail = buf_size - 1 - pos;
-    size_t n = EscapeJsonString(src, src_len, buf + pos, avail);
-    if (n > avail)
+    else
     {
-      n = avail;
+      pos = safe_append(buf, buf_size, pos, text.text, text.len);
+    }
+  };
+  auto append_uint = [&](uint64_t value)
+  {
+    if (limit - pos >= detail::K_MAX_INT_CHARS)
+    {
+      pos += detail::format_uint(buf + pos, value);
+    }
+    else
+    {
+      pos = safe_append(buf, buf_size, pos, tmp, detail::format_uint(tmp, value));
     }
-    pos += n;
   };
 
-  const char* nl = pretty_ ? "\n" : "";
-  const char* ind = pretty_ ? "  " : "";
-  const char* sep = pretty_ ? ": " : ":";
-  const char* comma = pretty_ ? ",\n" : ",";
-
-  pos = safe_append(buf, buf_size, pos, "{", 1);
-  pos = safe_append_str(buf, buf_size, pos, nl);
-
-  pos = safe_append_str(buf, buf_size, pos, ind);
-  pos = safe_append(buf, buf_size, pos, "\"ts\"", 4);
-  pos = safe_append_str(buf, buf_size, pos, sep);
-  pos = safe_append(buf, buf_size, pos, "\"", 1);
-  size_t ts_len = format_timestamp(entry.wall_clock_ns, tmp, sizeof(tmp));
-  pos = safe_append(buf, buf_size, pos, tmp, ts_len);
-  pos = safe_append(buf, buf_size, pos, "\"", 1);
-  pos = safe_append_str(buf, buf_size, pos, comma);
+  append_fragment(detail::K_JSON_OPEN);
+  pos += format_timestamp(entry.wall_clock_ns, buf + pos, buf_size - pos);
 
-  pos = safe_append_str(buf, buf_size, pos, ind);
-  pos = safe_append(buf, buf_size, pos, "\"level\"", 7);
-  pos = safe_append_str(buf, buf_size, pos, sep);
-  pos = safe_append(buf, buf_size, pos, "\"", 1);
+  append_fragment(detail::K_JSON_LEVEL);
   auto level_sv = to_string(entry.level);
   pos = safe_append(buf, buf_size, pos, level_sv.data(), level_sv.size());
-  pos = safe_append(buf, buf_size, pos, "\"", 1);
-  pos = safe_append_str(buf, buf_size, pos, comma);
 
-  pos = safe_append_str(buf, buf_size, pos, ind);
-  pos = safe_append(buf, buf_size, pos, "\"file\"", 6);
-  pos = safe_append_str(buf, buf_size, pos, sep);
-  pos = safe_append(buf, buf_size, pos, "\"", 1);
-  if (entry.file_name)
+  append_fragment(detail::K_JSON_FILE);
+  const LogSite* site = entry.site;
+  if (site && site->file_name)
   {
-    append_escaped(entry.file_name, std::strlen(entry.file_name));
+    append_escaped(site->file_name, std::strlen(site->file_name));
   }
-  pos = safe_append(buf, buf_size, pos, "\"", 1);
-  pos = safe_append_str(buf, buf_size, pos, comma);
 
-  pos = safe_append_str(buf, buf_size, pos, ind);
-  pos = safe_append(buf, buf_size, pos, "\"line\"", 6);
-  pos = safe_append_str(buf, buf_size, pos, sep);
-  int line_n = snprintf(tmp, sizeof(tmp), "%u", entry.line);
-  if (line_n > 0)
-  {
-    pos = safe_append(buf, buf_size, pos, tmp, static_cast<size_t>(line_n));
-  }
-  pos = safe_append_str(buf, buf_size, pos, comma);
+  append_fragment(detail::K_JSON_LINE);
+  append_uint(site ? site->line : 0u);
 
-  pos = safe_append_str(buf, buf_size, pos, ind);
-  pos = safe_append(buf, buf_size, pos, "\"func\"", 6);
-  pos = safe_append_str(buf, buf_size, pos, sep);
-  pos = safe_append(buf, buf_size, pos, "\"", 1);
-  if (entry.function_name)
+  append_fragment(detail::K_JSON_FUNC);
+  if (site && site->function_name)
   {
-    append_escaped(entry.function_name, std::strlen(entry.function_name));
+    append_escaped(site->function_name, std::strlen(site->function_name));
   }
-  pos = safe_append(buf, buf_size, pos, "\"", 1);
-  pos = safe_append_str(buf, buf_size, pos, comma);
 
-  pos = safe_append_str(buf, buf_size, pos, ind);
-  pos = safe_append(buf, buf_size, pos, "\"tid\"", 5);
-  pos = safe_append_str(buf, buf_size, pos, sep);
-  int tid_n = snprintf(tmp, sizeof(tmp), "%u", entry.thread_id);
-  if (tid_n > 0)
-  {
-    pos = safe_append(buf, buf_size, pos, tmp, static_cast<size_t>(tid_n));
-  }
-  pos = safe_append_str(buf, buf_size, pos, comma);
+  append_fragment(detail::K_JSON_TID);
+  append_uint(entry.thread_id);
 
-  pos = safe_append_str(buf, buf_size, pos, ind);
-  pos = safe_append(buf, buf_size, pos, "\"pid\"", 5);
-  pos = safe_append_str(buf, buf_size, pos, sep);
-  int pid_n = snprintf(tmp, sizeof(tmp), "%u", entry.process_id);
-  if (pid_n > 0)
-  {
-    pos = safe_append(buf, buf_size, pos, tmp, static_cast<size_t>(pid_n));
-  }
-  pos = safe_append_str(buf, buf_size, pos, comma);
+  append_fragment(detail::K_JSON_PID);
+  append_uint(entry.process_id);
 
-  pos = safe_append_str(buf, buf_size, pos, ind);
-  pos = safe_append(buf, buf_size, pos, "\"thread\"", 8);
-  pos = safe_append_str(buf, buf_size, pos, sep);
-  pos = safe_append(buf, buf_size, pos, "\"", 1);
+  append_fragment(detail::K_JSON_THREAD);
   append_escaped(entry.thread_name, std::strlen(entry.thread_name));
-  pos = safe_append(buf, buf_size, pos, "\"", 1);
-  pos = safe_append_str(buf, buf_size, pos, comma);
 
-  pos = safe_append_str(buf, buf_size, pos, ind);
-  pos = safe_append(buf, buf_size, pos, "\"seq\"", 5);
-  pos = safe_append_str(buf, buf_size, pos, sep);
-  int seq_n = snprintf(tmp, sizeof(tmp), "%" PRIu64, entry.sequence_id);
-  if (seq_n > 0)
-  {
-    pos = safe_append(buf, buf_size, pos, tmp, static_cast<size_t>(seq_n));
-  }
-  pos = safe_append_str(buf, buf_size, pos, comma);
+  append_fragment(detail::K_JSON_SEQ);
+  append_uint(entry.sequence_id);
 
-  pos = safe_append_str(buf, buf_size, pos, ind);
-  pos = safe_append(buf, buf_size, pos, "\"tags\"", 6);
-  pos = safe_append_str(buf, buf_size, pos, sep);
-  pos = safe_append(buf, buf_size, pos, "{", 1);
+  append_fragment(detail::K_JSON_TAGS);
   if (entry.tag_count > 0)
   {
+    const auto& dict = TagDictionary::Instance();
     for (uint8_t t = 0; t < entry.tag_count; ++t)
     {
-      if (t > 0)
-      {
-        pos = safe_append(buf, buf_size, pos, ",", 1);
-      }
-      pos = safe_append(buf, buf_size, pos, "\"", 1);
-      append_escaped(entry.tags[t].key, std::strlen(entry.tags[t].key));
-      pos = safe_append(buf, buf_size, pos, "\"", 1);
-      pos = safe_append_str(buf, buf_size, pos, sep);
-      pos = safe_append(buf, buf_size, pos, "\"", 1);
-      append_escaped(entry.tags[t].value, std::strlen(entry.tags[t].value));
+      pos = safe_append(buf, buf_size, pos, t > 0 ? ",\"" : "\"", t > 0 ? 2 : 1);
+      std::string_view key = dict.Resolve(entry.tags[t].key);
+      append_escaped(key.data(), key.size());
+      append_fragment(detail::K_JSON_TAG_SEP);
+      std::string_view value = tag_value(entry, entry.tags[t]);
+      append_escaped(value.data(), value.size());
       pos = safe_append(buf, buf_size, pos, "\"", 1);
     }
   }
-  pos = safe_append(buf, buf_size, pos, "}", 1);
-  pos = safe_append_str(buf, buf_size, pos, comma);
 
-  pos = safe_append_str(buf, buf_size, pos, ind);
-  pos = safe_append(buf, buf_size, pos, "\"msg\"", 5);
-  pos = safe_append_str(buf, buf_size, pos, sep);
-  pos = safe_append(buf, buf_size, pos, "\"", 1);
+  append_fragment(detail::K_JSON_MSG);
   append_escaped(entry.msg, entry.msg_len);
-  pos = safe_append(buf, buf_size, pos, "\"", 1);
-  pos = safe_append_str(buf, buf_size, pos, nl);
-
-  pos = safe_append(buf, buf_size, pos, "}", 1);
+  append_fragment(detail::K_JSON_CLOSE);
 
   buf[pos] = '\0';
   return pos;
@@ -0,0 +1,64 @@
+#include "br_logger/futex.hpp"
+
+#include "br_logger/platform.hpp"
+
+#if defined(BR_LOG_PLATFORM_LINUX) && !BR_LOG_EMBEDDED
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <ctime>
+#elif BR_LOG_HAS_THREAD
+#include <chrono>
+#include <thread>
+#endif
+
+namespace br_logger
+{
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex word must be a plain 32-bit word");
+
+#if defined(BR_LOG_PLATFORM_LINUX) && !BR_LOG_EMBEDDED
+
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, uint64_t timeout_ns)
+{
+  struct timespec ts;
+  struct timespec* timeout = nullptr;
+  if (timeout_ns > 0)
+  {
+    ts.tv_sec = static_cast<time_t>(timeout_ns / 1'000'000'000ULL);
+    ts.tv_nsec = static_cast<long>(timeout_ns % 1'000'000'000ULL);
+    timeout = &ts;
+  }
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, timeout,
+          nullptr, 0);
+}
+
+void futex_wake_all(std::atomic<uint32_t>& word)
+{
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr,
+          nullptr, 0);
+}
+
+#else
+
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, uint64_t timeout_ns)
+{
+  if (word.load(std::memory_order_acquire) != expected)
+  {
+    return;
+  }
+#if BR_LOG_HAS_THREAD
+  uint64_t sleep_ns = (timeout_ns > 0 && timeout_ns < 100'000) ? timeout_ns : 100'000;
+  std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_ns));
+#else
+  (void)timeout_ns;
+#endif
+}
+
+void futex_wake_all(std::atomic<uint32_t>&) {}
+
+#endif
+
+}  // namespace br_logger
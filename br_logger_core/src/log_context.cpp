@@ -2,7 +2,6 @@
 
 #include <cstring>
 #include <mutex>
-#include <shared_mutex>
 
 #include "br_logger/platform.hpp"
 
@@ -23,6 +22,10 @@ namespace br_logger
 {
 
 thread_local FixedVector<LogTag, BR_LOG_MAX_TAGS> LogContext::tls_tags_{};
+thread_local std::string LogContext::tls_inline_values_[BR_LOG_MAX_TAGS];
+thread_local size_t LogContext::tls_inline_bytes_ = 0;
+thread_local std::shared_ptr<const GlobalTagSnapshot> LogContext::tls_global_snapshot_{};
+thread_local uint64_t LogContext::tls_global_generation_ = 0;
 thread_local char LogContext::tls_thread_name_[32] = {};
 thread_local uint32_t LogContext::tls_thread_id_ = 0;
 thread_local bool LogContext::tls_thread_id_cached_ = false;
@@ -33,48 +36,90 @@ LogContext& LogContext::Instance()
   return ctx;
 }
 
+LogContext::LogContext() : global_snapshot_(std::make_shared<const GlobalTagSnapshot>()) {}
+
+const GlobalTagSnapshot& LogContext::GlobalTags() const
+{
+  static const GlobalTagSnapshot empty{};
+  uint64_t generation = global_generation_.load(std::memory_order_relaxed);
+  if (generation != tls_global_generation_)
+  {
+    // 快照变化很少发生，此时才加锁取新快照；读到旧代数时继续使用旧快照
+    std::lock_guard<std::mutex> lock(global_mutex_);
+    tls_global_snapshot_ = global_snapshot_;
+    tls_global_generation_ = global_generation_.load(std::memory_order_relaxed);
+  }
+  return tls_global_snapshot_ ? *tls_global_snapshot_ : empty;
+}
+
+void LogContext::Publish(std::shared_ptr<const GlobalTagSnapshot> snapshot)
+{
+  global_snapshot_ = std::move(snapshot);
+  global_generation_.fetch_add(1, std::memory_order_relaxed);
+}
+
 void LogContext::SetGlobalTag(const char* key, const char* value)
 {
   if (!key || !value)
   {
     return;
   }
-  std::unique_lock<std::shared_mutex> lock(global_mutex_);
-  for (size_t i = 0; i < global_tags_.Size(); ++i)
+  auto& dict = TagDictionary::Instance();
+  LogTag tag{dict.Intern(key), K_INLINE_TAG_VALUE};
+  bool interned = dict.InternValue(value, tag.value);
+
+  std::lock_guard<std::mutex> lock(global_mutex_);
+  auto next = std::make_shared<GlobalTagSnapshot>(*global_snapshot_);
+  auto& tags = next->tags;
+  size_t i = 0;
+  while (i < tags.Size() && tags[i].key != tag.key)
   {
-    if (std::strncmp(global_tags_[i].key, key, BR_LOG_MAX_TAG_KEY_LEN) == 0)
-    {
-      std::strncpy(global_tags_[i].value, value, BR_LOG_MAX_TAG_VAL_LEN - 1);
-      global_tags_[i].value[BR_LOG_MAX_TAG_VAL_LEN - 1] = '\0';
-      return;
-    }
+    ++i;
   }
-
-  LogTag tag{};
-  std::strncpy(tag.key, key, BR_LOG_MAX_TAG_KEY_LEN - 1);
-  tag.key[BR_LOG_MAX_TAG_KEY_LEN - 1] = '\0';
-  std::strncpy(tag.value, value, BR_LOG_MAX_TAG_VAL_LEN - 1);
-  tag.value[BR_LOG_MAX_TAG_VAL_LEN - 1] = '\0';
-  global_tags_.PushBack(tag);
+  if (i == tags.Size() && !tags.PushBack(tag))
+  {
+    return;
+  }
+  tags[i].value = tag.value;
+  std::string& inline_value = next->inline_values[i];
+  next->inline_bytes -= inline_value.size();
+  if (interned)
+  {
+    inline_value.clear();
+  }
+  else
+  {
+    inline_value.assign(value);
+    next->inline_bytes += inline_value.size();
+  }
+  Publish(std::move(next));
 }
 
 void LogContext::RemoveGlobalTag(const char* key)
 {
-  if (!key)
+  TagId key_id = 0;
+  if (!key || !TagDictionary::Instance().Find(key, key_id))
   {
     return;
   }
-  std::unique_lock<std::shared_mutex> lock(global_mutex_);
-  for (size_t i = 0; i < global_tags_.Size(); ++i)
+  std::lock_guard<std::mutex> lock(global_mutex_);
+  const auto& current = global_snapshot_->tags;
+  for (size_t i = 0; i < current.Size(); ++i)
   {
-    if (std::strncmp(global_tags_[i].key, key, BR_LOG_MAX_TAG_KEY_LEN) == 0)
+    if (current[i].key == key_id)
     {
-      size_t last = global_tags_.Size() - 1;
+      auto next = std::make_shared<GlobalTagSnapshot>(*global_snapshot_);
+      auto& tags = next->tags;
+      size_t last = tags.Size() - 1;
+      next->inline_bytes -= next->inline_values[i].size();
       if (i != last)
       {
-        global_tags_[i] = global_tags_[last];
+        tags[i] = tags[last];
+        next->inline_values[i].swap(next->inline_values[last]);
       }
-      global_tags_.PopBack();
+      next->inline_values[last].clear();
+      tags.PopBack();
+      Publish(std::move(next));
       return;
     }
   }
@@ -143,63 +188,131 @@ void LogContext::PushScopedTag(const char* key, const char* value)
   {
     return;
   }
-  LogTag tag{};
-  std::strncpy(tag.key, key, BR_LOG_MAX_TAG_KEY_LEN - 1);
-  tag.key[BR_LOG_MAX_TAG_KEY_LEN - 1] = '\0';
-  std::strncpy(tag.value, value, BR_LOG_MAX_TAG_VAL_LEN - 1);
-  tag.value[BR_LOG_MAX_TAG_VAL_LEN - 1] = '\0';
-  tls_tags_.PushBack(tag);
+  PushScopedTagValue(TagDictionary::Instance().Intern(key), value);
+}
+
+void LogContext::PushScopedTag(TagId key, TagId value) { tls_tags_.PushBack(LogTag{key, value}); }
+
+void LogContext::PushScopedTagValue(TagId key, const char* value)
+{
+  TagId value_id = K_INLINE_TAG_VALUE;
+  if (TagDictionary::Instance().InternValue(value, value_id))
+  {
+    PushScopedTag(key, value_id);
+    return;
+  }
+  if (tls_tags_.PushBack(LogTag{key, K_INLINE_TAG_VALUE}))
+  {
+    std::string& inline_value = tls_inline_values_[tls_tags_.Size() - 1];
+    inline_value.assign(value);
+    tls_inline_bytes_ += inline_value.size();
+  }
 }
 
 void LogContext::PopScopedTag(const char* key)
 {
-  if (!key || tls_tags_.Empty())
+  TagId key_id = 0;
+  if (!key || !TagDictionary::Instance().Find(key, key_id))
   {
     return;
   }
+  PopScopedTag(key_id);
+}
+
+void LogContext::PopScopedTag(TagId key)
+{
   for (size_t i = tls_tags_.Size(); i-- > 0;)
   {
-    if (std::strncmp(tls_tags_[i].key, key, BR_LOG_MAX_TAG_KEY_LEN) == 0)
+    if (tls_tags_[i].key == key)
     {
       size_t last = tls_tags_.Size() - 1;
+      tls_inline_bytes_ -= tls_inline_values_[i].size();
       if (i != last)
       {
         tls_tags_[i] = tls_tags_[last];
+        tls_inline_values_[i].swap(tls_inline_values_[last]);
       }
+      tls_inline_values_[last].clear();
       tls_tags_.PopBack();
       return;
     }
   }
 }
 
-void LogContext::FillTags(LogEntry& entry) const
+size_t LogContext::TagCount() const
+{
+  size_t count = tls_tags_.Size() + GlobalTags().tags.Size();
+  return count < BR_LOG_MAX_TAGS ? count : BR_LOG_MAX_TAGS;
+}
+
+uint64_t LogContext::TruncatedTagValues() const
+{
+  return truncated_tag_values_.load(std::memory_order_relaxed);
+}
+
+size_t LogContext::TagTextSize() const
+{
+  size_t size = GlobalTags().inline_bytes + tls_inline_bytes_;
+  return size < BR_LOG_TAG_INLINE_LEN ? size : BR_LOG_TAG_INLINE_LEN;
+}
+
+// 被截断的内联值以此结尾，便于在输出中识别
+static constexpr char K_TAG_TRUNCATED[] = "...";
+static constexpr size_t K_TAG_TRUNCATED_LEN = sizeof(K_TAG_TRUNCATED) - 1;
+
+size_t LogContext::FillTags(LogTag* dst, size_t max_tags, char* text, size_t text_cap,
+                            size_t& text_len) const
 {
   size_t count = 0;
+  text_len = 0;
+  auto append = [&](const LogTag& tag, const std::string& inline_value)
   {
-    std::shared_lock<std::shared_mutex> lock(global_mutex_);
-    for (const auto& tag : global_tags_)
+    LogTag& out = dst[count++];
+    out = tag;
+    if (is_inline_tag_value(tag.value))
     {
-      if (count >= BR_LOG_MAX_TAGS)
+      // 放不下时保留前缀并以 K_TAG_TRUNCATED 结尾，计入 TruncatedTagValues。
+      // 内联值总长超过 BR_LOG_TAG_INLINE_LEN，或 TagTextSize 之后全局快照变长时发生
+      size_t avail = text_cap - text_len;
+      size_t len = inline_value.size();
+      if (len > avail)
+      {
+        len = avail;
+        size_t keep = avail > K_TAG_TRUNCATED_LEN ? avail - K_TAG_TRUNCATED_LEN : 0;
+        std::memcpy(text + text_len, inline_value.data(), keep);
+        std::memcpy(text + text_len + keep, K_TAG_TRUNCATED, len - keep);
+        truncated_tag_values_.fetch_add(1, std::memory_order_relaxed);
+      }
+      else
       {
-        break;
+        std::memcpy(text + text_len, inline_value.data(), len);
       }
-      entry.tags[count++] = tag;
+      out.value = make_inline_tag_value(text_len, len);
+      text_len += len;
     }
-  }
+  };
 
-  for (const auto& tag : tls_tags_)
+  const GlobalTagSnapshot& global = GlobalTags();
+  for (size_t i = 0; i < global.tags.Size() && count < max_tags; ++i)
   {
-    if (count >= BR_LOG_MAX_TAGS)
-    {
-      break;
-    }
-    entry.tags[count++] = tag;
+    append(global.tags[i], global.inline_values[i]);
   }
+  for (size_t i = 0; i < tls_tags_.Size() && count < max_tags; ++i)
+  {
+    append(tls_tags_[i], tls_inline_values_[i]);
+  }
+  return count;
+}
 
-  entry.tag_count = static_cast<uint8_t>(count);
+void LogContext::FillTags(LogEntry& entry) const
+{
+  size_t text_len = 0;
+  entry.tag_count = static_cast<uint8_t>(
+      FillTags(entry.tags, BR_LOG_MAX_TAGS, entry.tag_text, sizeof(entry.tag_text), text_len));
+  entry.tag_text_len = static_cast<uint16_t>(text_len);
 }
 
-void LogContext::FillThreadInfo(LogEntry& entry) const
+static uint32_t current_process_id()
 {
 #if defined(BR_LOG_PLATFORM_WINDOWS)
   static uint32_t process_id = static_cast<uint32_t>(GetCurrentProcessId());
@@ -208,17 +321,45 @@ void LogContext::FillThreadInfo(LogEntry& entry) const
 #else
   static uint32_t process_id = 0;
 #endif
+  return process_id;
+}
 
-  entry.process_id = process_id;
+void LogContext::FillThreadInfo(LogEntry& entry) const
+{
+  entry.process_id = current_process_id();
   entry.thread_id = GetThreadId();
   std::memcpy(entry.thread_name, tls_thread_name_, sizeof(entry.thread_name));
 }
 
-LogContext::ScopedTag::ScopedTag(const char* key, const char* value) : key_(key)
+void LogContext::FillThreadInfo(LogRecord& record) const
+{
+  record.process_id = current_process_id();
+  record.thread_id = GetThreadId();
+  std::memcpy(record.thread_name, tls_thread_name_, sizeof(record.thread_name));
+}
+
+LogContext::ScopedTag::ScopedTag(const char* key, const char* value)
+{
+  if (!key || !value)
+  {
+    return;
+  }
+  key_ = TagDictionary::Instance().Intern(key);
+  active_ = true;
+  LogContext::PushScopedTagValue(key_, value);
+}
+
+LogContext::ScopedTag::ScopedTag(TagId key, TagId value) : key_(key), active_(true)
 {
   LogContext::PushScopedTag(key, value);
 }
 
-LogContext::ScopedTag::~ScopedTag() { LogContext::PopScopedTag(key_); }
+LogContext::ScopedTag::~ScopedTag()
+{
+  if (active_)
+  {
+    LogContext::PopScopedTag(key_);
+  }
+}
 
 }  // namespace br_logger
@@ -13,15 +13,42 @@ Logger::Logger() = default;
 
 Logger::~Logger() { Stop(); }
 
-void Logger::AddSink(std::unique_ptr<ILogSink> sink)
+void Logger::AddSink(std::unique_ptr<ILogSink> sink, uint32_t shard)
 {
-  backend_.AddSink(std::move(sink));
+  backend_.AddSink(std::move(sink), shard);
 }
 
 void Logger::SetLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
 
 LogLevel Logger::Level() const { return level_.load(std::memory_order_relaxed); }
 
+void Logger::SetQueueTopology(QueueTopology topology) { backend_.SetQueueTopology(topology); }
+
+QueueTopology Logger::GetQueueTopology() const { return backend_.GetQueueTopology(); }
+
+void Logger::SetClockSource(ClockSource source) { backend_.SetClockSource(source); }
+
+ClockSource Logger::GetClockSource() const { return backend_.GetClockSource(); }
+
+void Logger::SetIdleStrategy(IdleStrategy strategy) { backend_.SetIdleStrategy(strategy); }
+
+IdleStrategy Logger::GetIdleStrategy() const { return backend_.GetIdleStrategy(); }
+
+void Logger::SetBackpressurePolicy(const BackpressurePolicy& policy)
+{
+  backend_.SetBackpressurePolicy(policy);
+}
+
+BackpressurePolicy Logger::GetBackpressurePolicy() const
+{
+  return backend_.GetBackpressurePolicy();
+}
+
+BackpressureStats Logger::GetBackpressureStats() const
+{
+  return backend_.GetBackpressureStats();
+}
+
 void Logger::Start()
 {
   if (started_)
@@ -32,6 +59,17 @@ void Logger::Start()
   started_ = true;
 }
 
+AppliedBackendOptions Logger::Start(const BackendOptions& options)
+{
+  if (started_)
+  {
+    return backend_.GetAppliedOptions();
+  }
+  AppliedBackendOptions applied = backend_.Start(options);
+  started_ = true;
+  return applied;
+}
+
 void Logger::Stop()
 {
   if (!started_)
@@ -46,6 +84,19 @@ size_t Logger::Drain(size_t max_entries) { return backend_.Drain(max_entries); }
 
 uint64_t Logger::DropCount() const { return drop_count_.load(std::memory_order_relaxed); }
 
-void Logger::ResetDropCount() { drop_count_.store(0, std::memory_order_relaxed); }
+uint64_t Logger::LaneDropCount(QueueLane lane) const { return backend_.LaneDropCount(lane); }
+
+void Logger::SetOverflowCapacity(size_t capacity_bytes)
+{
+  backend_.SetOverflowCapacity(capacity_bytes);
+}
+
+OverflowStats Logger::GetOverflowStats() const { return backend_.GetOverflowStats(); }
+
+void Logger::ResetDropCount()
+{
+  drop_count_.store(0, std::memory_order_relaxed);
+  backend_.ResetBackpressureStats();
+}
 
 }  // namespace br_logger
@@ -0,0 +1,119 @@
+#include "br_logger/overflow_chain.hpp"
+
+namespace br_logger
+{
+
+void OverflowChain::Configure(size_t capacity_bytes)
+{
+  size_t count = capacity_bytes / BR_LOG_OVERFLOW_SEGMENT_BYTES;
+  nodes_.clear();
+  free_.clear();
+  for (size_t i = 0; i < count; ++i)
+  {
+    nodes_.push_back(std::make_unique<Node>());
+  }
+  // 池中的段保持封存，过期的生产者指针不会写进去
+  for (size_t i = count; i > 1; --i)
+  {
+    nodes_[i - 1]->sealed.store(true, std::memory_order_relaxed);
+    free_.push_back(nodes_[i - 1].get());
+  }
+  head_ = count > 0 ? nodes_[0].get() : nullptr;
+  tail_.store(head_, std::memory_order_release);
+  in_use_.store(count > 0 ? 1 : 0, std::memory_order_relaxed);
+  high_water_.store(in_use_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  spilled_.store(0, std::memory_order_relaxed);
+}
+
+ByteReservation OverflowChain::TryReserve(uint32_t size)
+{
+  for (;;)
+  {
+    Node* tail = tail_.load(std::memory_order_acquire);
+    if (tail == nullptr)
+    {
+      return ByteReservation{};
+    }
+    // 先登记再检查封存标志，与消费者的 Retired 检查配对
+    tail->writers.fetch_add(1, std::memory_order_seq_cst);
+    ByteReservation reservation{};
+    if (!tail->sealed.load(std::memory_order_seq_cst))
+    {
+      reservation = tail->ring.TryReserve(size);
+    }
+    tail->writers.fetch_sub(1, std::memory_order_release);
+    if (reservation)
+    {
+      spilled_.fetch_add(1, std::memory_order_relaxed);
+      return reservation;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tail_.load(std::memory_order_relaxed) != tail)
+    {
+      continue;  // 其他生产者已经换过段
+    }
+    if (free_.empty())
+    {
+      return ByteReservation{};
+    }
+    Node* next = free_.back();
+    free_.pop_back();
+    next->next.store(nullptr, std::memory_order_relaxed);
+    next->sealed.store(false, std::memory_order_relaxed);
+    tail->sealed.store(true, std::memory_order_seq_cst);
+    tail->next.store(next, std::memory_order_release);
+    tail_.store(next, std::memory_order_release);
+
+    size_t in_use = in_use_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (in_use > high_water_.load(std::memory_order_relaxed))
+    {
+      high_water_.store(in_use, std::memory_order_relaxed);
+    }
+  }
+}
+
+bool OverflowChain::Retired(Node& node)
+{
+  return node.sealed.load(std::memory_order_acquire) &&
+         node.writers.load(std::memory_order_seq_cst) == 0 && node.ring.Drained();
+}
+
+const uint8_t* OverflowChain::Peek(uint32_t& size)
+{
+  if (head_ == nullptr)
+  {
+    return nullptr;
+  }
+  for (;;)
+  {
+    const uint8_t* record = head_->ring.Peek(size);
+    if (record != nullptr)
+    {
+      return record;
+    }
+    Node* next = head_->next.load(std::memory_order_acquire);
+    if (next == nullptr || !Retired(*head_))
+    {
+      return nullptr;
+    }
+    Node* old = head_;
+    head_ = next;
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(old);
+    in_use_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+OverflowStats OverflowChain::Stats() const
+{
+  OverflowStats stats;
+  stats.segment_bytes = BR_LOG_OVERFLOW_SEGMENT_BYTES;
+  stats.capacity_bytes = nodes_.size() * BR_LOG_OVERFLOW_SEGMENT_BYTES;
+  stats.segments_in_use = in_use_.load(std::memory_order_relaxed);
+  stats.high_water_segments = high_water_.load(std::memory_order_relaxed);
+  stats.spilled_records = spilled_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace br_logger
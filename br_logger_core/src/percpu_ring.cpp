@@ -0,0 +1,128 @@
+#include "br_logger/percpu_ring.hpp"
+
+#include "br_logger/platform.hpp"
+
+#if BR_LOG_HAS_RSEQ
+
+#include <sys/rseq.h>
+#include <unistd.h>
+
+namespace br_logger
+{
+
+namespace
+{
+
+static_assert(RSEQ_SIG == 0x53053053, "unexpected rseq signature");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "write position must be a plain 32-bit word");
+
+int current_cpu()
+{
+  const auto* area = reinterpret_cast<const volatile struct rseq*>(
+      static_cast<const char*>(__builtin_thread_pointer()) + __rseq_offset);
+  return static_cast<int>(area->cpu_id);
+}
+
+// rseq 临界区：仍在 cpu 上且 *v == expect 时写入 newv。
+// 返回 0 表示成功，1 表示 *v 已被同 CPU 的其他线程推进，-1 表示被内核中止
+inline __attribute__((always_inline)) int rseq_cmpeqv_storev(uint32_t* v, uint32_t expect,
+                                                            uint32_t newv, int cpu)
+{
+  __asm__ __volatile__ goto(
+      // struct rseq_cs { version, flags, start_ip, post_commit_offset, abort_ip }
+      ".pushsection __rseq_cs, \"aw\"\n\t"
+      ".balign 32\n\t"
+      "3:\n\t"
+      ".long 0x0, 0x0\n\t"
+      ".quad 1f, (2f - 1f), 4f\n\t"
+      ".popsection\n\t"
+      "leaq 3b(%%rip), %%rax\n\t"
+      "movq %%rax, %%fs:8(%[rseq_offset])\n\t"
+      "1:\n\t"
+      "cmpl %[cpu_id], %%fs:4(%[rseq_offset])\n\t"
+      "jnz 4f\n\t"
+      "cmpl %[v], %[expect]\n\t"
+      "jnz %l[cmpfail]\n\t"
+      "movl %[newv], %[v]\n\t"
+      "2:\n\t"
+      // 中止入口前必须紧跟注册时使用的签名
+      ".pushsection __rseq_failure, \"ax\"\n\t"
+      ".byte 0x0f, 0xb9, 0x3d\n\t"
+      ".long 0x53053053\n\t"
+      "4:\n\t"
+      "jmp %l[abort]\n\t"
+      ".popsection\n\t"
+      :
+      : [cpu_id] "r"(cpu), [rseq_offset] "r"(__rseq_offset), [v] "m"(*v),
+        [expect] "r"(expect), [newv] "r"(newv)
+      : "memory", "cc", "rax"
+      : abort, cmpfail);
+  return 0;
+abort:
+  return -1;
+cmpfail:
+  return 1;
+}
+
+}  // namespace
+
+PerCpuRing::PerCpuRing()
+{
+  long cpus = sysconf(_SC_NPROCESSORS_CONF);
+  rings_.resize(cpus > 0 ? static_cast<size_t>(cpus) : 1);
+  for (auto& ring : rings_)
+  {
+    ring = std::make_unique<Ring>();
+  }
+}
+
+bool PerCpuRing::Available() { return __rseq_size > 0 && current_cpu() >= 0; }
+
+ByteReservation PerCpuRing::TryReserve(uint32_t size)
+{
+  if (size == 0 || size > Ring::K_MAX_RECORD_SIZE)
+  {
+    return ByteReservation{};
+  }
+  uint32_t blocks = Ring::BlocksFor(size);
+  for (;;)
+  {
+    int cpu = current_cpu();
+    if (cpu < 0 || static_cast<size_t>(cpu) >= rings_.size())
+    {
+      return ByteReservation{};
+    }
+    Ring& ring = *rings_[static_cast<size_t>(cpu)];
+    // 写位置只会在 rseq 临界区内被修改，这里用普通读取即可；
+    // 空间检查在临界区外完成，消费者只会让空间变大，因此结论在提交时依然成立
+    uint32_t pos = ring.WritePosition().load(std::memory_order_relaxed);
+    uint32_t pad = 0;
+    if (!ring.PlanReserve(pos, blocks, pad))
+    {
+      return ByteReservation{};
+    }
+    auto* write_pos = reinterpret_cast<uint32_t*>(&ring.WritePosition());
+    if (rseq_cmpeqv_storev(write_pos, pos, pos + pad + blocks, cpu) == 0)
+    {
+      return ring.FinishReserve(pos, pad, blocks);
+    }
+  }
+}
+
+}  // namespace br_logger
+
+#else
+
+namespace br_logger
+{
+
+PerCpuRing::PerCpuRing() = default;
+
+bool PerCpuRing::Available() { return false; }
+
+ByteReservation PerCpuRing::TryReserve(uint32_t) { return ByteReservation{}; }
+
+}  // namespace br_logger
+
+#endif
@@ -0,0 +1,235 @@
+#include "br_logger/sinks/async_sink_adapter.hpp"
+
+#if BR_LOG_HAS_THREAD
+
+#include "br_logger/futex.hpp"
+#include "br_logger/log_record.hpp"
+#include "br_logger/timestamp.hpp"
+
+namespace br_logger
+{
+
+static_assert(K_MAX_RECORD_SIZE <= AsyncSinkAdapter::Queue::K_MAX_RECORD_SIZE,
+              "BR_LOG_ASYNC_SINK_QUEUE_BYTES too small for the largest log record");
+
+AsyncSinkAdapter::AsyncSinkAdapter(std::unique_ptr<ILogSink> sink,
+                                   const AsyncSinkOptions& options)
+    : sink_(std::move(sink)),
+      options_(options),
+      queue_(std::make_unique<Queue>()),
+      batch_(new LogEntry[BR_LOG_DISPATCH_BATCH])
+{
+  worker_ = std::thread(&AsyncSinkAdapter::WorkerLoop, this);
+}
+
+AsyncSinkAdapter::~AsyncSinkAdapter()
+{
+  running_.store(false, std::memory_order_relaxed);
+  worker_seq_.fetch_add(1, std::memory_order_release);
+  futex_wake_all(worker_seq_);
+  space_seq_.fetch_add(1, std::memory_order_release);
+  futex_wake_all(space_seq_);
+  if (worker_.joinable())
+  {
+    worker_.join();
+  }
+}
+
+void AsyncSinkAdapter::Write(const LogEntry& entry) { WriteBatch(&entry, 1); }
+
+void AsyncSinkAdapter::WriteBatch(const LogEntry* entries, size_t count)
+{
+  bool any = false;
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (sink_->ShouldLog(entries[i].level))
+    {
+      any = Enqueue(entries[i]) || any;
+    }
+  }
+  if (any)
+  {
+    WakeWorker();
+  }
+}
+
+bool AsyncSinkAdapter::Enqueue(const LogEntry& entry)
+{
+  uint32_t size = static_cast<uint32_t>(record_size(entry));
+  Queue::Reservation reservation = queue_->TryReserve(size);
+  if (!reservation && !WaitForSpace(size))
+  {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  if (!reservation)
+  {
+    reservation = queue_->TryReserve(size);
+  }
+  encode_record(entry, reservation.data);
+  Queue::Commit(reservation, size);
+  enqueued_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+// 等到队列能放下 size 字节时返回 true；策略不允许等待、超时或适配器正在析构时返回 false
+bool AsyncSinkAdapter::WaitForSpace(uint32_t size)
+{
+  OverflowAction action = options_.overflow_action;
+  if (action != OverflowAction::BOUNDED_WAIT && action != OverflowAction::BLOCK)
+  {
+    return false;
+  }
+  // 本批已提交的记录可能还没通知工作线程
+  WakeWorker();
+  uint64_t deadline = monotonic_now_ns() + options_.wait_timeout_ns;
+  for (;;)
+  {
+    uint32_t seq = space_seq_.load(std::memory_order_acquire);
+    space_waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint32_t pad = 0;
+    uint32_t pos = queue_->WritePosition().load(std::memory_order_relaxed);
+    if (queue_->PlanReserve(pos, Queue::BlocksFor(size), pad))
+    {
+      return true;
+    }
+    if (!running_.load(std::memory_order_relaxed))
+    {
+      return false;
+    }
+    uint64_t timeout_ns = 0;
+    if (action == OverflowAction::BOUNDED_WAIT)
+    {
+      uint64_t now = monotonic_now_ns();
+      if (now >= deadline)
+      {
+        wait_timeouts_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      timeout_ns = deadline - now;
+    }
+    futex_wait(space_seq_, seq, timeout_ns);
+  }
+}
+
+void AsyncSinkAdapter::WakeWorker()
+{
+  // 与工作线程登记睡眠后的再次检查配对：提交先于读取睡眠标志
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (worker_sleeping_.load(std::memory_order_relaxed) &&
+      worker_sleeping_.exchange(false, std::memory_order_relaxed))
+  {
+    worker_seq_.fetch_add(1, std::memory_order_release);
+    futex_wake_all(worker_seq_);
+  }
+}
+
+void AsyncSinkAdapter::Flush()
+{
+  uint32_t request = flush_requested_.fetch_add(1, std::memory_order_release) + 1;
+  WakeWorker();
+  for (;;)
+  {
+    uint32_t done = flush_done_.load(std::memory_order_acquire);
+    if (static_cast<int32_t>(done - request) >= 0)
+    {
+      return;
+    }
+    futex_wait(flush_done_, done, 0);
+  }
+}
+
+AsyncSinkStats AsyncSinkAdapter::Stats() const
+{
+  AsyncSinkStats stats;
+  stats.enqueued = enqueued_.load(std::memory_order_relaxed);
+  stats.dropped = dropped_.load(std::memory_order_relaxed);
+  stats.wait_timeouts = wait_timeouts_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+// 按批解码后先归还队列空间，再交给被包装的 Sink
+size_t AsyncSinkAdapter::DrainQueue()
+{
+  size_t total = 0;
+  uint32_t size = 0;
+  for (;;)
+  {
+    uint32_t cursor = queue_->ReadCursor();
+    size_t count = 0;
+    while (count < BR_LOG_DISPATCH_BATCH)
+    {
+      const uint8_t* record = queue_->PeekNext(cursor, size);
+      if (record == nullptr)
+      {
+        break;
+      }
+      decode_record(record, batch_[count++], clock_);
+    }
+    if (count == 0)
+    {
+      return total;
+    }
+    queue_->ReleaseTo(cursor);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (space_waiting_.load(std::memory_order_relaxed) &&
+        space_waiting_.exchange(false, std::memory_order_relaxed))
+    {
+      space_seq_.fetch_add(1, std::memory_order_release);
+      futex_wake_all(space_seq_);
+    }
+    sink_->WriteBatch(batch_.get(), count);
+    total += count;
+  }
+}
+
+void AsyncSinkAdapter::WorkerLoop()
+{
+  bool idle = true;
+  for (;;)
+  {
+    if (DrainQueue() > 0)
+    {
+      idle = false;
+      continue;
+    }
+    uint32_t request = flush_requested_.load(std::memory_order_acquire);
+    if (request != flush_done_.load(std::memory_order_relaxed))
+    {
+      // Flush 之前提交的记录都已写完
+      sink_->Flush();
+      idle = true;
+      flush_done_.store(request, std::memory_order_release);
+      futex_wake_all(flush_done_);
+      continue;
+    }
+    if (!idle)
+    {
+      sink_->OnIdle();
+      idle = true;
+    }
+    if (!running_.load(std::memory_order_relaxed))
+    {
+      break;
+    }
+    // 登记睡眠后再检查一次，避免错过登记之前提交的记录与 Flush 请求
+    uint32_t seq = worker_seq_.load(std::memory_order_acquire);
+    worker_sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (queue_->Empty() &&
+        flush_requested_.load(std::memory_order_relaxed) ==
+            flush_done_.load(std::memory_order_relaxed) &&
+        running_.load(std::memory_order_relaxed))
+    {
+      futex_wait(worker_seq_, seq, 0);
+    }
+    worker_sleeping_.store(false, std::memory_order_relaxed);
+  }
+  DrainQueue();
+  sink_->Flush();
+}
+
+}  // namespace br_logger
+
+#endif  // BR_LOG_HAS_THREAD
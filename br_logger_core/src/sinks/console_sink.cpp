@@ -16,6 +16,11 @@
 namespace br_logger
 {
 
+namespace
+{
+constexpr size_t K_BATCH_BUFFER_SIZE = 64 * 1024;
+}  // namespace
+
 ConsoleSink::ConsoleSink(std::optional<bool> force_color)
 {
   stdout_is_tty_ = ::isatty(STDOUT_FILENO) != 0;
@@ -31,28 +36,77 @@ ConsoleSink::ConsoleSink(std::optional<bool> force_color)
   }
 }
 
-void ConsoleSink::Write(const LogEntry& entry)
-{
-  if (!ShouldLog(entry.level))
-  {
-    return;
-  }
+void ConsoleSink::Write(const LogEntry& entry) { WriteBatch(&entry, 1); }
 
+void ConsoleSink::WriteBatch(const LogEntry* entries, size_t count)
+{
   if (!formatter_)
   {
     formatter_ = std::make_unique<PatternFormatter>(
         "[%D %T%e] [%C%L%R] [tid:%t] [%f:%#::%n] %g %m", use_color_);
   }
+  if (batch_buf_.empty())
+  {
+    batch_buf_.resize(K_BATCH_BUFFER_SIZE);
+  }
 
-  size_t len = DoFormat(entry);
-  if (len == 0)
+  char* buf = batch_buf_.data();
+  size_t used = 0;
+  FILE* target = nullptr;
+  for (size_t i = 0; i < count; ++i)
   {
-    return;
+    const LogEntry& entry = entries[i];
+    if (!ShouldLog(entry.level))
+    {
+      continue;
+    }
+    FILE* entry_target = (entry.level >= LogLevel::WARN) ? stderr : stdout;
+    if (used > 0 && (entry_target != target || batch_buf_.size() - used < sizeof(format_buf_)))
+    {
+      std::fwrite(buf, 1, used, target);
+      used = 0;
+    }
+    target = entry_target;
+    size_t len = DoFormat(entry, buf + used, sizeof(format_buf_));
+    if (len == 0)
+    {
+      continue;
+    }
+    used += len;
+    buf[used++] = '\n';
   }
+  if (used > 0)
+  {
+    std::fwrite(buf, 1, used, target);
+  }
+}
 
-  FILE* target = (entry.level >= LogLevel::WARN) ? stderr : stdout;
-  std::fwrite(format_buf_, 1, len, target);
-  std::fwrite("\n", 1, 1, target);
+// 已格式化的行在 text 中连续存放，stdout / stderr 各自连续的一段直接写出
+void ConsoleSink::WriteFormatted(const FormattedBatch& batch)
+{
+  size_t run_begin = 0;
+  FILE* target = nullptr;
+  for (size_t i = 0; i < batch.count; ++i)
+  {
+    if (batch.offsets[i] == batch.offsets[i + 1])
+    {
+      continue;
+    }
+    FILE* entry_target = (batch.entries[i].level >= LogLevel::WARN) ? stderr : stdout;
+    if (entry_target != target)
+    {
+      if (target != nullptr)
+      {
+        std::fwrite(batch.text + run_begin, 1, batch.offsets[i] - run_begin, target);
+      }
+      run_begin = batch.offsets[i];
+      target = entry_target;
+    }
+  }
+  if (target != nullptr)
+  {
+    std::fwrite(batch.text + run_begin, 1, batch.offsets[batch.count] - run_begin, target);
+  }
 }
 
 void ConsoleSink::Flush()
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "br_logger/formatters/pattern_formatter.hpp"
+#include "br_logger/timestamp.hpp"
 
 namespace br_logger
 {
@@ -35,7 +36,9 @@ DailyFileSink::DailyFileSink(const std::string& base_dir, const std::string& bas
       max_days_(max_days),
       use_utc_(use_utc),
       fd_(-1),
-      current_day_(-1)
+      current_day_(-1),
+      writer_(BR_LOG_FILE_BUFFER_BYTES, BR_LOG_FILE_FLUSH_BYTES,
+              static_cast<uint64_t>(BR_LOG_FILE_FLUSH_AGE_MS) * 1'000'000ULL)
 {
   MkdirRecursive(base_dir_);
   OpenFileForToday();
@@ -45,6 +48,7 @@ DailyFileSink::~DailyFileSink()
 {
   if (fd_ >= 0)
   {
+    writer_.Flush();
     ::fsync(fd_);
     ::close(fd_);
     fd_ = -1;
@@ -99,11 +103,13 @@ void DailyFileSink::OpenFileForToday()
 
   if (fd_ >= 0)
   {
+    writer_.Flush();
     ::fsync(fd_);
     ::close(fd_);
   }
 
   fd_ = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  writer_.Reset(fd_, 0);
   current_day_ = GetDay(now);
 
   if (max_days_ > 0)
@@ -163,42 +169,74 @@ void DailyFileSink::CleanupOldFiles()
   ::closedir(dir);
 }
 
-void DailyFileSink::Write(const LogEntry& entry)
-{
-  if (!ShouldLog(entry.level))
-  {
-    return;
-  }
+void DailyFileSink::Write(const LogEntry& entry) { WriteBatch(&entry, 1); }
 
+void DailyFileSink::WriteBatch(const LogEntry* entries, size_t count)
+{
   if (!formatter_)
   {
     formatter_ = std::make_unique<PatternFormatter>(
         "[%D %T%e] [%C%L%R] [tid:%t] [%f:%#::%n] %g %m", false);
   }
 
+  // 一批日志同属一次 Drain，按批开始时的日期选择文件
   std::time_t now = std::time(nullptr);
   int today = GetDay(now);
   if (today != current_day_)
   {
     OpenFileForToday();
   }
-
-  size_t len = DoFormat(entry);
-  if (len == 0 || fd_ < 0)
+  if (fd_ < 0)
   {
     return;
   }
 
-  ::write(fd_, format_buf_, len);
-  ::write(fd_, "\n", 1);
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (!ShouldLog(entries[i].level))
+    {
+      continue;
+    }
+    char* dst = writer_.Reserve(sizeof(format_buf_));
+    if (dst == nullptr)
+    {
+      return;
+    }
+    size_t len = DoFormat(entries[i], dst, sizeof(format_buf_));
+    if (len == 0)
+    {
+      continue;
+    }
+    dst[len] = '\n';
+    writer_.Commit(len + 1);
+  }
+  writer_.FlushIfDue(monotonic_now_ns());
+}
+
+void DailyFileSink::WriteFormatted(const FormattedBatch& batch)
+{
+  int today = GetDay(std::time(nullptr));
+  if (today != current_day_)
+  {
+    OpenFileForToday();
+  }
+  if (fd_ < 0)
+  {
+    return;
+  }
+  writer_.Append(batch.text + batch.offsets[0], batch.offsets[batch.count] - batch.offsets[0]);
+  writer_.FlushIfDue(monotonic_now_ns());
 }
 
 void DailyFileSink::Flush()
 {
   if (fd_ >= 0)
   {
+    writer_.Flush();
     ::fsync(fd_);
   }
 }
 
+void DailyFileSink::OnIdle() { writer_.Flush(); }
+
 }  // namespace br_logger
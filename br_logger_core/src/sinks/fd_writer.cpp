@@ -0,0 +1,162 @@
+#include "br_logger/sinks/fd_writer.hpp"
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace br_logger
+{
+
+FdWriter::FdWriter(size_t capacity, size_t flush_bytes, uint64_t flush_age_ns)
+    : buf_(nullptr),
+      capacity_((capacity + K_ALIGNMENT - 1) / K_ALIGNMENT * K_ALIGNMENT),
+      flush_bytes_(flush_bytes < capacity_ ? flush_bytes : capacity_),
+      flush_age_ns_(flush_age_ns)
+{
+  void* mem = nullptr;
+  if (::posix_memalign(&mem, K_ALIGNMENT, capacity_) == 0)
+  {
+    buf_ = static_cast<char*>(mem);
+  }
+  else
+  {
+    capacity_ = 0;
+  }
+}
+
+FdWriter::~FdWriter() { std::free(buf_); }
+
+void FdWriter::Reset(int fd, size_t file_size)
+{
+  fd_ = fd;
+  file_size_ = file_size;
+  used_ = 0;
+  has_buffered_ = false;
+}
+
+char* FdWriter::Reserve(size_t max_len)
+{
+  if (capacity_ - used_ < max_len)
+  {
+    Flush();
+  }
+  return capacity_ - used_ >= max_len ? buf_ + used_ : nullptr;
+}
+
+void FdWriter::Commit(size_t len)
+{
+  if (len == 0)
+  {
+    return;
+  }
+  used_ += len;
+  file_size_ += len;
+}
+
+void FdWriter::Append(const char* data, size_t len)
+{
+  if (len == 0)
+  {
+    return;
+  }
+  if (capacity_ - used_ >= len)
+  {
+    std::memcpy(buf_ + used_, data, len);
+    Commit(len);
+    return;
+  }
+  // 放不下：缓冲内容与新数据合并为一次 writev
+  file_size_ += len;
+  if (fd_ >= 0)
+  {
+    WriteFully(buf_, used_, data, len);
+  }
+  used_ = 0;
+  has_buffered_ = false;
+}
+
+void FdWriter::FlushIfDue(uint64_t now_ns)
+{
+  if (used_ == 0)
+  {
+    return;
+  }
+  if (!has_buffered_)
+  {
+    first_buffered_ns_ = now_ns;
+    has_buffered_ = true;
+  }
+  bool too_old = flush_age_ns_ > 0 && now_ns >= first_buffered_ns_ &&
+                 now_ns - first_buffered_ns_ >= flush_age_ns_;
+  if (used_ >= flush_bytes_ || too_old)
+  {
+    Flush();
+  }
+}
+
+bool FdWriter::Flush()
+{
+  if (used_ == 0)
+  {
+    return true;
+  }
+  bool ok = fd_ >= 0 && WriteFully(buf_, used_, nullptr, 0);
+  used_ = 0;
+  has_buffered_ = false;
+  return ok;
+}
+
+// 写出 data 与 tail 两段，处理 EINTR 与部分写入
+bool FdWriter::WriteFully(const char* data, size_t len, const char* tail, size_t tail_len)
+{
+  struct iovec iov[2];
+  int iov_count = 0;
+  if (len > 0)
+  {
+    iov[iov_count++] = {const_cast<char*>(data), len};
+  }
+  if (tail_len > 0)
+  {
+    iov[iov_count++] = {const_cast<char*>(tail), tail_len};
+  }
+  struct iovec* cur = iov;
+  while (iov_count > 0)
+  {
+    ++stats_.syscalls;
+    ssize_t n = iov_count == 1 ? ::write(fd_, cur->iov_base, cur->iov_len)
+                               : ::writev(fd_, cur, iov_count);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      ++stats_.write_errors;
+      return false;
+    }
+    if (n == 0)
+    {
+      ++stats_.write_errors;
+      return false;
+    }
+    auto written = static_cast<size_t>(n);
+    stats_.bytes_written += written;
+    while (iov_count > 0 && written >= cur->iov_len)
+    {
+      written -= cur->iov_len;
+      ++cur;
+      --iov_count;
+    }
+    if (iov_count > 0)
+    {
+      cur->iov_base = static_cast<char*>(cur->iov_base) + written;
+      cur->iov_len -= written;
+    }
+  }
+  return true;
+}
+
+}  // namespace br_logger
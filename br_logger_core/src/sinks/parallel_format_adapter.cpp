@@ -0,0 +1,208 @@
+#include "br_logger/sinks/parallel_format_adapter.hpp"
+
+#if BR_LOG_HAS_THREAD
+
+#include "br_logger/backend_options.hpp"
+#include "br_logger/futex.hpp"
+
+namespace br_logger
+{
+
+ParallelFormatAdapter::ParallelFormatAdapter(std::unique_ptr<ILogSink> sink,
+                                             std::unique_ptr<IFormatter> formatter,
+                                             const ParallelFormatOptions& options)
+    : sink_(std::move(sink)), jobs_(new Job[BR_LOG_FORMAT_JOBS])
+{
+  formatter_ = std::move(formatter);
+  for (size_t i = 0; i < BR_LOG_FORMAT_JOBS; ++i)
+  {
+    jobs_[i].text.reset(new char[BR_LOG_DISPATCH_BATCH * K_LINE_BYTES]);
+  }
+  BackendOptions thread_options;
+  thread_options.thread_name = options.thread_name;
+  for (uint32_t i = 0; i < options.threads; ++i)
+  {
+    pool_.emplace_back(&ParallelFormatAdapter::PoolLoop, this);
+    AppliedBackendOptions ignored;
+    apply_thread_options(pool_.back(), thread_options, ignored);
+  }
+}
+
+ParallelFormatAdapter::~ParallelFormatAdapter()
+{
+  EmitReady(true);
+  running_.store(false, std::memory_order_relaxed);
+  work_seq_.fetch_add(1, std::memory_order_release);
+  futex_wake_all(work_seq_);
+  for (auto& thread : pool_)
+  {
+    thread.join();
+  }
+  sink_->Flush();
+}
+
+void ParallelFormatAdapter::Write(const LogEntry& entry) { WriteBatch(&entry, 1); }
+
+void ParallelFormatAdapter::WriteBatch(const LogEntry* entries, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (!sink_->ShouldLog(entries[i].level))
+    {
+      continue;
+    }
+    if (filling_ == nullptr)
+    {
+      // 批槽都在途时先输出最早的一批
+      uint32_t seq = submitted_.load(std::memory_order_relaxed);
+      while (seq - emitted_ >= BR_LOG_FORMAT_JOBS)
+      {
+        WaitDone(JobAt(emitted_), emitted_ + 1);
+        EmitReady(false);
+      }
+      filling_ = &JobAt(seq);
+      filling_->count = 0;
+    }
+    filling_->entries[filling_->count++] = entries[i];
+    if (filling_->count == BR_LOG_DISPATCH_BATCH)
+    {
+      Submit();
+    }
+  }
+  if (filling_ != nullptr)
+  {
+    Submit();
+  }
+  EmitReady(false);
+}
+
+void ParallelFormatAdapter::Submit()
+{
+  Job& job = *filling_;
+  filling_ = nullptr;
+  uint32_t seq = submitted_.load(std::memory_order_relaxed);
+  if (pool_.empty())
+  {
+    FormatJob(job);
+    job.done.store(seq + 1, std::memory_order_relaxed);
+    submitted_.store(seq + 1, std::memory_order_relaxed);
+    return;
+  }
+  submitted_.store(seq + 1, std::memory_order_release);
+  // 与格式化线程登记睡眠后的再次检查配对
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleepers_.load(std::memory_order_relaxed) > 0)
+  {
+    work_seq_.fetch_add(1, std::memory_order_release);
+    futex_wake_all(work_seq_);
+  }
+}
+
+// 各行连续写入 text 并补上 '\n'，格式化器在行尾写入的 '\0' 被覆盖
+void ParallelFormatAdapter::FormatJob(Job& job)
+{
+  char* text = job.text.get();
+  uint32_t used = 0;
+  for (size_t i = 0; i < job.count; ++i)
+  {
+    job.offsets[i] = used;
+    size_t len = formatter_ ? formatter_->Format(job.entries[i], text + used, K_LINE_BYTES) : 0;
+    if (len > 0)
+    {
+      text[used + len] = '\n';
+      used += static_cast<uint32_t>(len + 1);
+    }
+  }
+  job.offsets[job.count] = used;
+}
+
+void ParallelFormatAdapter::EmitReady(bool wait)
+{
+  uint32_t submitted = submitted_.load(std::memory_order_relaxed);
+  while (emitted_ != submitted)
+  {
+    Job& job = JobAt(emitted_);
+    if (job.done.load(std::memory_order_acquire) != emitted_ + 1)
+    {
+      if (!wait)
+      {
+        return;
+      }
+      WaitDone(job, emitted_ + 1);
+    }
+    FormattedBatch batch{job.entries, job.text.get(), job.offsets, job.count};
+    sink_->WriteFormatted(batch);
+    ++emitted_;
+  }
+}
+
+void ParallelFormatAdapter::WaitDone(const Job& job, uint32_t expected)
+{
+  while (job.done.load(std::memory_order_acquire) != expected)
+  {
+    // 登记等待后再检查一次，避免错过格式化线程在两者之间发出的唤醒
+    uint32_t seq = done_seq_.load(std::memory_order_acquire);
+    emitter_waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (job.done.load(std::memory_order_acquire) == expected)
+    {
+      emitter_waiting_.store(false, std::memory_order_relaxed);
+      return;
+    }
+    futex_wait(done_seq_, seq, 0);
+  }
+}
+
+void ParallelFormatAdapter::Flush()
+{
+  EmitReady(true);
+  sink_->Flush();
+}
+
+void ParallelFormatAdapter::OnIdle()
+{
+  EmitReady(true);
+  sink_->OnIdle();
+}
+
+void ParallelFormatAdapter::PoolLoop()
+{
+  for (;;)
+  {
+    uint32_t seq = claimed_.load(std::memory_order_relaxed);
+    if (seq != submitted_.load(std::memory_order_acquire))
+    {
+      if (!claimed_.compare_exchange_weak(seq, seq + 1, std::memory_order_relaxed))
+      {
+        continue;
+      }
+      Job& job = JobAt(seq);
+      FormatJob(job);
+      job.done.store(seq + 1, std::memory_order_release);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (emitter_waiting_.load(std::memory_order_relaxed) &&
+          emitter_waiting_.exchange(false, std::memory_order_relaxed))
+      {
+        done_seq_.fetch_add(1, std::memory_order_release);
+        futex_wake_all(done_seq_);
+      }
+      continue;
+    }
+    if (!running_.load(std::memory_order_relaxed))
+    {
+      break;
+    }
+    uint32_t work = work_seq_.load(std::memory_order_acquire);
+    sleepers_.fetch_add(1, std::memory_order_seq_cst);
+    if (seq == submitted_.load(std::memory_order_relaxed) &&
+        running_.load(std::memory_order_relaxed))
+    {
+      futex_wait(work_seq_, work, 0);
+    }
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace br_logger
+
+#endif  // BR_LOG_HAS_THREAD
@@ -8,6 +8,7 @@
 #include <cstring>
 
 #include "br_logger/formatters/pattern_formatter.hpp"
+#include "br_logger/timestamp.hpp"
 
 namespace br_logger
 {
@@ -17,8 +18,9 @@ RotatingFileSink::RotatingFileSink(const std::string& base_path, size_t max_file
     : base_path_(base_path),
       max_file_size_(max_file_size),
       max_files_(max_files),
-      current_size_(0),
-      fd_(-1)
+      fd_(-1),
+      writer_(BR_LOG_FILE_BUFFER_BYTES, BR_LOG_FILE_FLUSH_BYTES,
+              static_cast<uint64_t>(BR_LOG_FILE_FLUSH_AGE_MS) * 1'000'000ULL)
 {
   OpenFile();
 }
@@ -27,6 +29,7 @@ RotatingFileSink::~RotatingFileSink()
 {
   if (fd_ >= 0)
   {
+    writer_.Flush();
     ::fsync(fd_);
     ::close(fd_);
     fd_ = -1;
@@ -44,18 +47,17 @@ void RotatingFileSink::OpenFile()
   }
 
   struct stat st{};
+  size_t size = 0;
   if (::fstat(fd_, &st) == 0)
   {
-    current_size_ = static_cast<size_t>(st.st_size);
-  }
-  else
-  {
-    current_size_ = 0;
+    size = static_cast<size_t>(st.st_size);
   }
+  writer_.Reset(fd_, size);
 }
 
 void RotatingFileSink::Rotate()
 {
+  writer_.Flush();
   if (fd_ >= 0)
   {
     ::close(fd_);
@@ -75,56 +77,89 @@ void RotatingFileSink::Rotate()
     std::rename(src.c_str(), dst.c_str());
   }
 
-  current_size_ = 0;
   OpenFile();
 }
 
-void RotatingFileSink::Write(const LogEntry& entry)
-{
-  if (!ShouldLog(entry.level))
-  {
-    return;
-  }
+void RotatingFileSink::Write(const LogEntry& entry) { WriteBatch(&entry, 1); }
 
+void RotatingFileSink::WriteBatch(const LogEntry* entries, size_t count)
+{
   if (!formatter_)
   {
     formatter_ = std::make_unique<PatternFormatter>(
         "[%D %T%e] [%L] [tid:%t] [%f:%#::%n] %g %m", false);
   }
 
-  size_t len = DoFormat(entry);
-  if (len == 0 || fd_ < 0)
+  for (size_t i = 0; i < count; ++i)
   {
-    return;
-  }
-
-  if (current_size_ + len + 1 > max_file_size_)
-  {
-    Rotate();
     if (fd_ < 0)
     {
       return;
     }
+    if (!ShouldLog(entries[i].level))
+    {
+      continue;
+    }
+    // 直接格式化进写缓冲，行尾的 '\n' 覆盖格式化器写入的 '\0'
+    char* dst = writer_.Reserve(sizeof(format_buf_));
+    if (dst == nullptr)
+    {
+      return;
+    }
+    size_t len = DoFormat(entries[i], dst, sizeof(format_buf_));
+    if (len == 0)
+    {
+      continue;
+    }
+    if (writer_.FileSize() + len + 1 > max_file_size_)
+    {
+      // 本行写入新文件：暂存后轮转（轮转前会写出之前缓冲的行）
+      std::memcpy(format_buf_, dst, len);
+      Rotate();
+      dst = fd_ >= 0 ? writer_.Reserve(sizeof(format_buf_)) : nullptr;
+      if (dst == nullptr)
+      {
+        return;
+      }
+      std::memcpy(dst, format_buf_, len);
+    }
+    dst[len] = '\n';
+    writer_.Commit(len + 1);
   }
+  writer_.FlushIfDue(monotonic_now_ns());
+}
 
-  ssize_t written = ::write(fd_, format_buf_, len);
-  if (written > 0)
-  {
-    current_size_ += static_cast<size_t>(written);
-  }
-  written = ::write(fd_, "\n", 1);
-  if (written > 0)
+void RotatingFileSink::WriteFormatted(const FormattedBatch& batch)
+{
+  for (size_t i = 0; i < batch.count && fd_ >= 0; ++i)
   {
-    current_size_ += 1;
+    size_t len = batch.offsets[i + 1] - batch.offsets[i];
+    if (len == 0)
+    {
+      continue;
+    }
+    if (writer_.FileSize() + len > max_file_size_)
+    {
+      Rotate();
+      if (fd_ < 0)
+      {
+        return;
+      }
+    }
+    writer_.Append(batch.text + batch.offsets[i], len);
   }
+  writer_.FlushIfDue(monotonic_now_ns());
 }
 
 void RotatingFileSink::Flush()
 {
   if (fd_ >= 0)
   {
+    writer_.Flush();
     ::fdatasync(fd_);
   }
 }
 
+void RotatingFileSink::OnIdle() { writer_.Flush(); }
+
 }  // namespace br_logger
@@ -0,0 +1,163 @@
+#include "br_logger/tag_dictionary.hpp"
+
+#include <functional>
+
+namespace br_logger
+{
+
+namespace
+{
+
+// 每线程的直接映射缓存：命中时无需加锁，ScopedTag 反复使用同一组字符串时尤其有效
+constexpr size_t K_TLS_CACHE_SIZE = 64;
+
+struct InternCacheSlot
+{
+  size_t hash;
+  TagId id;
+};
+
+thread_local InternCacheSlot tls_intern_cache[K_TLS_CACHE_SIZE] = {};
+
+bool cached_id(const TagDictionary& dict, std::string_view str, size_t hash, TagId& id)
+{
+  const InternCacheSlot& slot = tls_intern_cache[hash % K_TLS_CACHE_SIZE];
+  if (slot.id != TagDictionary::K_EMPTY_ID && slot.hash == hash && dict.Resolve(slot.id) == str)
+  {
+    id = slot.id;
+    return true;
+  }
+  return false;
+}
+
+void cache_id(size_t hash, TagId id)
+{
+  InternCacheSlot& slot = tls_intern_cache[hash % K_TLS_CACHE_SIZE];
+  slot.hash = hash;
+  slot.id = id;
+}
+
+}  // namespace
+
+TagDictionary& TagDictionary::Instance()
+{
+  static TagDictionary dict;
+  return dict;
+}
+
+TagDictionary::TagDictionary()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  InternLocked("");
+  InternLocked("<tag dictionary full>");
+}
+
+TagId TagDictionary::Intern(std::string_view str)
+{
+  if (str.empty())
+  {
+    return K_EMPTY_ID;
+  }
+  size_t hash = std::hash<std::string_view>{}(str);
+  TagId id = K_OVERFLOW_ID;
+  if (cached_id(*this, str, hash, id))
+  {
+    return id;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    id = InternLocked(str);
+  }
+  if (id != K_OVERFLOW_ID)
+  {
+    cache_id(hash, id);
+  }
+  return id;
+}
+
+bool TagDictionary::InternValue(std::string_view str, TagId& id)
+{
+  if (str.empty())
+  {
+    id = K_EMPTY_ID;
+    return true;
+  }
+  size_t hash = std::hash<std::string_view>{}(str);
+  if (cached_id(*this, str, hash, id))
+  {
+    return true;
+  }
+
+  // 第一次出现的值不加锁：只记下哈希，由调用方内联携带
+  std::atomic<size_t>& seen = seen_once_[hash % K_SEEN_SLOTS];
+  if (seen.load(std::memory_order_relaxed) != hash)
+  {
+    seen.store(hash, std::memory_order_relaxed);
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(str);
+    id = it != index_.end() ? it->second : InternLocked(str);
+  }
+  if (id == K_OVERFLOW_ID)
+  {
+    return false;
+  }
+  cache_id(hash, id);
+  return true;
+}
+
+bool TagDictionary::Find(std::string_view str, TagId& id) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(str);
+  if (it == index_.end())
+  {
+    return false;
+  }
+  id = it->second;
+  return true;
+}
+
+std::string_view TagDictionary::Resolve(TagId id) const
+{
+  if (id >= size_.load(std::memory_order_acquire))
+  {
+    return {};
+  }
+  const Segment* segment = segments_[id / K_SEGMENT_SIZE].load(std::memory_order_acquire);
+  return segment->strings[id % K_SEGMENT_SIZE];
+}
+
+TagId TagDictionary::InternLocked(std::string_view str)
+{
+  auto it = index_.find(str);
+  if (it != index_.end())
+  {
+    return it->second;
+  }
+  size_t id = size_.load(std::memory_order_relaxed);
+  if (id >= K_MAX_SEGMENTS * K_SEGMENT_SIZE)
+  {
+    return K_OVERFLOW_ID;
+  }
+
+  Segment* segment = segments_[id / K_SEGMENT_SIZE].load(std::memory_order_relaxed);
+  if (segment == nullptr)
+  {
+    segment = new Segment();  // 与字典同生命周期，不释放
+    segments_[id / K_SEGMENT_SIZE].store(segment, std::memory_order_release);
+  }
+  const std::string& stored = storage_.emplace_back(str);
+  std::string_view view(stored);
+  segment->strings[id % K_SEGMENT_SIZE] = view;
+  index_.emplace(view, static_cast<TagId>(id));
+  // 先写好字符串再发布 size_，Resolve 据此判断 ID 是否有效
+  size_.store(id + 1, std::memory_order_release);
+  return static_cast<TagId>(id);
+}
+
+}  // namespace br_logger
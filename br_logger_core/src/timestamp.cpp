@@ -1,8 +1,11 @@
 #include "br_logger/timestamp.hpp"
 
-#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <string>
 
+#include "br_logger/number_format.hpp"
 #include "br_logger/platform.hpp"
 
 #if BR_LOG_EMBEDDED
@@ -106,27 +109,152 @@ uint64_t wall_clock_now_ns()
 namespace br_logger
 {
 
-static void decompose_wall_ns(uint64_t wall_ns, struct tm& tm_out, uint32_t& us_out)
+namespace
 {
-  time_t sec = static_cast<time_t>(wall_ns / 1'000'000'000ULL);
-  us_out = static_cast<uint32_t>((wall_ns % 1'000'000'000ULL) / 1'000ULL);
-  localtime_r(&sec, &tm_out);
+
+// 1970-01-01 起的天数换算为公历年月日（proleptic Gregorian），不加锁也不读时区
+void civil_from_days(int64_t days, int& year, unsigned& month, unsigned& day)
+{
+  days += 719468;
+  const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  const auto doe = static_cast<unsigned>(days - era * 146097);
+  const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const unsigned mp = (5 * doy + 2) / 153;
+  day = doy - (153 * mp + 2) / 5 + 1;
+  month = mp < 10 ? mp + 3 : mp - 9;
+  year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+int64_t days_from_civil(int year, unsigned month, unsigned day)
+{
+  year -= month <= 2 ? 1 : 0;
+  const int64_t era = (year >= 0 ? year : year - 399) / 400;
+  const auto yoe = static_cast<unsigned>(year - era * 400);
+  const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+int64_t floor_div(int64_t a, int64_t b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+inline void write_2digits(char* dst, unsigned v) { detail::format_fixed(dst, v, 2); }
+
+inline void write_micros(char* dst, uint64_t wall_ns)
+{
+  detail::format_fixed(dst, static_cast<uint32_t>((wall_ns / 1'000ULL) % 1'000'000ULL), 6);
+}
+
+// 每线程缓存最近一秒的本地日期与时间文本。UTC 偏移只在本地时间跨过整点（夏令时切换都发生在整点）
+// 或 TZ 环境变量变化时通过 localtime_r 重新查询，其余秒由偏移直接推算，不进入 glibc 的时区锁
+struct LocalTimeCache
+{
+  int64_t second = INT64_MIN;       // 已渲染的 UTC 秒
+  int64_t offset_hour = INT64_MIN;  // 查询偏移时所在的本地小时
+  int64_t offset = 0;               // 本地时间 - UTC，秒
+  bool tz_known = false;
+  std::string tz;                   // 上次看到的 TZ，未设置与空串分开记录
+  bool tz_set = false;
+  char date[10];                    // YYYY-MM-DD
+  char time[8];                     // HH:MM:SS
+};
+
+bool tz_changed(LocalTimeCache& cache)
+{
+  const char* tz = std::getenv("TZ");
+  bool set = tz != nullptr;
+  if (cache.tz_known && set == cache.tz_set && (!set || cache.tz == tz))
+  {
+    return false;
+  }
+  cache.tz_known = true;
+  cache.tz_set = set;
+  cache.tz = set ? tz : "";
+  return true;
+}
+
+void refresh_offset(LocalTimeCache& cache, int64_t sec)
+{
+  auto t = static_cast<time_t>(sec);
+  struct tm tm_val{};
+  localtime_r(&t, &tm_val);
+  int64_t local = days_from_civil(tm_val.tm_year + 1900, static_cast<unsigned>(tm_val.tm_mon + 1),
+                                  static_cast<unsigned>(tm_val.tm_mday)) *
+                      86400 +
+                  tm_val.tm_hour * 3600 + tm_val.tm_min * 60 + tm_val.tm_sec;
+  cache.offset = local - sec;
+  cache.offset_hour = floor_div(local, 3600);
+}
+
+const LocalTimeCache& local_time_for(uint64_t wall_ns)
+{
+  static thread_local LocalTimeCache cache;
+  auto sec = static_cast<int64_t>(wall_ns / 1'000'000'000ULL);
+  if (sec == cache.second)
+  {
+    return cache;
+  }
+  // TZ 每换一秒检查一次，修改后至多一秒生效
+  if (tz_changed(cache))
+  {
+    tzset();
+    cache.offset_hour = INT64_MIN;
+  }
+  int64_t local = sec + cache.offset;
+  if (floor_div(local, 3600) != cache.offset_hour)
+  {
+    refresh_offset(cache, sec);
+    local = sec + cache.offset;
+  }
+  int64_t days = floor_div(local, 86400);
+  auto tod = static_cast<unsigned>(local - days * 86400);
+  int year = 0;
+  unsigned month = 0;
+  unsigned day = 0;
+  civil_from_days(days, year, month, day);
+  detail::format_fixed(cache.date, static_cast<uint32_t>(year), 4);
+  cache.date[4] = '-';
+  write_2digits(cache.date + 5, month);
+  cache.date[7] = '-';
+  write_2digits(cache.date + 8, day);
+  write_2digits(cache.time, tod / 3600);
+  cache.time[2] = ':';
+  write_2digits(cache.time + 3, tod / 60 % 60);
+  cache.time[5] = ':';
+  write_2digits(cache.time + 6, tod % 60);
+  cache.second = sec;
+  return cache;
 }
 
+// 与 snprintf 相同的截断语义：放不下时写入 buf_size - 1 字节并补 '\0'
+size_t copy_out(const char* src, size_t len, char* buf, size_t buf_size)
+{
+  if (buf_size == 0)
+  {
+    return 0;
+  }
+  size_t n = len < buf_size ? len : buf_size - 1;
+  std::memcpy(buf, src, n);
+  buf[n] = '\0';
+  return n;
+}
+
+}  // namespace
+
 size_t format_timestamp(uint64_t wall_ns, char* buf, size_t buf_size)
 {
   if (buf_size == 0)
   {
     return 0;
   }
-  struct tm tm_val{};
-  uint32_t us = 0;
-  decompose_wall_ns(wall_ns, tm_val, us);
-  int n = snprintf(buf, buf_size, "%04d-%02d-%02d %02d:%02d:%02d.%06u",
-                   tm_val.tm_year + 1900, tm_val.tm_mon + 1, tm_val.tm_mday,
-                   tm_val.tm_hour, tm_val.tm_min, tm_val.tm_sec, us);
-  return (n > 0 && static_cast<size_t>(n) < buf_size) ? static_cast<size_t>(n)
-                                                      : (buf_size - 1);
+  const LocalTimeCache& cache = local_time_for(wall_ns);
+  char out[26];
+  std::memcpy(out, cache.date, 10);
+  out[10] = ' ';
+  std::memcpy(out + 11, cache.time, 8);
+  out[19] = '.';
+  write_micros(out + 20, wall_ns);
+  return copy_out(out, sizeof(out), buf, buf_size);
 }
 
 size_t format_date(uint64_t wall_ns, char* buf, size_t buf_size)
@@ -135,13 +263,7 @@ size_t format_date(uint64_t wall_ns, char* buf, size_t buf_size)
   {
     return 0;
   }
-  struct tm tm_val{};
-  uint32_t us = 0;
-  decompose_wall_ns(wall_ns, tm_val, us);
-  int n = snprintf(buf, buf_size, "%04d-%02d-%02d", tm_val.tm_year + 1900,
-                   tm_val.tm_mon + 1, tm_val.tm_mday);
-  return (n > 0 && static_cast<size_t>(n) < buf_size) ? static_cast<size_t>(n)
-                                                      : (buf_size - 1);
+  return copy_out(local_time_for(wall_ns).date, 10, buf, buf_size);
 }
 
 size_t format_time(uint64_t wall_ns, char* buf, size_t buf_size)
@@ -150,13 +272,28 @@ size_t format_time(uint64_t wall_ns, char* buf, size_t buf_size)
   {
     return 0;
   }
-  struct tm tm_val{};
-  uint32_t us = 0;
-  decompose_wall_ns(wall_ns, tm_val, us);
-  int n = snprintf(buf, buf_size, "%02d:%02d:%02d.%06u", tm_val.tm_hour, tm_val.tm_min,
-                   tm_val.tm_sec, us);
-  return (n > 0 && static_cast<size_t>(n) < buf_size) ? static_cast<size_t>(n)
-                                                      : (buf_size - 1);
+  char out[15];
+  std::memcpy(out, local_time_for(wall_ns).time, 8);
+  out[8] = '.';
+  write_micros(out + 9, wall_ns);
+  return copy_out(out, sizeof(out), buf, buf_size);
+}
+
+size_t format_clock_time(uint64_t wall_ns, char* buf, size_t buf_size)
+{
+  if (buf_size == 0)
+  {
+    return 0;
+  }
+  return copy_out(local_time_for(wall_ns).time, 8, buf, buf_size);
+}
+
+size_t format_micros(uint64_t wall_ns, char* buf, size_t buf_size)
+{
+  char out[7];
+  out[0] = '.';
+  write_micros(out + 1, wall_ns);
+  return copy_out(out, sizeof(out), buf, buf_size);
 }
 
 }  // namespace br_logger
@@ -1,12 +1,29 @@
 #include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <br_logger/clock_source.hpp>
+#include <br_logger/formatters/json_formatter.hpp>
 #include <br_logger/formatters/pattern_formatter.hpp>
+#include <br_logger/formatters/static_pattern_formatter.hpp>
+#include <br_logger/json_escape.hpp>
 #include <br_logger/log_context.hpp>
+#include <br_logger/log_record.hpp>
 #include <br_logger/logger.hpp>
+#include <br_logger/number_format.hpp>
+#include <br_logger/printf_format.hpp>
+#include <br_logger/ring_buffer.hpp>
 #include <br_logger/sinks/callback_sink.hpp>
+#include <br_logger/sinks/parallel_format_adapter.hpp>
+#include <br_logger/sinks/rotating_file_sink.hpp>
 #include <br_logger/sinks/sink_interface.hpp>
 #include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
 #include <vector>
 
 namespace
@@ -19,10 +36,12 @@ class NullSink : public br_logger::ILogSink
   void Flush() override {}
 };
 
-void setup_logger_with_null_sink()
+void setup_logger_with_null_sink(
+    br_logger::QueueTopology topology = br_logger::QueueTopology::SHARED_MPSC)
 {
   auto& logger = br_logger::Logger::Instance();
   logger.SetLevel(br_logger::LogLevel::TRACE);
+  logger.SetQueueTopology(topology);
   auto sink = std::make_unique<NullSink>();
   sink->SetFormatter(std::make_unique<br_logger::PatternFormatter>());
   logger.AddSink(std::move(sink));
@@ -46,11 +65,12 @@ static void bm_single_thread_log_info(benchmark::State& state)
 }
 BENCHMARK(bm_single_thread_log_info);
 
+// Arg: 0 = 共享 MPSC 队列，1 = 每线程 SPSC 队列，2 = 每 CPU rseq 队列
 static void bm_multi_thread_log_info(benchmark::State& state)
 {
   if (state.thread_index() == 0)
   {
-    setup_logger_with_null_sink();
+    setup_logger_with_null_sink(static_cast<br_logger::QueueTopology>(state.range(0)));
   }
 
   int i = 0;
@@ -65,7 +85,385 @@ static void bm_multi_thread_log_info(benchmark::State& state)
     teardown_logger();
   }
 }
-BENCHMARK(bm_multi_thread_log_info)->Threads(4);
+BENCHMARK(bm_multi_thread_log_info)
+    ->ArgName("topology")
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(8);
+
+// Arg: 0 = PRECISE，1 = COARSE，2 = TSC；对比旧实现的两次 clock_gettime
+static void bm_read_clock(benchmark::State& state)
+{
+  auto source = static_cast<br_logger::ClockSource>(state.range(0));
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(br_logger::read_clock(source));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_read_clock)->ArgName("clock")->Arg(0)->Arg(1)->Arg(2);
+
+static void bm_read_clock_legacy_pair(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(br_logger::monotonic_now_ns());
+    benchmark::DoNotOptimize(br_logger::wall_clock_now_ns());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_read_clock_legacy_pair);
+
+static void bm_single_thread_log_literal(benchmark::State& state)
+{
+  setup_logger_with_null_sink();
+  for (auto _ : state)
+  {
+    LOG_INFO("benchmark literal message without arguments");
+  }
+  state.SetItemsProcessed(state.iterations());
+  teardown_logger();
+}
+BENCHMARK(bm_single_thread_log_literal);
+
+// 业务线程写入一条记录的开销（不含后端）。Arg: 0 = 旧做法，先清零整个 LogEntry
+// 再填充并序列化进队列；1 = 当前做法，在队列预留的空间里只写用到的字段
+static void bm_stage_record(benchmark::State& state)
+{
+  using Ring = br_logger::MPSCByteRingBuffer<1u << 16>;
+  auto ring = std::make_unique<Ring>();
+  auto& ctx = br_logger::LogContext::Instance();
+  static const br_logger::LogSite site =
+      BR_LOG_MAKE_SITE(br_logger::LogLevel::INFO, "stage %d");
+  const bool legacy = state.range(0) == 0;
+  int i = 0;
+  for (auto _ : state)
+  {
+    if (legacy)
+    {
+      br_logger::LogEntry entry{};
+      entry.timestamp_ns = br_logger::monotonic_now_ns();
+      entry.level = site.level;
+      entry.site = &site;
+      entry.sequence_id = static_cast<uint64_t>(i);
+      ctx.FillTags(entry);
+      int n = std::snprintf(entry.msg, BR_LOG_MAX_MSG_LEN, site.fmt, i++);
+      entry.msg_len = static_cast<uint16_t>(n > 0 ? n : 0);
+      auto res = ring->TryReserve(static_cast<uint32_t>(br_logger::record_size(entry)));
+      br_logger::encode_record(entry, res.data);
+      Ring::Commit(res, static_cast<uint32_t>(br_logger::record_size(entry)));
+    }
+    else
+    {
+      char msg[BR_LOG_MAX_MSG_LEN];
+      int n = std::snprintf(msg, BR_LOG_MAX_MSG_LEN, site.fmt, i++);
+      size_t msg_len = n > 0 ? static_cast<size_t>(n) : 0;
+      size_t max_tags = ctx.TagCount();
+      size_t max_text = ctx.TagTextSize();
+      auto res = ring->TryReserve(
+          static_cast<uint32_t>(br_logger::record_size(max_tags, max_text, msg_len)));
+      auto* record = new (res.data) br_logger::LogRecord;
+      record->timestamp = br_logger::monotonic_now_ns();
+      record->clock = 0;
+      record->sequence_id = static_cast<uint64_t>(i);
+      record->site = &site;
+      record->format_fn = nullptr;
+      record->level = site.level;
+      record->msg_len = static_cast<uint16_t>(msg_len);
+      ctx.FillThreadInfo(*record);
+      auto* tags = reinterpret_cast<br_logger::LogTag*>(res.data + sizeof(*record));
+      size_t text_len = 0;
+      size_t tag_count = ctx.FillTags(tags, max_tags, reinterpret_cast<char*>(tags + max_tags),
+                                      max_text, text_len);
+      record->tag_count = static_cast<uint8_t>(tag_count);
+      record->tag_text_len = static_cast<uint16_t>(text_len);
+      std::memcpy(reinterpret_cast<char*>(tags + tag_count) + text_len, msg, msg_len);
+      Ring::Commit(res, static_cast<uint32_t>(
+                            br_logger::record_size(tag_count, text_len, msg_len)));
+    }
+    uint32_t size = 0;
+    benchmark::DoNotOptimize(ring->Peek(size));
+    ring->Release();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_stage_record)->ArgName("in_place")->Arg(0)->Arg(1);
+
+// 文件 Sink 每条日志的系统调用次数（写入 /dev/null）。Arg: 0 = 旧做法，每条先 write 正文
+// 再 write "\n"；1 = RotatingFileSink 按批格式化进写缓冲，达到阈值或空闲时一次写出
+static void bm_file_sink_syscalls(benchmark::State& state)
+{
+  br_logger::LogEntry entries[BR_LOG_DISPATCH_BATCH];
+  for (auto& entry : entries)
+  {
+    entry = br_logger::LogEntry{};
+    entry.level = br_logger::LogLevel::INFO;
+    entry.msg_len = static_cast<uint16_t>(
+        std::snprintf(entry.msg, sizeof(entry.msg), "file sink benchmark message %d", 42));
+  }
+  br_logger::PatternFormatter formatter("[%L] %m", false);
+  const bool legacy = state.range(0) == 0;
+  int fd = ::open("/dev/null", O_WRONLY);
+  br_logger::RotatingFileSink sink("/dev/null", SIZE_MAX, 1);
+  sink.SetFormatter(std::make_unique<br_logger::PatternFormatter>("[%L] %m", false));
+  uint64_t legacy_syscalls = 0;
+  char buf[2048];
+  for (auto _ : state)
+  {
+    if (legacy)
+    {
+      for (const auto& entry : entries)
+      {
+        size_t len = formatter.Format(entry, buf, sizeof(buf));
+        benchmark::DoNotOptimize(::write(fd, buf, len));
+        benchmark::DoNotOptimize(::write(fd, "\n", 1));
+        legacy_syscalls += 2;
+      }
+    }
+    else
+    {
+      sink.WriteBatch(entries, BR_LOG_DISPATCH_BATCH);
+    }
+  }
+  sink.OnIdle();
+  ::close(fd);
+  double entries_total = static_cast<double>(state.iterations()) * BR_LOG_DISPATCH_BATCH;
+  double syscalls =
+      legacy ? static_cast<double>(legacy_syscalls) : static_cast<double>(sink.WriterStats().syscalls);
+  state.counters["syscalls_per_entry"] = syscalls / entries_total;
+  state.SetItemsProcessed(static_cast<int64_t>(entries_total));
+}
+BENCHMARK(bm_file_sink_syscalls)->ArgName("buffered")->Arg(0)->Arg(1);
+
+// JsonFormatter 写 /dev/null：pool=0 为 Sink 在调用线程上自行格式化（现有路径），
+// pool=N 经 ParallelFormatAdapter 由 N 个线程并行格式化、调用线程按序写出
+static void bm_parallel_format(benchmark::State& state)
+{
+  br_logger::LogEntry entries[BR_LOG_DISPATCH_BATCH];
+  for (auto& entry : entries)
+  {
+    entry = br_logger::LogEntry{};
+    entry.level = br_logger::LogLevel::INFO;
+    entry.msg_len = static_cast<uint16_t>(std::snprintf(
+        entry.msg, sizeof(entry.msg),
+        "request \"%s\" finished\tstatus=%d path=C:\\data\\%d payload={\"k\":%d}", "GET /api",
+        200, 42, 7));
+  }
+  const auto pool = static_cast<uint32_t>(state.range(0));
+  auto file = std::make_unique<br_logger::RotatingFileSink>("/dev/null", SIZE_MAX, 1);
+  std::unique_ptr<br_logger::ILogSink> sink;
+  if (pool == 0)
+  {
+    file->SetFormatter(std::make_unique<br_logger::JsonFormatter>());
+    sink = std::move(file);
+  }
+  else
+  {
+    br_logger::ParallelFormatOptions options;
+    options.threads = pool;
+    sink = std::make_unique<br_logger::ParallelFormatAdapter>(
+        std::move(file), std::make_unique<br_logger::JsonFormatter>(), options);
+  }
+  for (auto _ : state)
+  {
+    sink->WriteBatch(entries, BR_LOG_DISPATCH_BATCH);
+  }
+  sink->OnIdle();
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * BR_LOG_DISPATCH_BATCH);
+}
+BENCHMARK(bm_parallel_format)->ArgName("pool")->Arg(0)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+// 默认模式（不含彩色）下单条格式化：static=0 为运行期解析的 PatternFormatter，
+// static=1 为编译期解析的 StaticPatternFormatter
+BR_LOG_STATIC_PATTERN_FORMATTER(BenchStaticPattern, "[%D %T%e] [%L] [tid:%t] [%f:%#::%n] %g %m");
+
+static void bm_pattern_format(benchmark::State& state)
+{
+  static constexpr br_logger::LogSite K_SITE{
+      "/src/main.cpp", "main.cpp", "process", "void process(int)",
+      42, 0, br_logger::LogLevel::INFO, "", 0};
+  br_logger::LogEntry entry{};
+  entry.wall_clock_ns = 1739692200123456000ULL;
+  entry.level = br_logger::LogLevel::INFO;
+  entry.site = &K_SITE;
+  entry.thread_id = 1234;
+  entry.msg_len = static_cast<uint16_t>(
+      std::snprintf(entry.msg, sizeof(entry.msg), "order %d filled at %.2f", 42, 3.5));
+  std::unique_ptr<br_logger::IFormatter> formatter;
+  if (state.range(0) == 0)
+  {
+    formatter = std::make_unique<br_logger::PatternFormatter>(BenchStaticPattern::Pattern(), false);
+  }
+  else
+  {
+    formatter = std::make_unique<BenchStaticPattern>(false);
+  }
+  char buf[512];
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(formatter->Format(entry, buf, sizeof(buf)));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(bm_pattern_format)->ArgName("static")->Arg(0)->Arg(1);
+
+// 单个数字字段的渲染开销：fast=0 为 snprintf，fast=1 为 number_format.hpp。
+// field：0 行号 (%u) / 1 线程 ID (%u) / 2 序列号 (PRIu64) / 3 微秒 (%06u) / 4 double (%.17g 与 to_chars)
+static void bm_render_field(benchmark::State& state)
+{
+  const auto field = state.range(0);
+  const bool fast = state.range(1) != 0;
+  uint64_t values[64];
+  double doubles[64];
+  for (uint64_t i = 0; i < 64; ++i)
+  {
+    const uint64_t scale[] = {1000, 4000000, 1ULL << 40, 1000000, 1};
+    values[i] = (i * 2654435761ULL) % scale[field];
+    doubles[i] = static_cast<double>(i) * 1.37 + 0.001;
+  }
+  char buf[48];
+  size_t i = 0;
+  for (auto _ : state)
+  {
+    const uint64_t value = values[i % 64];
+    size_t len = 0;
+    if (!fast)
+    {
+      int n = 0;
+      switch (field)
+      {
+        case 0:
+        case 1:
+          n = std::snprintf(buf, sizeof(buf), "%u", static_cast<uint32_t>(value));
+          break;
+        case 2:
+          n = std::snprintf(buf, sizeof(buf), "%" PRIu64, value);
+          break;
+        case 3:
+          n = std::snprintf(buf, sizeof(buf), "%06u", static_cast<uint32_t>(value));
+          break;
+        default:
+          n = std::snprintf(buf, sizeof(buf), "%.17g", doubles[i % 64]);
+          break;
+      }
+      len = static_cast<size_t>(n);
+    }
+    else
+    {
+      switch (field)
+      {
+        case 0:
+        case 1:
+        case 2:
+          len = br_logger::detail::format_uint(buf, value);
+          break;
+        case 3:
+          br_logger::detail::format_fixed(buf, static_cast<uint32_t>(value), 6);
+          len = 6;
+          break;
+        default:
+          len = br_logger::detail::format_double(buf, doubles[i % 64]);
+          break;
+      }
+    }
+    benchmark::DoNotOptimize(len);
+    benchmark::ClobberMemory();
+    ++i;
+  }
+}
+BENCHMARK(bm_render_field)
+    ->ArgNames({"field", "fast"})
+    ->ArgsProduct({{0, 1, 2, 3, 4}, {0, 1}});
+
+// 日志宏里的消息格式化：compiled=0 为 snprintf，compiled=1 为编译期解析的 format_printf
+struct BenchPrintfFormat
+{
+  static constexpr const char* value() { return "order %d filled at %.2f by %s (%zu left)"; }
+};
+
+static void bm_printf_format(benchmark::State& state)
+{
+  const bool compiled = state.range(0) != 0;
+  const char* users[] = {"alice", "bob", "carol", "dave"};
+  char buf[BR_LOG_MAX_MSG_LEN];
+  size_t i = 0;
+  for (auto _ : state)
+  {
+    const int id = static_cast<int>(i * 7919 % 100000);
+    const double price = static_cast<double>(i % 1000) * 0.25 + 0.125;
+    const char* user = users[i % 4];
+    const size_t left = i % 64;
+    size_t len = 0;
+    if (!compiled)
+    {
+      len = static_cast<size_t>(
+          std::snprintf(buf, sizeof(buf), BenchPrintfFormat::value(), id, price, user, left));
+    }
+    else
+    {
+      len = br_logger::detail::format_printf<BenchPrintfFormat>(buf, sizeof(buf), id, price,
+                                                                user, left);
+    }
+    benchmark::DoNotOptimize(len);
+    benchmark::ClobberMemory();
+    ++i;
+  }
+}
+BENCHMARK(bm_printf_format)->ArgName("compiled")->Arg(0)->Arg(1);
+
+// JsonFormatter 单条格式化（约 80 字节、含一处需转义字符的消息，两个标签）：pretty=0 紧凑，pretty=1 缩进
+static void bm_json_format(benchmark::State& state)
+{
+  static constexpr br_logger::LogSite K_SITE{
+      "/src/main.cpp", "main.cpp", "process", "void process(int)",
+      42, 0, br_logger::LogLevel::INFO, "", 0};
+  br_logger::LogEntry entry{};
+  entry.wall_clock_ns = 1739692200123456000ULL;
+  entry.level = br_logger::LogLevel::INFO;
+  entry.site = &K_SITE;
+  entry.thread_id = 1234;
+  entry.process_id = 5678;
+  entry.sequence_id = 1001;
+  std::strncpy(entry.thread_name, "worker", sizeof(entry.thread_name));
+  auto& dict = br_logger::TagDictionary::Instance();
+  entry.tag_count = 2;
+  entry.tags[0] = {dict.Intern("env"), dict.Intern("prod")};
+  entry.tags[1] = {dict.Intern("req"), dict.Intern("abc123")};
+  entry.msg_len = static_cast<uint16_t>(std::snprintf(
+      entry.msg, sizeof(entry.msg),
+      "order %d filled at %.2f by user \"%s\" on venue XNAS, %d shares remaining", 1234567,
+      101.25, "alice", 300));
+  br_logger::JsonFormatter formatter(state.range(0) != 0);
+  char buf[1024];
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(formatter.Format(entry, buf, sizeof(buf)));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(bm_json_format)->ArgName("pretty")->Arg(0)->Arg(1);
+
+// 约 80 字节消息的 JSON 转义：simd=0 为逐字节查表，simd=1 为按块检查（AVX2 / SSE2 / NEON）
+static void bm_json_escape(benchmark::State& state)
+{
+  const char* msg =
+      "order 1234567 filled at 101.25 by user \"alice\" on venue XNAS, 300 shares remaining";
+  const size_t len = std::strlen(msg);
+  const bool simd = state.range(0) != 0;
+  char buf[512];
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(simd ? br_logger::detail::escape_json(msg, len, buf, sizeof(buf))
+                                  : br_logger::detail::escape_json_scalar(msg, len, buf,
+                                                                          sizeof(buf)));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(bm_json_escape)->ArgName("simd")->Arg(0)->Arg(1);
 
 static void bm_compile_time_filtered(benchmark::State& state)
 {
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/br_logger/backend.hpp"
+#include "../include/br_logger/sinks/async_sink_adapter.hpp"
+#include "../include/br_logger/sinks/callback_sink.hpp"
+
+#if BR_LOG_HAS_THREAD
+
+using br_logger::AsyncSinkAdapter;
+using br_logger::AsyncSinkOptions;
+using br_logger::OverflowAction;
+
+namespace
+{
+
+constexpr br_logger::LogSite K_TEST_SITE{
+    "test.cpp", "test.cpp", "test_func", "void test_func()",
+    1, 0, br_logger::LogLevel::INFO, "", 0};
+
+br_logger::LogEntry make_entry(const std::string& msg)
+{
+  br_logger::LogEntry entry{};
+  entry.level = br_logger::LogLevel::INFO;
+  entry.site = &K_TEST_SITE;
+  entry.thread_id = 1;
+  entry.process_id = 1;
+  std::memcpy(entry.msg, msg.data(), msg.size());
+  entry.msg[msg.size()] = '\0';
+  entry.msg_len = static_cast<uint16_t>(msg.size());
+  return entry;
+}
+
+// 记录收到的消息；gate 关闭时回调一直阻塞，模拟卡住的 Sink
+struct GatedRecorder
+{
+  std::atomic<bool> open{true};
+  std::mutex mutex;
+  std::vector<std::string> received;
+
+  std::unique_ptr<br_logger::CallbackSink> MakeSink()
+  {
+    return std::make_unique<br_logger::CallbackSink>(
+        [this](const br_logger::LogEntry& e)
+        {
+          while (!open.load(std::memory_order_acquire))
+          {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+          }
+          std::lock_guard<std::mutex> lock(mutex);
+          received.emplace_back(e.msg, e.msg_len);
+        });
+  }
+
+  size_t Count()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return received.size();
+  }
+};
+
+}  // namespace
+
+TEST(AsyncSinkAdapter, FlushDeliversEverythingInOrder)
+{
+  GatedRecorder recorder;
+  AsyncSinkAdapter adapter(recorder.MakeSink());
+  std::vector<br_logger::LogEntry> entries;
+  for (int i = 0; i < 100; ++i)
+  {
+    entries.push_back(make_entry("msg " + std::to_string(i)));
+  }
+  adapter.WriteBatch(entries.data(), 60);
+  for (size_t i = 60; i < entries.size(); ++i)
+  {
+    adapter.Write(entries[i]);
+  }
+  adapter.Flush();
+
+  ASSERT_EQ(recorder.Count(), 100u);
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(recorder.received[i], "msg " + std::to_string(i));
+  }
+  EXPECT_EQ(adapter.Stats().enqueued, 100u);
+  EXPECT_EQ(adapter.Stats().dropped, 0u);
+}
+
+TEST(AsyncSinkAdapter, StuckSinkDropsInsteadOfBlockingProducer)
+{
+  GatedRecorder recorder;
+  recorder.open = false;
+  AsyncSinkAdapter adapter(recorder.MakeSink());
+
+  constexpr int K_COUNT = 20000;
+  auto entry = make_entry(std::string(100, 'x'));
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < K_COUNT; ++i)
+  {
+    adapter.Write(entry);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, std::chrono::seconds(2));
+
+  auto stats = adapter.Stats();
+  EXPECT_GT(stats.dropped, 0u);
+  EXPECT_EQ(stats.enqueued + stats.dropped, static_cast<uint64_t>(K_COUNT));
+
+  recorder.open = true;
+  adapter.Flush();
+  EXPECT_EQ(recorder.Count(), stats.enqueued);
+}
+
+TEST(AsyncSinkAdapter, BlockPolicyWaitsForSpace)
+{
+  GatedRecorder recorder;
+  recorder.open = false;
+  AsyncSinkOptions options;
+  options.overflow_action = OverflowAction::BLOCK;
+  AsyncSinkAdapter adapter(recorder.MakeSink(), options);
+
+  std::thread opener(
+      [&]()
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        recorder.open = true;
+      });
+  constexpr int K_COUNT = 20000;
+  auto entry = make_entry(std::string(100, 'x'));
+  for (int i = 0; i < K_COUNT; ++i)
+  {
+    adapter.Write(entry);
+  }
+  opener.join();
+  adapter.Flush();
+
+  EXPECT_EQ(adapter.Stats().dropped, 0u);
+  EXPECT_EQ(recorder.Count(), static_cast<size_t>(K_COUNT));
+}
+
+TEST(AsyncSinkAdapter, BoundedWaitTimesOut)
+{
+  GatedRecorder recorder;
+  recorder.open = false;
+  AsyncSinkOptions options;
+  options.overflow_action = OverflowAction::BOUNDED_WAIT;
+  options.wait_timeout_ns = 1'000'000;
+  AsyncSinkAdapter adapter(recorder.MakeSink(), options);
+
+  auto entry = make_entry(std::string(100, 'x'));
+  while (adapter.Stats().dropped == 0)
+  {
+    adapter.Write(entry);
+  }
+  EXPECT_EQ(adapter.Stats().wait_timeouts, 1u);
+  recorder.open = true;
+}
+
+TEST(AsyncSinkAdapter, SlowSinkDoesNotDelayOtherSinks)
+{
+  GatedRecorder slow;
+  slow.open = false;
+  GatedRecorder fast;
+  auto backend_ptr = std::make_unique<br_logger::LoggerBackend>();
+  auto& backend = *backend_ptr;
+  backend.AddSink(std::make_unique<AsyncSinkAdapter>(slow.MakeSink()));
+  backend.AddSink(fast.MakeSink());
+
+  for (int i = 0; i < 50; ++i)
+  {
+    backend.TryPush(make_entry("m" + std::to_string(i)));
+  }
+  EXPECT_EQ(backend.Drain(), 50u);
+  EXPECT_EQ(fast.Count(), 50u);
+  EXPECT_EQ(slow.Count(), 0u);
+
+  slow.open = true;
+  backend.Stop();  // 未启动时只取完残留并刷新各 Sink
+  EXPECT_EQ(slow.Count(), 50u);
+}
+
+#endif  // BR_LOG_HAS_THREAD
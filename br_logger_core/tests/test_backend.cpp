@@ -10,24 +10,38 @@
 #include "../include/br_logger/log_entry.hpp"
 #include "../include/br_logger/log_level.hpp"
 #include "../include/br_logger/sinks/callback_sink.hpp"
+#include "../include/br_logger/timestamp.hpp"
 
 #if BR_LOG_HAS_THREAD
 #include <chrono>
 #include <thread>
 #endif
 
+static constexpr br_logger::LogSite K_TEST_SITE{
+    "test.cpp", "test.cpp", "test_func", "void test_func()",
+    1, 0, br_logger::LogLevel::INFO, "", 0};
+
+// 按 backend 的背压策略写入一条 entry
+static bool push_with_policy(br_logger::LoggerBackend& backend, const br_logger::LogEntry& entry)
+{
+  uint32_t size = static_cast<uint32_t>(br_logger::record_size(entry));
+  auto reservation = backend.Reserve(size, entry.level);
+  if (!reservation)
+  {
+    return false;
+  }
+  br_logger::encode_record(entry, reservation.data);
+  backend.Commit(reservation, size);
+  return true;
+}
+
 static br_logger::LogEntry make_test_entry(
     br_logger::LogLevel level = br_logger::LogLevel::INFO,
     const char* msg = "test message")
 {
   br_logger::LogEntry entry{};
   entry.level = level;
-  entry.file_name = "test.cpp";
-  entry.file_path = "test.cpp";
-  entry.function_name = "test_func";
-  entry.pretty_function = "void test_func()";
-  entry.line = 1;
-  entry.column = 0;
+  entry.site = &K_TEST_SITE;
   entry.thread_id = 1;
   entry.process_id = 1;
   entry.tag_count = 0;
@@ -57,8 +71,9 @@ TEST(LoggerBackend, PushAndDrain)
   size_t drained = backend->Drain();
   EXPECT_EQ(drained, 2u);
   ASSERT_EQ(received.size(), 2u);
-  EXPECT_EQ(received[0], "hello");
-  EXPECT_EQ(received[1], "world");
+  // WARN 走高优先级通道，先于更早的 INFO 分发
+  EXPECT_EQ(received[0], "world");
+  EXPECT_EQ(received[1], "hello");
 }
 
 TEST(LoggerBackend, DrainMaxEntries)
@@ -129,6 +144,50 @@ TEST(LoggerBackend, DispatchToMultipleSinks)
   EXPECT_EQ(count2.load(), 2);
 }
 
+TEST(LoggerBackend, DrainDispatchesInBatches)
+{
+  struct BatchSink : br_logger::ILogSink
+  {
+    std::vector<size_t> batches;
+    std::vector<std::string> received;
+    void Write(const br_logger::LogEntry& e) override { WriteBatch(&e, 1); }
+    void WriteBatch(const br_logger::LogEntry* entries, size_t count) override
+    {
+      batches.push_back(count);
+      for (size_t i = 0; i < count; ++i)
+      {
+        received.emplace_back(entries[i].msg, entries[i].msg_len);
+      }
+    }
+    void Flush() override {}
+  };
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  auto sink = std::make_unique<BatchSink>();
+  BatchSink* batch_sink = sink.get();
+  backend->AddSink(std::move(sink));
+  // 默认实现逐条转给 Write
+  std::vector<std::string> single;
+  backend->AddSink(std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry& e) { single.emplace_back(e.msg, e.msg_len); }));
+
+  const size_t total = BR_LOG_DISPATCH_BATCH + 3;
+  for (size_t i = 0; i < total; ++i)
+  {
+    ASSERT_TRUE(backend->TryPush(make_test_entry(br_logger::LogLevel::INFO,
+                                                 std::to_string(i).c_str())));
+  }
+  EXPECT_EQ(backend->Drain(1024), total);
+  ASSERT_EQ(batch_sink->batches.size(), 2u);
+  EXPECT_EQ(batch_sink->batches[0], static_cast<size_t>(BR_LOG_DISPATCH_BATCH));
+  EXPECT_EQ(batch_sink->batches[1], 3u);
+  ASSERT_EQ(batch_sink->received.size(), total);
+  for (size_t i = 0; i < total; ++i)
+  {
+    EXPECT_EQ(batch_sink->received[i], std::to_string(i));
+  }
+  EXPECT_EQ(single, batch_sink->received);
+}
+
 TEST(LoggerBackend, RingFull)
 {
   auto backend = std::make_unique<br_logger::LoggerBackend>();
@@ -148,6 +207,137 @@ TEST(LoggerBackend, RingFull)
   EXPECT_TRUE(push_failed);
 }
 
+TEST(LoggerBackend, DropNewestCountedWhenFull)
+{
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  backend->AddSink(std::make_unique<br_logger::CallbackSink>([](const br_logger::LogEntry&) {}));
+  while (backend->TryPush(make_test_entry()))
+  {
+  }
+  while (backend->TryPush(make_test_entry(br_logger::LogLevel::ERROR)))
+  {
+  }
+  backend->ResetBackpressureStats();
+
+  // 后端线程未运行时等待类策略无法得到空间，同样退化为丢弃
+  auto policy = br_logger::BackpressurePolicy::Uniform(br_logger::OverflowAction::DROP_NEWEST);
+  policy.SetAction(br_logger::LogLevel::WARN, br_logger::OverflowAction::BLOCK);
+  backend->SetBackpressurePolicy(policy);
+  EXPECT_FALSE(push_with_policy(*backend, make_test_entry(br_logger::LogLevel::INFO)));
+  EXPECT_FALSE(push_with_policy(*backend, make_test_entry(br_logger::LogLevel::FATAL)));
+
+  auto stats = backend->GetBackpressureStats();
+  EXPECT_EQ(stats.dropped_newest, 2u);
+  EXPECT_EQ(stats.blocks, 0u);
+  EXPECT_EQ(backend->LaneDropCount(br_logger::QueueLane::NORMAL), 1u);
+  EXPECT_EQ(backend->LaneDropCount(br_logger::QueueLane::PRIORITY), 1u);
+  EXPECT_EQ(backend->GetBackpressurePolicy().Action(br_logger::LogLevel::ERROR),
+            br_logger::OverflowAction::BLOCK);
+}
+
+TEST(LoggerBackend, PriorityLaneSurvivesLowLevelFlood)
+{
+  std::vector<std::string> received;  // 先于 backend 声明：析构时 Stop 还会分发剩余记录
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  backend->AddSink(std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry& e) { received.emplace_back(e.msg, e.msg_len); }));
+
+  while (backend->TryPush(make_test_entry(br_logger::LogLevel::DEBUG, "flood")))
+  {
+  }
+  uint64_t flood_drops = backend->LaneDropCount(br_logger::QueueLane::NORMAL);
+  EXPECT_FALSE(backend->TryPush(make_test_entry(br_logger::LogLevel::INFO, "lost")));
+  EXPECT_TRUE(backend->TryPush(make_test_entry(br_logger::LogLevel::ERROR, "incident")));
+  EXPECT_EQ(backend->LaneDropCount(br_logger::QueueLane::NORMAL), flood_drops + 1);
+  EXPECT_EQ(backend->LaneDropCount(br_logger::QueueLane::PRIORITY), 0u);
+
+  // 高优先级记录在本轮 Drain 中最先分发
+  EXPECT_EQ(backend->Drain(1), 1u);
+  ASSERT_EQ(received.size(), 1u);
+  EXPECT_EQ(received[0], "incident");
+}
+
+TEST(LoggerBackend, OverflowSegmentsKeepOrderWhenRingFull)
+{
+  std::vector<std::string> received;
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  backend->AddSink(std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry& e) { received.emplace_back(e.msg, e.msg_len); }));
+  backend->SetOverflowCapacity(4 * BR_LOG_OVERFLOW_SEGMENT_BYTES);
+
+  size_t in_ring = 0;
+  while (backend->GetOverflowStats().spilled_records == 0)
+  {
+    ASSERT_TRUE(backend->TryPush(make_test_entry(br_logger::LogLevel::INFO,
+                                                 std::to_string(in_ring).c_str())));
+    ++in_ring;
+  }
+  // 溢出后的记录继续写入溢出链，直到超过链的总容量
+  size_t total = in_ring;
+  while (backend->TryPush(make_test_entry(br_logger::LogLevel::INFO,
+                                          std::to_string(total).c_str())))
+  {
+    ++total;
+  }
+  auto stats = backend->GetOverflowStats();
+  EXPECT_EQ(stats.capacity_bytes, 4u * BR_LOG_OVERFLOW_SEGMENT_BYTES);
+  EXPECT_EQ(stats.high_water_segments, 4u);
+  EXPECT_EQ(stats.spilled_records, total - in_ring + 1);
+  EXPECT_EQ(backend->LaneDropCount(br_logger::QueueLane::NORMAL), 1u);
+
+  while (backend->Drain(1024) > 0)
+  {
+  }
+  ASSERT_EQ(received.size(), total);
+  for (size_t i = 0; i < total; ++i)
+  {
+    ASSERT_EQ(received[i], std::to_string(i));
+  }
+  // 链取空后段被回收，新记录回到主队列
+  EXPECT_EQ(backend->GetOverflowStats().segments_in_use, 1u);
+  EXPECT_TRUE(backend->TryPush(make_test_entry()));
+  EXPECT_EQ(backend->GetOverflowStats().spilled_records, stats.spilled_records);
+}
+
+TEST(LoggerBackend, RingTakesRecordsOnceOverflowChainIsFull)
+{
+  std::vector<std::string> received;
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  backend->AddSink(std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry& e) { received.emplace_back(e.msg, e.msg_len); }));
+  backend->SetOverflowCapacity(2 * BR_LOG_OVERFLOW_SEGMENT_BYTES);
+
+  auto numbered = [](size_t i)
+  {
+    auto entry = make_test_entry(br_logger::LogLevel::INFO, std::to_string(i).c_str());
+    entry.timestamp_ns = i;
+    entry.sequence_id = i;
+    return entry;
+  };
+  size_t total = 0;
+  while (backend->TryPush(numbered(total)))
+  {
+    ++total;
+  }
+  ASSERT_GT(backend->GetOverflowStats().spilled_records, 0u);
+
+  // 主队列腾出空间后，链虽仍写满，新记录也不再被丢弃
+  ASSERT_EQ(backend->Drain(8), 8u);
+  for (int i = 0; i < 8; ++i)
+  {
+    ASSERT_TRUE(backend->TryPush(numbered(total)));
+    ++total;
+  }
+  while (backend->Drain(1024) > 0)
+  {
+  }
+  ASSERT_EQ(received.size(), total);
+  for (size_t i = 0; i < total; ++i)
+  {
+    ASSERT_EQ(received[i], std::to_string(i));
+  }
+}
+
 TEST(LoggerBackend, StopFlushes)
 {
   auto backend = std::make_unique<br_logger::LoggerBackend>();
@@ -206,4 +396,610 @@ TEST(LoggerBackend, WorkerThreadConsumes)
   EXPECT_EQ(count.load(), 30);
   backend->Stop();
 }
+
+// 等待 count 达到 expected，超时返回 false
+static bool wait_for_count(const std::atomic<int>& count, int expected,
+                           std::chrono::milliseconds timeout)
+{
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (count.load(std::memory_order_acquire) < expected)
+  {
+    if (std::chrono::steady_clock::now() > deadline)
+    {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+TEST(LoggerBackend, BlockingWorkerWakesOnCommit)
+{
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  EXPECT_EQ(backend->GetIdleStrategy(), br_logger::IdleStrategy::BLOCKING);
+  std::atomic<int> count{0};
+  backend->AddSink(std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry&) { count.fetch_add(1, std::memory_order_release); }));
+  backend->Start();
+
+  // 空闲一段时间让后端睡眠，之后每条记录都应唤醒它
+  for (int i = 1; i <= 3; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_TRUE(backend->TryPush(make_test_entry(i == 2 ? br_logger::LogLevel::ERROR
+                                                        : br_logger::LogLevel::INFO)));
+    EXPECT_TRUE(wait_for_count(count, i, std::chrono::seconds(2)));
+  }
+  backend->Stop();
+}
+
+TEST(LoggerBackend, IdleStrategySwitchAtRuntime)
+{
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  std::atomic<int> count{0};
+  backend->AddSink(std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry&) { count.fetch_add(1, std::memory_order_release); }));
+  backend->SetIdleStrategy(br_logger::IdleStrategy::BUSY_SPIN);
+  backend->Start();
+  ASSERT_TRUE(backend->TryPush(make_test_entry()));
+  EXPECT_TRUE(wait_for_count(count, 1, std::chrono::seconds(2)));
+
+  backend->SetIdleStrategy(br_logger::IdleStrategy::BLOCKING);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_TRUE(backend->TryPush(make_test_entry()));
+  EXPECT_TRUE(wait_for_count(count, 2, std::chrono::seconds(2)));
+
+  // 睡眠中的后端切换为 BUSY_SPIN 后被唤醒，不再依赖提交时的通知
+  backend->SetIdleStrategy(br_logger::IdleStrategy::BUSY_SPIN);
+  ASSERT_TRUE(backend->TryPush(make_test_entry()));
+  EXPECT_TRUE(wait_for_count(count, 3, std::chrono::seconds(2)));
+  backend->Stop();
+}
+
+TEST(LoggerBackend, StartAppliesThreadOptions)
+{
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  std::atomic<int> count{0};
+  backend->AddSink(std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry&) { count.fetch_add(1, std::memory_order_release); }));
+
+  br_logger::BackendOptions options;
+  options.idle_strategy = br_logger::IdleStrategy::HYBRID;
+  options.spin_iterations = 16;
+  options.yield_iterations = 16;
+  options.sleep_ns = 50'000;
+  options.cpu_affinity = {0};
+  options.sched_class = br_logger::SchedClass::BATCH;
+  options.thread_name = "br_log_test_worker";
+  auto applied = backend->Start(options);
+  EXPECT_EQ(applied.idle_strategy, br_logger::IdleStrategy::HYBRID);
+#if defined(BR_LOG_PLATFORM_LINUX)
+  EXPECT_TRUE(applied.affinity_applied);
+  EXPECT_TRUE(applied.sched_class_applied);
+  EXPECT_TRUE(applied.thread_name_applied);
+#endif
+  // 重复 Start 不改变设置
+  EXPECT_EQ(backend->Start(br_logger::BackendOptions{}).idle_strategy,
+            br_logger::IdleStrategy::HYBRID);
+  EXPECT_EQ(backend->GetAppliedOptions().idle_strategy, br_logger::IdleStrategy::HYBRID);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  ASSERT_TRUE(backend->TryPush(make_test_entry()));
+  EXPECT_TRUE(wait_for_count(count, 1, std::chrono::seconds(2)));
+  backend->Stop();
+}
+
+TEST(LoggerBackend, StartReportsRejectedAffinity)
+{
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  br_logger::BackendOptions options;
+  options.cpu_affinity = {-1};
+  options.thread_name = nullptr;
+  auto applied = backend->Start(options);
+  EXPECT_FALSE(applied.affinity_applied);
+  EXPECT_FALSE(applied.sched_class_applied);
+  EXPECT_FALSE(applied.thread_name_applied);
+  EXPECT_EQ(applied.idle_strategy, br_logger::IdleStrategy::BLOCKING);
+  backend->Stop();
+}
+
+namespace
+{
+
+// 记录收到的消息与调用线程；每个 Sink 只会在一个线程上被调用
+struct ShardRecorder
+{
+  std::vector<std::string> received;
+  std::thread::id thread;
+  int stall_every = 0;  // 每收到这么多条暂停 1ms，让该分片落后
+
+  std::unique_ptr<br_logger::CallbackSink> MakeSink()
+  {
+    return std::make_unique<br_logger::CallbackSink>(
+        [this](const br_logger::LogEntry& e)
+        {
+          thread = std::this_thread::get_id();
+          received.emplace_back(e.msg, e.msg_len);
+          if (stall_every > 0 && received.size() % stall_every == 0)
+          {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          }
+        });
+  }
+};
+
+}  // namespace
+
+TEST(LoggerBackend, ShardedWorkersKeepOrderPerSink)
+{
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  backend->SetBackpressurePolicy(
+      br_logger::BackpressurePolicy::Uniform(br_logger::OverflowAction::BLOCK));
+  ShardRecorder recorders[4];
+  recorders[1].stall_every = 200;
+  for (auto& recorder : recorders)
+  {
+    backend->AddSink(recorder.MakeSink());
+  }
+  br_logger::BackendOptions options;
+  options.worker_count = 3;
+  options.thread_name = nullptr;
+  EXPECT_EQ(backend->Start(options).worker_count, 3u);
+
+  constexpr int K_COUNT = 3000;
+  for (int i = 0; i < K_COUNT; ++i)
+  {
+    std::string msg = "m" + std::to_string(i);
+    ASSERT_TRUE(push_with_policy(*backend, make_test_entry(br_logger::LogLevel::INFO, msg.c_str())));
+  }
+  backend->Stop();
+
+  for (auto& recorder : recorders)
+  {
+    ASSERT_EQ(recorder.received.size(), static_cast<size_t>(K_COUNT));
+    for (int i = 0; i < K_COUNT; ++i)
+    {
+      ASSERT_EQ(recorder.received[i], "m" + std::to_string(i));
+    }
+  }
+  // 轮流分配：0、3 号 Sink 在取队列的线程上，1、2 号各自在分片线程上
+  EXPECT_EQ(recorders[0].thread, recorders[3].thread);
+  EXPECT_NE(recorders[0].thread, recorders[1].thread);
+  EXPECT_NE(recorders[0].thread, recorders[2].thread);
+  EXPECT_NE(recorders[1].thread, recorders[2].thread);
+}
+
+TEST(LoggerBackend, ExplicitShardsSkipEmptyWorkers)
+{
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  ShardRecorder a;
+  ShardRecorder b;
+  backend->AddSink(a.MakeSink(), 2);
+  backend->AddSink(b.MakeSink(), 6);  // 对线程数取模后同为 2 号分片
+  br_logger::BackendOptions options;
+  options.worker_count = 4;
+  EXPECT_EQ(backend->Start(options).worker_count, 2u);
+  for (int i = 0; i < 10; ++i)
+  {
+    ASSERT_TRUE(backend->TryPush(make_test_entry()));
+  }
+  backend->Stop();
+  EXPECT_EQ(a.received.size(), 10u);
+  EXPECT_EQ(b.received.size(), 10u);
+  EXPECT_EQ(a.thread, b.thread);
+
+  // 停止后回到单线程，Drain 在调用线程上写全部 Sink
+  ASSERT_TRUE(backend->TryPush(make_test_entry()));
+  EXPECT_EQ(backend->Drain(), 1u);
+  EXPECT_EQ(a.received.size(), 11u);
+  EXPECT_EQ(a.thread, std::this_thread::get_id());
+}
+
+namespace
+{
+
+// sink 在 open 之前一直阻塞，用来让后端线程停住、队列被写满
+struct GatedBackend
+{
+  std::unique_ptr<br_logger::LoggerBackend> backend = std::make_unique<br_logger::LoggerBackend>();
+  std::atomic<bool> open{false};
+  std::atomic<bool> entered{false};
+  std::atomic<bool> filled{false};
+  std::atomic<int> delivered{0};
+
+  explicit GatedBackend(size_t overflow_bytes = 0)
+  {
+    backend->SetOverflowCapacity(overflow_bytes);
+    backend->AddSink(std::make_unique<br_logger::CallbackSink>(
+        [this](const br_logger::LogEntry&)
+        {
+          entered.store(true, std::memory_order_release);
+          while (!open.load(std::memory_order_acquire))
+          {
+            std::this_thread::yield();
+          }
+          delivered.fetch_add(1, std::memory_order_relaxed);
+        }));
+    backend->Start();
+  }
+
+  // 等后端线程停在 sink 里之后再写满队列，返回写入的条数
+  int Fill()
+  {
+    int pushed = 0;
+    do
+    {
+      while (backend->TryPush(make_test_entry()))
+      {
+        ++pushed;
+      }
+      std::this_thread::yield();
+    } while (!entered.load(std::memory_order_acquire));
+    // 两个通道都写满
+    for (auto level : {br_logger::LogLevel::INFO, br_logger::LogLevel::ERROR})
+    {
+      while (backend->TryPush(make_test_entry(level)))
+      {
+        ++pushed;
+      }
+    }
+    filled.store(true, std::memory_order_release);
+    return pushed;
+  }
+
+  // 在写满之后才打开 sink，否则 Fill 可能一直追不上消费者
+  void OpenAfterFill(std::chrono::milliseconds delay)
+  {
+    while (!filled.load(std::memory_order_acquire))
+    {
+      std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(delay);
+  }
+};
+
+}  // namespace
+
+TEST(LoggerBackend, BlockPolicyWaitsForSpace)
+{
+  GatedBackend gated;
+  auto policy = br_logger::BackpressurePolicy::Uniform(br_logger::OverflowAction::BLOCK);
+  gated.backend->SetBackpressurePolicy(policy);
+
+  std::atomic<bool> done{false};
+  int pushed = 0;
+  bool ok = false;
+  std::thread producer(
+      [&]()
+      {
+        pushed = gated.Fill();
+        ok = push_with_policy(*gated.backend, make_test_entry(br_logger::LogLevel::FATAL));
+        done.store(true, std::memory_order_release);
+      });
+  gated.OpenAfterFill(std::chrono::milliseconds(50));
+  EXPECT_FALSE(done.load(std::memory_order_acquire));
+
+  gated.open.store(true, std::memory_order_release);
+  producer.join();
+  gated.backend->Stop();
+
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(gated.delivered.load(), pushed + 1);
+  auto stats = gated.backend->GetBackpressureStats();
+  EXPECT_EQ(stats.blocks, 1u);
+  EXPECT_EQ(stats.dropped_newest, 0u);
+  EXPECT_GT(stats.wait_ns, 0u);
+}
+
+TEST(LoggerBackend, OverflowDrainsWhileProducing)
+{
+  GatedBackend gated(2 * BR_LOG_OVERFLOW_SEGMENT_BYTES);
+  int pushed = 0;
+  std::thread producer([&]() { pushed = gated.Fill(); });
+  gated.OpenAfterFill(std::chrono::milliseconds(0));
+  gated.open.store(true, std::memory_order_release);
+  producer.join();
+  // 消费者取空溢出链后生产者回到主队列
+  for (int i = 0; i < 1000; ++i)
+  {
+    if (gated.backend->TryPush(make_test_entry()))
+    {
+      ++pushed;
+    }
+  }
+  gated.backend->Stop();
+
+  EXPECT_EQ(gated.delivered.load(), pushed);
+  auto stats = gated.backend->GetOverflowStats();
+  EXPECT_GT(stats.spilled_records, 0u);
+  EXPECT_EQ(stats.high_water_segments, 2u);
+}
+
+TEST(LoggerBackend, BoundedWaitTimesOut)
+{
+  GatedBackend gated;
+  auto policy = br_logger::BackpressurePolicy::Uniform(br_logger::OverflowAction::BOUNDED_WAIT);
+  policy.wait_timeout_ns = 2'000'000;
+  gated.backend->SetBackpressurePolicy(policy);
+
+  bool ok = true;
+  std::thread producer(
+      [&]()
+      {
+        gated.Fill();
+        ok = push_with_policy(*gated.backend, make_test_entry(br_logger::LogLevel::WARN));
+      });
+  producer.join();
+  gated.open.store(true, std::memory_order_release);
+  gated.backend->Stop();
+
+  EXPECT_FALSE(ok);
+  auto stats = gated.backend->GetBackpressureStats();
+  EXPECT_EQ(stats.bounded_waits, 1u);
+  EXPECT_EQ(stats.wait_timeouts, 1u);
+  EXPECT_GE(stats.wait_ns, 2'000'000u);
+}
+
+TEST(LoggerBackend, DropOldestDiscardsQueuedRecords)
+{
+  GatedBackend gated;
+  auto policy = br_logger::BackpressurePolicy::Uniform(br_logger::OverflowAction::DROP_OLDEST);
+  policy.wait_timeout_ns = 5'000'000'000ULL;
+  gated.backend->SetBackpressurePolicy(policy);
+
+  int pushed = 0;
+  bool ok = false;
+  std::thread producer(
+      [&]()
+      {
+        pushed = gated.Fill();
+        // 丢弃请求只作用于普通通道
+        ok = push_with_policy(*gated.backend, make_test_entry(br_logger::LogLevel::INFO));
+      });
+  gated.OpenAfterFill(std::chrono::milliseconds(20));
+  gated.open.store(true, std::memory_order_release);
+  producer.join();
+  gated.backend->Stop();
+
+  EXPECT_TRUE(ok);
+  auto stats = gated.backend->GetBackpressureStats();
+  EXPECT_GE(stats.dropped_oldest, 1u);
+  EXPECT_EQ(static_cast<uint64_t>(gated.delivered.load()) + stats.dropped_oldest,
+            static_cast<uint64_t>(pushed) + 1);
+}
+#endif
+
+#if BR_LOG_HAS_THREAD
+TEST(LoggerBackend, PerThreadQueuesMergeByTimestamp)
+{
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  backend->SetQueueTopology(br_logger::QueueTopology::PER_THREAD_SPSC);
+  std::vector<uint64_t> timestamps;
+  auto sink = std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry& e) { timestamps.push_back(e.timestamp_ns); });
+  backend->AddSink(std::move(sink));
+
+  // 两个线程交错的时间戳，分别进入各自的队列
+  constexpr int K_PER_THREAD = 50;
+  auto produce = [&](uint64_t offset)
+  {
+    for (int i = 0; i < K_PER_THREAD; ++i)
+    {
+      auto entry = make_test_entry();
+      entry.timestamp_ns = offset + static_cast<uint64_t>(i) * 2;
+      ASSERT_TRUE(backend->TryPush(entry));
+    }
+  };
+  std::thread t1(produce, 0);
+  std::thread t2(produce, 1);
+  t1.join();
+  t2.join();
+  EXPECT_EQ(backend->ThreadQueueCount(), 2u);
+
+  while (backend->Drain() > 0)
+  {
+  }
+  ASSERT_EQ(timestamps.size(), static_cast<size_t>(2 * K_PER_THREAD));
+  for (size_t i = 0; i < timestamps.size(); ++i)
+  {
+    EXPECT_EQ(timestamps[i], i);
+  }
+  // 线程已退出且队列已取空，队列被回收
+  EXPECT_EQ(backend->ThreadQueueCount(), 0u);
+}
+
+TEST(LoggerBackend, PerThreadQueuesMergeAcrossClockDomains)
+{
+  if (!br_logger::clock_source_available(br_logger::ClockSource::TSC))
+  {
+    GTEST_SKIP() << "invariant TSC not available";
+  }
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  backend->SetQueueTopology(br_logger::QueueTopology::PER_THREAD_SPSC);
+  std::vector<std::string> messages;
+  auto sink = std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry& e) { messages.emplace_back(e.msg, e.msg_len); });
+  backend->AddSink(std::move(sink));
+
+  // 一个线程写 TSC 原始计数，另一个线程写纳秒，两者轮流写入
+  constexpr int K_ROUNDS = 4;
+  std::atomic<int> turn{0};
+  auto produce = [&](int parity, bool tsc)
+  {
+    for (int i = 0; i < K_ROUNDS; ++i)
+    {
+      int step = i * 2 + parity;
+      while (turn.load(std::memory_order_acquire) != step)
+      {
+        std::this_thread::yield();
+      }
+      std::string msg = std::to_string(step);
+      auto entry = make_test_entry(br_logger::LogLevel::INFO, msg.c_str());
+      entry.timestamp_ns = br_logger::monotonic_now_ns();
+      uint32_t size = static_cast<uint32_t>(br_logger::record_size(entry));
+      auto reservation = backend->TryReserve(size);
+      ASSERT_TRUE(reservation);
+      br_logger::encode_record(entry, reservation.data);
+      if (tsc)
+      {
+        auto* record = reinterpret_cast<br_logger::LogRecord*>(reservation.data);
+        record->clock = static_cast<uint8_t>(br_logger::ClockSource::TSC);
+        record->timestamp = br_logger::read_clock(br_logger::ClockSource::TSC);
+      }
+      backend->Commit(reservation, size);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      turn.store(step + 1, std::memory_order_release);
+    }
+  };
+  std::thread t1(produce, 0, true);
+  std::thread t2(produce, 1, false);
+  t1.join();
+  t2.join();
+
+  while (backend->Drain() > 0)
+  {
+  }
+  ASSERT_EQ(messages.size(), static_cast<size_t>(2 * K_ROUNDS));
+  for (size_t i = 0; i < messages.size(); ++i)
+  {
+    EXPECT_EQ(messages[i], std::to_string(i));
+  }
+}
+
+TEST(LoggerBackend, PerThreadQueueRegisteredOncePerThread)
+{
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  backend->SetQueueTopology(br_logger::QueueTopology::PER_THREAD_SPSC);
+  std::atomic<int> count{0};
+  auto sink = std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry&) { count.fetch_add(1, std::memory_order_relaxed); });
+  backend->AddSink(std::move(sink));
+
+  for (int i = 0; i < 10; ++i)
+  {
+    ASSERT_TRUE(backend->TryPush(make_test_entry()));
+  }
+  EXPECT_EQ(backend->ThreadQueueCount(), 1u);
+  EXPECT_EQ(backend->Drain(), 10u);
+  // 当前线程仍存活，队列保留
+  EXPECT_EQ(backend->ThreadQueueCount(), 1u);
+  EXPECT_EQ(count.load(), 10);
+}
+
+TEST(LoggerBackend, PerThreadQueuesWithWorker)
+{
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  backend->SetQueueTopology(br_logger::QueueTopology::PER_THREAD_SPSC);
+  std::atomic<int> count{0};
+  auto sink = std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry&) { count.fetch_add(1, std::memory_order_relaxed); });
+  backend->AddSink(std::move(sink));
+  backend->Start();
+
+  constexpr int K_THREADS = 4;
+  constexpr int K_PER_THREAD = 2000;
+  std::vector<std::thread> producers;
+  for (int t = 0; t < K_THREADS; ++t)
+  {
+    producers.emplace_back(
+        [&]()
+        {
+          for (int i = 0; i < K_PER_THREAD; ++i)
+          {
+            while (!backend->TryPush(make_test_entry()))
+            {
+              std::this_thread::yield();
+            }
+          }
+        });
+  }
+  for (auto& thread : producers)
+  {
+    thread.join();
+  }
+  backend->Stop();
+  EXPECT_EQ(count.load(), K_THREADS * K_PER_THREAD);
+  EXPECT_EQ(backend->ThreadQueueCount(), 0u);
+}
+#endif
+
+TEST(LoggerBackend, PerCpuTopologyFallsBackWithoutRseq)
+{
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  backend->SetQueueTopology(br_logger::QueueTopology::PER_CPU_RSEQ);
+  if (br_logger::PerCpuRing::Available())
+  {
+    EXPECT_EQ(backend->GetQueueTopology(), br_logger::QueueTopology::PER_CPU_RSEQ);
+  }
+  else
+  {
+    EXPECT_EQ(backend->GetQueueTopology(), br_logger::QueueTopology::SHARED_MPSC);
+  }
+
+  std::vector<std::string> received;
+  auto sink = std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry& e) { received.emplace_back(e.msg, e.msg_len); });
+  backend->AddSink(std::move(sink));
+  ASSERT_TRUE(backend->TryPush(make_test_entry(br_logger::LogLevel::INFO, "first")));
+  ASSERT_TRUE(backend->TryPush(make_test_entry(br_logger::LogLevel::INFO, "second")));
+  EXPECT_EQ(backend->Drain(), 2u);
+  ASSERT_EQ(received.size(), 2u);
+  EXPECT_EQ(received[0], "first");
+  EXPECT_EQ(received[1], "second");
+}
+
+#if BR_LOG_HAS_THREAD
+TEST(LoggerBackend, PerCpuQueuesMultiProducer)
+{
+  if (!br_logger::PerCpuRing::Available())
+  {
+    GTEST_SKIP() << "rseq not available";
+  }
+  auto backend = std::make_unique<br_logger::LoggerBackend>();
+  backend->SetQueueTopology(br_logger::QueueTopology::PER_CPU_RSEQ);
+  constexpr int K_THREADS = 4;
+  constexpr int K_PER_THREAD = 5000;
+  std::vector<int> next(K_THREADS, 0);
+  bool in_order = true;
+  auto sink = std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry& e)
+      {
+        int thread = static_cast<int>(e.thread_id);
+        int seq = static_cast<int>(e.sequence_id);
+        in_order = in_order && seq == next[thread];
+        next[thread] = seq + 1;
+      });
+  backend->AddSink(std::move(sink));
+  backend->Start();
+
+  std::vector<std::thread> producers;
+  for (int t = 0; t < K_THREADS; ++t)
+  {
+    producers.emplace_back(
+        [&backend, t]()
+        {
+          for (int i = 0; i < K_PER_THREAD; ++i)
+          {
+            auto entry = make_test_entry();
+            entry.thread_id = static_cast<uint32_t>(t);
+            entry.sequence_id = static_cast<uint64_t>(i);
+            entry.timestamp_ns = br_logger::monotonic_now_ns();
+            while (!backend->TryPush(entry))
+            {
+              std::this_thread::yield();
+            }
+          }
+        });
+  }
+  for (auto& thread : producers)
+  {
+    thread.join();
+  }
+  backend->Stop();
+  EXPECT_TRUE(in_order);
+  for (int t = 0; t < K_THREADS; ++t)
+  {
+    EXPECT_EQ(next[t], K_PER_THREAD);
+  }
+}
 #endif
@@ -8,6 +8,10 @@
 #include "../include/br_logger/log_level.hpp"
 #include "../include/br_logger/sinks/callback_sink.hpp"
 
+static constexpr br_logger::LogSite K_TEST_SITE{
+    "/src/main.cpp", "main.cpp", "process", "void process(int)",
+    42, 0, br_logger::LogLevel::INFO, "", 0};
+
 static br_logger::LogEntry make_test_entry(
     br_logger::LogLevel level = br_logger::LogLevel::INFO,
     const char* msg = "test message")
@@ -16,12 +20,7 @@ static br_logger::LogEntry make_test_entry(
   entry.wall_clock_ns = 1739692200123456000ULL;
   entry.timestamp_ns = 123456789ULL;
   entry.level = level;
-  entry.file_path = "/src/main.cpp";
-  entry.file_name = "main.cpp";
-  entry.function_name = "process";
-  entry.pretty_function = "void process(int)";
-  entry.line = 42;
-  entry.column = 0;
+  entry.site = &K_TEST_SITE;
   entry.thread_id = 1234;
   entry.process_id = 5678;
   std::strncpy(entry.thread_name, "worker", sizeof(entry.thread_name));
@@ -53,9 +52,10 @@ TEST(CallbackSink, LogEntryFieldsPassedCorrectly)
   EXPECT_EQ(captured.level, br_logger::LogLevel::WARN);
   EXPECT_EQ(std::string(captured.msg, captured.msg_len), "hello world");
   EXPECT_EQ(captured.thread_id, 1234u);
-  EXPECT_EQ(captured.line, 42u);
-  EXPECT_STREQ(captured.file_name, "main.cpp");
-  EXPECT_STREQ(captured.function_name, "process");
+  ASSERT_NE(captured.site, nullptr);
+  EXPECT_EQ(captured.site->line, 42u);
+  EXPECT_STREQ(captured.site->file_name, "main.cpp");
+  EXPECT_STREQ(captured.site->function_name, "process");
   EXPECT_EQ(captured.sequence_id, 1001u);
 }
 
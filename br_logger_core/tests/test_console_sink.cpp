@@ -15,6 +15,10 @@
 #include <unistd.h>
 #endif
 
+static constexpr br_logger::LogSite K_TEST_SITE{
+    "/src/main.cpp", "main.cpp", "process", "void process(int)",
+    42, 0, br_logger::LogLevel::INFO, "", 0};
+
 static br_logger::LogEntry make_test_entry(
     br_logger::LogLevel level = br_logger::LogLevel::INFO)
 {
@@ -22,12 +26,7 @@ static br_logger::LogEntry make_test_entry(
   entry.wall_clock_ns = 1739692200123456000ULL;
   entry.timestamp_ns = 123456789ULL;
   entry.level = level;
-  entry.file_path = "/src/main.cpp";
-  entry.file_name = "main.cpp";
-  entry.function_name = "process";
-  entry.pretty_function = "void process(int)";
-  entry.line = 42;
-  entry.column = 0;
+  entry.site = &K_TEST_SITE;
   entry.thread_id = 1234;
   entry.process_id = 5678;
   std::strncpy(entry.thread_name, "worker", sizeof(entry.thread_name));
@@ -279,3 +278,23 @@ TEST(ConsoleSink, ColorDisabledOutput)
 
   EXPECT_EQ(stdout_output.find("\033["), std::string::npos);
 }
+
+TEST(ConsoleSink, WriteFormattedSplitsRunsByStream)
+{
+  br_logger::ConsoleSink sink(false);
+  br_logger::LogEntry entries[] = {make_test_entry(br_logger::LogLevel::INFO),
+                                   make_test_entry(br_logger::LogLevel::ERROR),
+                                   make_test_entry(br_logger::LogLevel::DEBUG),
+                                   make_test_entry(br_logger::LogLevel::INFO)};
+  const char text[] = "a\nb\nc\n";
+  const uint32_t offsets[] = {0, 2, 4, 4, 6};  // 第 3 条格式化为空
+  br_logger::FormattedBatch batch{entries, text, offsets, 4};
+
+  std::string stderr_output;
+  std::string stdout_output = capture_fd_output(
+      STDOUT_FILENO,
+      [&]() { stderr_output = capture_fd_output(STDERR_FILENO, [&]() { sink.WriteFormatted(batch); }); });
+
+  EXPECT_EQ(stdout_output, "a\nc\n");
+  EXPECT_EQ(stderr_output, "b\n");
+}
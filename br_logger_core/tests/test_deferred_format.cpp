@@ -0,0 +1,212 @@
+#ifndef BR_LOG_DEFERRED_FORMAT
+#define BR_LOG_DEFERRED_FORMAT 1
+#endif
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../include/br_logger/deferred_format.hpp"
+#include "../include/br_logger/logger.hpp"
+#include "../include/br_logger/sinks/callback_sink.hpp"
+
+namespace
+{
+
+struct NotPrintable
+{
+  int value;
+};
+
+template <typename... Args>
+std::string round_trip(const char* fmt, const Args&... args)
+{
+  char blob[BR_LOG_MAX_MSG_LEN];
+  size_t blob_len = br_logger::detail::encode_args(blob, sizeof(blob), args...);
+  char out[BR_LOG_MAX_MSG_LEN];
+  size_t len = br_logger::detail::format_deferred<br_logger::detail::Decay<Args>...>(
+      fmt, blob, blob_len, out, sizeof(out));
+  return std::string(out, len);
+}
+
+}  // namespace
+
+static_assert(br_logger::detail::IsDeferrableArgs<int, double, const char*>::value);
+static_assert(br_logger::detail::IsDeferrableArgs<const char (&)[4], char*, void*>::value);
+static_assert(!br_logger::detail::IsDeferrableArgs<NotPrintable>::value);
+
+TEST(DeferredFormat, EncodedSizeCoversEncoding)
+{
+  const char* null_str = nullptr;
+  std::string mid(40, 'm');
+  char blob[BR_LOG_MAX_MSG_LEN];
+  size_t size = br_logger::detail::encoded_args_size(1, mid.c_str(), null_str, 2.5);
+  EXPECT_EQ(br_logger::detail::encode_args(blob, size, 1, mid.c_str(), null_str, 2.5),
+            sizeof(int) + 3 + mid.size() + 2 + sizeof(double));
+
+  std::string big(BR_LOG_MAX_MSG_LEN * 2, 'x');
+  EXPECT_EQ(br_logger::detail::encoded_args_size(big.c_str()), BR_LOG_MAX_MSG_LEN);
+}
+
+#ifndef BR_LOG_USE_FMTLIB
+TEST(DeferredFormat, RoundTripScalars)
+{
+  EXPECT_EQ(round_trip("a=%d b=%u c=%.2f", -7, 42u, 3.14159), "a=-7 b=42 c=3.14");
+  EXPECT_EQ(round_trip("%lld %c", 1234567890123LL, 'x'), "1234567890123 x");
+}
+
+TEST(DeferredFormat, RoundTripStrings)
+{
+  std::string owned = "owned";
+  EXPECT_EQ(round_trip("%s/%s", "lit", owned.c_str()), "lit/owned");
+}
+
+TEST(DeferredFormat, RoundTripScalarsBeforeLongString)
+{
+  // 容量恰好放得下全部参数时，前面的标量不应挤占字符串的空间
+  std::string text(40, 's');
+  char blob[2 * sizeof(int) + br_logger::detail::K_STRING_OVERHEAD + 40];
+  size_t blob_len =
+      br_logger::detail::encode_args(blob, sizeof(blob), 1, 2, text.c_str());
+  EXPECT_EQ(blob_len, sizeof(blob));
+
+  char out[BR_LOG_MAX_MSG_LEN];
+  size_t len = br_logger::detail::format_deferred<int, int, const char*>(
+      "%d %d %s", blob, blob_len, out, sizeof(out));
+  EXPECT_EQ(std::string(out, len), "1 2 " + text);
+}
+
+TEST(DeferredFormat, NoArgsCopiedVerbatim)
+{
+  EXPECT_EQ(round_trip("100%% plain"), "100%% plain");
+}
+
+TEST(DeferredFormat, LongStringTruncatedToBuffer)
+{
+  std::string big(BR_LOG_MAX_MSG_LEN * 2, 'x');
+  char blob[BR_LOG_MAX_MSG_LEN];
+  size_t blob_len =
+      br_logger::detail::encode_args(blob, sizeof(blob), 5, big.c_str(), 6);
+  EXPECT_LE(blob_len, sizeof(blob));
+
+  char out[BR_LOG_MAX_MSG_LEN];
+  size_t len = br_logger::detail::format_deferred<int, const char*, int>(
+      "%d %s %d", blob, blob_len, out, sizeof(out));
+  std::string text(out, len);
+  EXPECT_EQ(text.substr(0, 2), "5 ");
+  EXPECT_LT(len, sizeof(out));
+}
+#endif
+
+class DeferredLoggerTest : public ::testing::Test
+{
+ protected:
+  static std::vector<std::string> messages_;
+  static std::vector<bool> pending_;
+  static std::mutex mutex_;
+  static bool setup_done_;
+
+  static void SetUpTestSuite()
+  {
+    if (setup_done_)
+    {
+      return;
+    }
+    auto& logger = br_logger::Logger::Instance();
+    logger.AddSink(std::make_unique<br_logger::CallbackSink>(
+        [](const br_logger::LogEntry& entry)
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          messages_.emplace_back(entry.msg, entry.msg_len);
+          pending_.push_back(entry.format_fn != nullptr);
+        }));
+    logger.SetLevel(br_logger::LogLevel::TRACE);
+    setup_done_ = true;
+  }
+
+  void SetUp() override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    messages_.clear();
+    pending_.clear();
+  }
+
+  static void DrainAll() { br_logger::Logger::Instance().Drain(1024); }
+};
+
+std::vector<std::string> DeferredLoggerTest::messages_;
+std::vector<bool> DeferredLoggerTest::pending_;
+std::mutex DeferredLoggerTest::mutex_;
+bool DeferredLoggerTest::setup_done_ = false;
+
+TEST_F(DeferredLoggerTest, FormattedOnBackend)
+{
+#ifdef BR_LOG_USE_FMTLIB
+  LOG_INFO("a={} b={} c={:.1f}", 1, "two", 3.0);
+#else
+  LOG_INFO("a=%d b=%s c=%.1f", 1, "two", 3.0);
+#endif
+  DrainAll();
+
+  ASSERT_EQ(messages_.size(), 1u);
+  EXPECT_EQ(messages_[0], "a=1 b=two c=3.0");
+  EXPECT_FALSE(pending_[0]);
+}
+
+TEST_F(DeferredLoggerTest, StringArgumentCopiedByValue)
+{
+  char buf[16];
+  std::strcpy(buf, "before");
+#ifdef BR_LOG_USE_FMTLIB
+  LOG_INFO("s={}", buf);
+#else
+  LOG_INFO("s=%s", buf);
+#endif
+  std::strcpy(buf, "after!");
+  DrainAll();
+
+  ASSERT_EQ(messages_.size(), 1u);
+  EXPECT_EQ(messages_[0], "s=before");
+}
+
+#ifndef BR_LOG_USE_FMTLIB
+TEST_F(DeferredLoggerTest, CharPointerConsumedByPercentPKeepsAddress)
+{
+  char buf[4] = {'a', 'b', 'c', 'd'};  // 没有 '\0'，按字符串捕获会越界读取
+  LOG_INFO("p=%p", buf);
+  DrainAll();
+
+  char expected[64];
+  std::snprintf(expected, sizeof(expected), "p=%p", static_cast<void*>(buf));
+  ASSERT_EQ(messages_.size(), 1u);
+  EXPECT_EQ(messages_[0], expected);
+}
+#endif
+
+TEST_F(DeferredLoggerTest, LongStringEncodedInPlaceIsTruncated)
+{
+  std::string big(BR_LOG_MAX_MSG_LEN * 2, 'y');
+#ifdef BR_LOG_USE_FMTLIB
+  LOG_INFO("{}|{}", big.c_str(), 7);
+#else
+  LOG_INFO("%s|%d", big.c_str(), 7);
+#endif
+  DrainAll();
+
+  ASSERT_EQ(messages_.size(), 1u);
+  EXPECT_LT(messages_[0].size(), static_cast<size_t>(BR_LOG_MAX_MSG_LEN));
+  EXPECT_EQ(messages_[0].substr(messages_[0].size() - 2), "|7");
+}
+
+TEST_F(DeferredLoggerTest, NoArgs)
+{
+  LOG_WARN("plain message");
+  DrainAll();
+
+  ASSERT_EQ(messages_.size(), 1u);
+  EXPECT_EQ(messages_[0], "plain message");
+}
@@ -0,0 +1,187 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "br_logger/sinks/fd_writer.hpp"
+
+using br_logger::FdWriter;
+
+namespace
+{
+
+// 读出管道中当前可读的全部数据
+std::string drain_pipe(int fd)
+{
+  std::string out;
+  char buf[4096];
+  int flags = ::fcntl(fd, F_GETFL);
+  ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+  ssize_t n = 0;
+  while ((n = ::read(fd, buf, sizeof(buf))) > 0)
+  {
+    out.append(buf, static_cast<size_t>(n));
+  }
+  ::fcntl(fd, F_SETFL, flags);
+  return out;
+}
+
+struct Pipe
+{
+  int fds[2] = {-1, -1};
+  Pipe() { EXPECT_EQ(::pipe(fds), 0); }
+  ~Pipe()
+  {
+    for (int fd : fds)
+    {
+      if (fd >= 0)
+      {
+        ::close(fd);
+      }
+    }
+  }
+};
+
+void on_alarm(int) {}
+
+}  // namespace
+
+TEST(FdWriter, BuffersUntilFlush)
+{
+  Pipe pipe;
+  FdWriter writer(4096, 4096, 0);
+  writer.Reset(pipe.fds[1], 100);
+
+  char* dst = writer.Reserve(16);
+  ASSERT_NE(dst, nullptr);
+  std::memcpy(dst, "line\n", 5);
+  writer.Commit(5);
+  writer.Append("more\n", 5);
+
+  EXPECT_EQ(writer.FileSize(), 110u);
+  EXPECT_EQ(writer.Buffered(), 10u);
+  EXPECT_EQ(drain_pipe(pipe.fds[0]), "");
+  EXPECT_EQ(writer.Stats().syscalls, 0u);
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(drain_pipe(pipe.fds[0]), "line\nmore\n");
+  EXPECT_EQ(writer.Stats().syscalls, 1u);
+  EXPECT_EQ(writer.Stats().bytes_written, 10u);
+}
+
+TEST(FdWriter, FlushIfDueHonoursByteAndAgeThresholds)
+{
+  Pipe pipe;
+  FdWriter by_bytes(4096, 8, 0);
+  by_bytes.Reset(pipe.fds[1], 0);
+  by_bytes.Append("1234", 4);
+  by_bytes.FlushIfDue(0);
+  EXPECT_EQ(by_bytes.Buffered(), 4u);
+  by_bytes.Append("5678", 4);
+  by_bytes.FlushIfDue(0);
+  EXPECT_EQ(by_bytes.Buffered(), 0u);
+  EXPECT_EQ(drain_pipe(pipe.fds[0]), "12345678");
+
+  // 时刻由调用方给出，0 也是有效的起点（嵌入式模式下默认时钟恒为 0）
+  FdWriter by_age(4096, 4096, 1'000'000);
+  by_age.Reset(pipe.fds[1], 0);
+  by_age.Append("old", 3);
+  by_age.FlushIfDue(0);
+  by_age.FlushIfDue(999'999);
+  EXPECT_EQ(by_age.Buffered(), 3u);
+  by_age.FlushIfDue(1'000'000);
+  EXPECT_EQ(by_age.Buffered(), 0u);
+  EXPECT_EQ(drain_pipe(pipe.fds[0]), "old");
+
+  // 写出后重新计时
+  by_age.Append("new", 3);
+  by_age.FlushIfDue(5'000'000);
+  EXPECT_EQ(by_age.Buffered(), 3u);
+  by_age.FlushIfDue(6'000'000);
+  EXPECT_EQ(by_age.Buffered(), 0u);
+  EXPECT_EQ(drain_pipe(pipe.fds[0]), "new");
+}
+
+TEST(FdWriter, OversizedAppendUsesSingleWritev)
+{
+  Pipe pipe;
+  FdWriter writer(4096, 4096, 0);
+  writer.Reset(pipe.fds[1], 0);
+  writer.Append("head", 4);
+  std::string big(6000, 'x');
+  ASSERT_GE(::fcntl(pipe.fds[1], F_SETPIPE_SZ, 65536), 6004);
+  writer.Append(big.data(), big.size());
+
+  EXPECT_EQ(writer.Buffered(), 0u);
+  EXPECT_EQ(writer.FileSize(), 6004u);
+  EXPECT_EQ(writer.Stats().syscalls, 1u);
+  EXPECT_EQ(drain_pipe(pipe.fds[0]), "head" + big);
+}
+
+TEST(FdWriter, ResumesAfterInterruptedPartialWrite)
+{
+  Pipe pipe;
+  ASSERT_GE(::fcntl(pipe.fds[1], F_SETPIPE_SZ, 4096), 4096);
+  struct sigaction action{};
+  struct sigaction old_action{};
+  action.sa_handler = on_alarm;  // 不设 SA_RESTART，阻塞中的 write 被信号打断
+  ::sigaction(SIGALRM, &action, &old_action);
+
+  std::string data(64 * 1024, '\0');
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    data[i] = static_cast<char>('a' + i % 26);
+  }
+  std::string received;
+  std::thread reader(
+      [&]()
+      {
+        sigset_t set;
+        sigemptyset(&set);
+        sigaddset(&set, SIGALRM);
+        pthread_sigmask(SIG_BLOCK, &set, nullptr);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        char buf[4096];
+        ssize_t n = 0;
+        while ((n = ::read(pipe.fds[0], buf, sizeof(buf))) > 0)
+        {
+          received.append(buf, static_cast<size_t>(n));
+        }
+      });
+
+  struct itimerval timer{};
+  timer.it_value.tv_usec = 10'000;
+  ::setitimer(ITIMER_REAL, &timer, nullptr);
+
+  FdWriter writer(data.size(), data.size(), 0);
+  writer.Reset(pipe.fds[1], 0);
+  writer.Append(data.data(), data.size());
+  EXPECT_TRUE(writer.Flush());
+  ::close(pipe.fds[1]);
+  pipe.fds[1] = -1;
+  reader.join();
+  ::sigaction(SIGALRM, &old_action, nullptr);
+
+  EXPECT_EQ(received, data);
+  EXPECT_GT(writer.Stats().syscalls, 1u);
+  EXPECT_EQ(writer.Stats().bytes_written, data.size());
+  EXPECT_EQ(writer.Stats().write_errors, 0u);
+}
+
+TEST(FdWriter, WriteErrorDropsBufferInsteadOfRetrying)
+{
+  FdWriter writer(4096, 4096, 0);
+  writer.Reset(::open("/dev/null", O_RDONLY), 0);
+  writer.Append("lost", 4);
+  EXPECT_FALSE(writer.Flush());
+  EXPECT_EQ(writer.Buffered(), 0u);
+  EXPECT_EQ(writer.Stats().write_errors, 1u);
+  ::close(writer.Fd());
+}
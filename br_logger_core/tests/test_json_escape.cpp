@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "../include/br_logger/json_escape.hpp"
+
+using br_logger::detail::escape_json;
+using br_logger::detail::escape_json_scalar;
+
+static std::string escaped(const std::string& src, size_t dst_size = 1024)
+{
+  std::string out(dst_size, '\0');
+  out.resize(escape_json(src.data(), src.size(), out.data(), dst_size));
+  return out;
+}
+
+TEST(JsonEscape, EscapesQuotesBackslashesAndControls)
+{
+  EXPECT_EQ(escaped("plain text"), "plain text");
+  EXPECT_EQ(escaped("a\"b\\c"), "a\\\"b\\\\c");
+  EXPECT_EQ(escaped("\n\r\t"), "\\n\\r\\t");
+  EXPECT_EQ(escaped(std::string("\x00\x01\x1f\b\f", 5)), "\\u0000\\u0001\\u001F\\u0008\\u000C");
+  // 0x7F 与 UTF-8 多字节原样输出
+  EXPECT_EQ(escaped("\x7f\xc3\xa9"), "\x7f\xc3\xa9");
+}
+
+TEST(JsonEscape, LongRunsCrossBlockBoundaries)
+{
+  std::string src(100, 'x');
+  src[15] = '"';
+  src[16] = '\n';
+  src[31] = '\\';
+  src[32] = '\x02';
+  src[99] = '"';
+  std::string expected = std::string(15, 'x') + "\\\"\\n" + std::string(14, 'x') + "\\\\" +
+                         "\\u0002" + std::string(66, 'x') + "\\\"";
+  EXPECT_EQ(escaped(src), expected);
+}
+
+// 向量化路径与逐字节路径在任意输入、任意目标空间下输出一致，且不截断转义序列
+TEST(JsonEscape, MatchesScalarForEveryLengthAndTruncation)
+{
+  const char alphabet[] = {'a', 'b', ' ', '"', '\\', '\n', '\x01', '\x7f', '\xc3', 'z'};
+  uint32_t x = 2463534242u;
+  for (int round = 0; round < 200; ++round)
+  {
+    size_t len = static_cast<size_t>(round % 100);
+    std::string src;
+    for (size_t i = 0; i < len; ++i)
+    {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      // 偶数轮以普通字符为主，让整块无需转义的情形也被覆盖
+      src.push_back((round % 2 == 0 && x % 16 != 0) ? 'a' : alphabet[x % sizeof(alphabet)]);
+    }
+    for (size_t dst_size = 0; dst_size <= len * 6 + 1; ++dst_size)
+    {
+      std::string fast(dst_size + 1, '#');
+      std::string slow(dst_size + 1, '#');
+      size_t fast_len = escape_json(src.data(), src.size(), fast.data(), dst_size);
+      size_t slow_len = escape_json_scalar(src.data(), src.size(), slow.data(), dst_size);
+      ASSERT_EQ(fast_len, slow_len) << "round " << round << " dst_size " << dst_size;
+      ASSERT_LE(fast_len, dst_size);
+      ASSERT_EQ(fast.substr(0, fast_len), slow.substr(0, slow_len));
+      ASSERT_EQ(fast[dst_size], '#');
+    }
+  }
+}
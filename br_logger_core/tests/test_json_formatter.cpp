@@ -12,26 +12,25 @@ using br_logger::JsonFormatter;
 using br_logger::LogEntry;
 using br_logger::LogLevel;
 
+static constexpr br_logger::LogSite K_TEST_SITE{
+    "/src/main.cpp", "main.cpp", "process", "void process(int)",
+    42, 0, br_logger::LogLevel::INFO, "", 0};
+
 static LogEntry make_test_entry()
 {
   LogEntry entry{};
   entry.wall_clock_ns = 1739692200123456000ULL;
   entry.timestamp_ns = 123456789ULL;
   entry.level = LogLevel::INFO;
-  entry.file_path = "/src/main.cpp";
-  entry.file_name = "main.cpp";
-  entry.function_name = "process";
-  entry.pretty_function = "void process(int)";
-  entry.line = 42;
-  entry.column = 0;
+  entry.site = &K_TEST_SITE;
   entry.thread_id = 1234;
   entry.process_id = 5678;
   std::strncpy(entry.thread_name, "worker", sizeof(entry.thread_name));
   entry.tag_count = 2;
-  std::strncpy(entry.tags[0].key, "env", BR_LOG_MAX_TAG_KEY_LEN);
-  std::strncpy(entry.tags[0].value, "prod", BR_LOG_MAX_TAG_VAL_LEN);
-  std::strncpy(entry.tags[1].key, "req", BR_LOG_MAX_TAG_KEY_LEN);
-  std::strncpy(entry.tags[1].value, "abc123", BR_LOG_MAX_TAG_VAL_LEN);
+  entry.tags[0].key = br_logger::TagDictionary::Instance().Intern("env");
+  entry.tags[0].value = br_logger::TagDictionary::Instance().Intern("prod");
+  entry.tags[1].key = br_logger::TagDictionary::Instance().Intern("req");
+  entry.tags[1].value = br_logger::TagDictionary::Instance().Intern("abc123");
   entry.sequence_id = 1001;
   const char* msg = "hello world";
   entry.msg_len = static_cast<uint16_t>(std::strlen(msg));
@@ -191,3 +190,28 @@ TEST(JsonFormatter, AllLevels)
     EXPECT_NE(out.find(needle), std::string::npos);
   }
 }
+
+TEST(JsonFormatter, CompactLayout)
+{
+  auto entry = make_test_entry();
+  auto out = format_with(entry);
+  ASSERT_EQ(out.rfind("{\"ts\":\"", 0), 0u);
+  auto rest = out.substr(out.find("\",\"level\""));
+  EXPECT_EQ(rest,
+            "\",\"level\":\"INFO\",\"file\":\"main.cpp\",\"line\":42,\"func\":\"process\","
+            "\"tid\":1234,\"pid\":5678,\"thread\":\"worker\",\"seq\":1001,"
+            "\"tags\":{\"env\":\"prod\",\"req\":\"abc123\"},\"msg\":\"hello world\"}");
+}
+
+TEST(JsonFormatter, PrettyLayout)
+{
+  auto entry = make_test_entry();
+  auto out = format_with(entry, true);
+  ASSERT_EQ(out.rfind("{\n  \"ts\": \"", 0), 0u);
+  auto rest = out.substr(out.find("\",\n  \"level\""));
+  EXPECT_EQ(rest,
+            "\",\n  \"level\": \"INFO\",\n  \"file\": \"main.cpp\",\n  \"line\": 42,\n"
+            "  \"func\": \"process\",\n  \"tid\": 1234,\n  \"pid\": 5678,\n"
+            "  \"thread\": \"worker\",\n  \"seq\": 1001,\n"
+            "  \"tags\": {\"env\": \"prod\",\"req\": \"abc123\"},\n  \"msg\": \"hello world\"\n}");
+}
@@ -1,24 +1,29 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <atomic>
 #include <cstring>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "br_logger/log_context.hpp"
 #include "br_logger/log_entry.hpp"
 
 using br_logger::LogContext;
 using br_logger::LogEntry;
+using br_logger::TagDictionary;
 
 namespace
 {
 
+std::string_view resolve(br_logger::TagId id) { return TagDictionary::Instance().Resolve(id); }
+
 bool has_tag(const LogEntry& entry, const char* key, const char* value)
 {
   for (uint8_t i = 0; i < entry.tag_count; ++i)
   {
-    if (std::strcmp(entry.tags[i].key, key) == 0 &&
-        std::strcmp(entry.tags[i].value, value) == 0)
+    if (resolve(entry.tags[i].key) == key && br_logger::tag_value(entry, entry.tags[i]) == value)
     {
       return true;
     }
@@ -30,7 +35,7 @@ bool has_key(const LogEntry& entry, const char* key)
 {
   for (uint8_t i = 0; i < entry.tag_count; ++i)
   {
-    if (std::strcmp(entry.tags[i].key, key) == 0)
+    if (resolve(entry.tags[i].key) == key)
     {
       return true;
     }
@@ -198,3 +203,178 @@ TEST(LogContext, GitHashAndBuildType)
   EXPECT_NE(ctx.GitHash(), nullptr);
   EXPECT_NE(ctx.BuildType(), nullptr);
 }
+
+TEST(LogContext, GlobalTagUpdateVisibleToOtherThreads)
+{
+  auto& ctx = LogContext::Instance();
+  LogEntry entry{};
+  ctx.FillTags(entry);  // 当前线程先缓存一份快照
+  size_t base = entry.tag_count;
+
+  std::thread writer([&ctx]() { ctx.SetGlobalTag("snapshot", "v1"); });
+  writer.join();
+
+  ctx.FillTags(entry);
+  ASSERT_EQ(entry.tag_count, base + 1);
+  EXPECT_EQ(resolve(entry.tags[base].key), "snapshot");
+  EXPECT_EQ(br_logger::tag_value(entry, entry.tags[base]), "v1");
+
+  ctx.SetGlobalTag("snapshot", "v2");
+  ctx.FillTags(entry);
+  EXPECT_EQ(br_logger::tag_value(entry, entry.tags[base]), "v2");
+
+  ctx.RemoveGlobalTag("snapshot");
+  ctx.FillTags(entry);
+  EXPECT_EQ(entry.tag_count, base);
+}
+
+TEST(LogContext, ConcurrentGlobalTagReadersAndWriter)
+{
+  auto& ctx = LogContext::Instance();
+  std::atomic<bool> stop{false};
+  std::atomic<bool> torn{false};
+
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t)
+  {
+    readers.emplace_back(
+        [&]()
+        {
+          LogEntry entry{};
+          while (!stop.load(std::memory_order_relaxed))
+          {
+            ctx.FillTags(entry);
+            for (size_t i = 0; i < entry.tag_count; ++i)
+            {
+              // 值总是与 key 成对写入，读到的快照不应出现半更新的 tag
+              if (resolve(entry.tags[i].key) == "rcu" &&
+                  br_logger::tag_value(entry, entry.tags[i]).substr(0, 1) != "v")
+              {
+                torn.store(true, std::memory_order_relaxed);
+              }
+            }
+          }
+        });
+  }
+  for (int i = 0; i < 1000; ++i)
+  {
+    ctx.SetGlobalTag("rcu", (i % 2) ? "v-odd" : "v-even");
+    if (i % 10 == 0)
+    {
+      ctx.RemoveGlobalTag("rcu");
+    }
+  }
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& thread : readers)
+  {
+    thread.join();
+  }
+  ctx.RemoveGlobalTag("rcu");
+  EXPECT_FALSE(torn.load());
+}
+
+TEST(LogContext, LongTagValuesAreNotTruncated)
+{
+  std::string value(300, 'x');
+  value.back() = 'y';
+  // 第一次出现的值按 BR_LOG_TAG_INLINE_LEN 内联，重复出现后驻留，不再受长度限制
+  {
+    LogContext::ScopedTag first("long_value", value.c_str());
+  }
+  LogContext::ScopedTag tag("long_value", value.c_str());
+  LogEntry entry{};
+  LogContext::Instance().FillTags(entry);
+  EXPECT_TRUE(has_tag(entry, "long_value", value.c_str()));
+}
+
+TEST(LogContext, OversizedInlineValuesAreMarkedTruncated)
+{
+  auto& ctx = LogContext::Instance();
+  uint64_t before = ctx.TruncatedTagValues();
+  std::string value = "oversized-" + std::string(BR_LOG_TAG_INLINE_LEN, 'z');
+  LogContext::ScopedTag tag("oversized", value.c_str());
+  LogEntry entry{};
+  ctx.FillTags(entry);
+
+  ASSERT_TRUE(has_key(entry, "oversized"));
+  std::string_view text = br_logger::tag_value(entry, entry.tags[entry.tag_count - 1]);
+  EXPECT_EQ(text.size(), static_cast<size_t>(BR_LOG_TAG_INLINE_LEN));
+  EXPECT_EQ(text.substr(0, 10), "oversized-");
+  EXPECT_EQ(text.substr(text.size() - 3), "...");
+  EXPECT_EQ(ctx.TruncatedTagValues(), before + 1);
+}
+
+TEST(LogContext, OneOffTagValuesAreCarriedInline)
+{
+  auto& dict = TagDictionary::Instance();
+  dict.Intern("one_off");
+  size_t before = dict.Size();
+  for (int i = 0; i < 100; ++i)
+  {
+    std::string value = "request-" + std::to_string(i);
+    LogContext::ScopedTag tag("one_off", value.c_str());
+    LogEntry entry{};
+    LogContext::Instance().FillTags(entry);
+    EXPECT_TRUE(has_tag(entry, "one_off", value.c_str()));
+  }
+  // 只出现一次的值不进入驻留表
+  EXPECT_EQ(dict.Size(), before);
+}
+
+TEST(LogContext, RepeatedTagValuesAreInterned)
+{
+  for (int i = 0; i < 2; ++i)
+  {
+    LogContext::ScopedTag tag("repeat", "same-value");
+    LogEntry entry{};
+    LogContext::Instance().FillTags(entry);
+    ASSERT_TRUE(has_tag(entry, "repeat", "same-value"));
+    EXPECT_EQ(br_logger::is_inline_tag_value(entry.tags[entry.tag_count - 1].value), i == 0);
+  }
+}
+
+TEST(TagDictionary, InternIsIdempotentAndResolvable)
+{
+  auto& dict = TagDictionary::Instance();
+  br_logger::TagId a = dict.Intern("dict_key");
+  EXPECT_EQ(dict.Intern(std::string("dict_key")), a);
+  EXPECT_NE(dict.Intern("dict_other"), a);
+  EXPECT_EQ(dict.Resolve(a), "dict_key");
+  EXPECT_EQ(dict.Intern(""), TagDictionary::K_EMPTY_ID);
+  EXPECT_EQ(dict.Resolve(0xFFFFFFu), "");
+
+  br_logger::TagId found = 0;
+  EXPECT_TRUE(dict.Find("dict_key", found));
+  EXPECT_EQ(found, a);
+  EXPECT_FALSE(dict.Find("dict_never_interned", found));
+}
+
+TEST(TagDictionary, ConcurrentInternAgreesOnIds)
+{
+  auto& dict = TagDictionary::Instance();
+  constexpr int K_STRINGS = 200;
+  std::vector<std::vector<br_logger::TagId>> ids(4, std::vector<br_logger::TagId>(K_STRINGS));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back(
+        [&, t]()
+        {
+          for (int i = 0; i < K_STRINGS; ++i)
+          {
+            ids[t][i] = dict.Intern("concurrent_" + std::to_string(i));
+          }
+        });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  for (int i = 0; i < K_STRINGS; ++i)
+  {
+    EXPECT_EQ(ids[1][i], ids[0][i]);
+    EXPECT_EQ(ids[2][i], ids[0][i]);
+    EXPECT_EQ(ids[3][i], ids[0][i]);
+    EXPECT_EQ(dict.Resolve(ids[0][i]), "concurrent_" + std::to_string(i));
+  }
+}
@@ -103,14 +103,35 @@ TEST_F(LoggerIntegrationTest, SourceLocation)
   DrainAll();
 
   ASSERT_EQ(captured_.size(), 1u);
-  EXPECT_NE(captured_[0].file_name, nullptr);
-  EXPECT_NE(captured_[0].function_name, nullptr);
-  EXPECT_GT(captured_[0].line, 0u);
-
-  std::string fname(captured_[0].file_name);
+  const br_logger::LogSite* site = captured_[0].site;
+  ASSERT_NE(site, nullptr);
+  EXPECT_NE(site->file_name, nullptr);
+  EXPECT_NE(site->function_name, nullptr);
+  EXPECT_GT(site->line, 0u);
+  EXPECT_EQ(site->level, br_logger::LogLevel::INFO);
+  EXPECT_STREQ(site->fmt, "location test");
+  EXPECT_EQ(site->id, br_logger::LogSite::MakeId(site->file_path, site->line));
+
+  std::string fname(site->file_name);
   EXPECT_NE(fname.find("test_logger_integration"), std::string::npos);
 }
 
+TEST_F(LoggerIntegrationTest, CallSiteIsStaticPerStatement)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    LOG_INFO("loop %d", i);
+  }
+  LOG_INFO("other statement");
+  DrainAll();
+
+  ASSERT_EQ(captured_.size(), 4u);
+  EXPECT_EQ(captured_[0].site, captured_[1].site);
+  EXPECT_EQ(captured_[1].site, captured_[2].site);
+  EXPECT_NE(captured_[2].site, captured_[3].site);
+  EXPECT_NE(captured_[2].site->id, captured_[3].site->id);
+}
+
 TEST_F(LoggerIntegrationTest, LogWarn)
 {
   LOG_WARN("warning %d", 42);
@@ -203,6 +224,28 @@ TEST_F(LoggerIntegrationTest, TimestampsPopulated)
   EXPECT_GT(captured_[0].wall_clock_ns, 0u);
 }
 
+TEST_F(LoggerIntegrationTest, TimestampsConvertedForEveryClockSource)
+{
+  auto& logger = br_logger::Logger::Instance();
+  for (auto source : {br_logger::ClockSource::PRECISE, br_logger::ClockSource::COARSE,
+                      br_logger::ClockSource::TSC})
+  {
+    logger.SetClockSource(source);
+    uint64_t before = br_logger::wall_clock_now_ns();
+    LOG_INFO("clock check");
+    DrainAll();
+    uint64_t after = br_logger::wall_clock_now_ns();
+
+    std::lock_guard<std::mutex> lock(captured_mutex_);
+    ASSERT_EQ(captured_.size(), 1u);
+    // COARSE 的分辨率为一个内核 tick，这里放宽到 20ms
+    EXPECT_GE(captured_[0].wall_clock_ns + 20'000'000ULL, before);
+    EXPECT_LE(captured_[0].wall_clock_ns, after + 20'000'000ULL);
+    captured_.clear();
+  }
+  logger.SetClockSource(br_logger::ClockSource::PRECISE);
+}
+
 TEST_F(LoggerIntegrationTest, ThreadInfoPopulated)
 {
   LOG_INFO("thread check");
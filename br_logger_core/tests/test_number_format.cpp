@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+#include "../include/br_logger/number_format.hpp"
+
+using br_logger::detail::format_double;
+using br_logger::detail::format_fixed;
+using br_logger::detail::format_int;
+using br_logger::detail::format_uint;
+
+static std::string uint_text(uint64_t value)
+{
+  char buf[br_logger::detail::K_MAX_INT_CHARS];
+  return std::string(buf, format_uint(buf, value));
+}
+
+static std::string printf_text(const char* fmt, uint64_t value)
+{
+  char buf[32];
+  int n = std::snprintf(buf, sizeof(buf), fmt, value);
+  return std::string(buf, static_cast<size_t>(n));
+}
+
+TEST(NumberFormat, UintMatchesPrintfAtEveryDigitBoundary)
+{
+  uint64_t power = 1;
+  for (int digits = 1; digits <= 20; ++digits)
+  {
+    for (uint64_t value : {power - 1, power, power + 1, power * 5 + 7})
+    {
+      EXPECT_EQ(uint_text(value), printf_text("%" PRIu64, value)) << value;
+    }
+    if (digits < 20)
+    {
+      power *= 10;
+    }
+  }
+  EXPECT_EQ(uint_text(0), "0");
+  EXPECT_EQ(uint_text(std::numeric_limits<uint64_t>::max()), "18446744073709551615");
+  EXPECT_EQ(uint_text(std::numeric_limits<uint32_t>::max()), "4294967295");
+}
+
+TEST(NumberFormat, UintMatchesPrintfForRandomValues)
+{
+  uint64_t x = 0x9E3779B97F4A7C15ULL;
+  for (int i = 0; i < 10000; ++i)
+  {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    uint64_t value = x >> (i % 64);
+    ASSERT_EQ(uint_text(value), printf_text("%" PRIu64, value)) << value;
+  }
+}
+
+TEST(NumberFormat, SignedValues)
+{
+  char buf[br_logger::detail::K_MAX_INT_CHARS];
+  EXPECT_EQ(std::string(buf, format_int(buf, -1)), "-1");
+  EXPECT_EQ(std::string(buf, format_int(buf, 42)), "42");
+  EXPECT_EQ(std::string(buf, format_int(buf, std::numeric_limits<int64_t>::min())),
+            "-9223372036854775808");
+  EXPECT_EQ(std::string(buf, format_int(buf, std::numeric_limits<int64_t>::max())),
+            "9223372036854775807");
+}
+
+TEST(NumberFormat, FixedWidthZeroPads)
+{
+  char buf[8];
+  for (uint32_t value : {0u, 7u, 42u, 999u, 123456u})
+  {
+    format_fixed(buf, value, 6);
+    EXPECT_EQ(std::string(buf, 6), printf_text("%06" PRIu64, value));
+  }
+  format_fixed(buf, 2025, 4);
+  EXPECT_EQ(std::string(buf, 4), "2025");
+  format_fixed(buf, 5, 1);
+  EXPECT_EQ(std::string(buf, 1), "5");
+  format_fixed(buf, 1234567, 3);  // 只保留低位
+  EXPECT_EQ(std::string(buf, 3), "567");
+}
+
+TEST(NumberFormat, DoubleRoundTrips)
+{
+  char buf[br_logger::detail::K_MAX_DOUBLE_CHARS];
+  EXPECT_EQ(std::string(buf, format_double(buf, 0.1)), "0.1");
+  EXPECT_EQ(std::string(buf, format_double(buf, -2.5)), "-2.5");
+  for (double value : {3.141592653589793, 1e300, -2.2250738585072014e-308, 123456789.125,
+                       std::numeric_limits<double>::max(), std::numeric_limits<double>::denorm_min()})
+  {
+    std::string text(buf, format_double(buf, value));
+    EXPECT_EQ(std::strtod(text.c_str(), nullptr), value) << text;
+  }
+  std::string inf(buf, format_double(buf, std::numeric_limits<double>::infinity()));
+  EXPECT_EQ(inf, "inf");
+  std::string nan(buf, format_double(buf, std::nan("")));
+  EXPECT_NE(nan.find("nan"), std::string::npos);
+}
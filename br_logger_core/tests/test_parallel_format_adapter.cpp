@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../include/br_logger/formatters/json_formatter.hpp"
+#include "../include/br_logger/formatters/pattern_formatter.hpp"
+#include "../include/br_logger/sinks/callback_sink.hpp"
+#include "../include/br_logger/sinks/parallel_format_adapter.hpp"
+
+#if BR_LOG_HAS_THREAD
+
+using br_logger::ParallelFormatAdapter;
+using br_logger::ParallelFormatOptions;
+
+namespace
+{
+
+constexpr br_logger::LogSite K_TEST_SITE{
+    "/src/main.cpp", "main.cpp", "process", "void process(int)",
+    42, 0, br_logger::LogLevel::INFO, "", 0};
+
+br_logger::LogEntry make_entry(uint64_t seq, br_logger::LogLevel level = br_logger::LogLevel::INFO)
+{
+  br_logger::LogEntry entry{};
+  entry.wall_clock_ns = 1739692200123456000ULL + seq * 1000;
+  entry.level = level;
+  entry.site = &K_TEST_SITE;
+  entry.thread_id = 1234;
+  entry.sequence_id = seq;
+  std::string msg = "m\"" + std::to_string(seq);
+  std::memcpy(entry.msg, msg.data(), msg.size());
+  entry.msg[msg.size()] = '\0';
+  entry.msg_len = static_cast<uint16_t>(msg.size());
+  return entry;
+}
+
+// 直接保存已格式化的文本，同时记录每批的条数
+class TextSink : public br_logger::ILogSink
+{
+ public:
+  void Write(const br_logger::LogEntry&) override { ++fallback_writes; }
+  void WriteFormatted(const br_logger::FormattedBatch& batch) override
+  {
+    text.append(batch.text + batch.offsets[0], batch.offsets[batch.count] - batch.offsets[0]);
+    batches.push_back(batch.count);
+  }
+  void Flush() override { ++flushes; }
+
+  std::string text;
+  std::vector<size_t> batches;
+  int fallback_writes = 0;
+  int flushes = 0;
+};
+
+// 单线程直接格式化得到的期望输出
+std::string expected_text(br_logger::IFormatter& formatter, const std::vector<br_logger::LogEntry>& entries)
+{
+  std::string out;
+  char buf[2048];
+  for (const auto& entry : entries)
+  {
+    size_t len = formatter.Format(entry, buf, sizeof(buf));
+    out.append(buf, len);
+    out.push_back('\n');
+  }
+  return out;
+}
+
+}  // namespace
+
+TEST(ParallelFormatAdapter, OutputKeepsInputOrder)
+{
+  for (uint32_t threads : {0u, 1u, 3u})
+  {
+    auto sink = std::make_unique<TextSink>();
+    TextSink* text_sink = sink.get();
+    ParallelFormatOptions options;
+    options.threads = threads;
+    ParallelFormatAdapter adapter(std::move(sink), std::make_unique<br_logger::JsonFormatter>(),
+                                  options);
+
+    std::vector<br_logger::LogEntry> entries;
+    for (uint64_t i = 0; i < 2000; ++i)
+    {
+      entries.push_back(make_entry(i));
+    }
+    // 各种批大小，包括超过一批的调用
+    size_t pos = 0;
+    for (size_t step = 1; pos < entries.size(); step = step % 70 + 1)
+    {
+      size_t n = std::min(step, entries.size() - pos);
+      adapter.WriteBatch(entries.data() + pos, n);
+      pos += n;
+    }
+    adapter.Flush();
+
+    br_logger::JsonFormatter formatter;
+    EXPECT_EQ(text_sink->text, expected_text(formatter, entries)) << "threads=" << threads;
+    EXPECT_EQ(text_sink->fallback_writes, 0);
+    EXPECT_EQ(text_sink->flushes, 1);
+    for (size_t count : text_sink->batches)
+    {
+      EXPECT_LE(count, static_cast<size_t>(BR_LOG_DISPATCH_BATCH));
+    }
+  }
+}
+
+TEST(ParallelFormatAdapter, FiltersByInnerSinkLevel)
+{
+  auto sink = std::make_unique<TextSink>();
+  TextSink* text_sink = sink.get();
+  sink->SetLevel(br_logger::LogLevel::WARN);
+  ParallelFormatAdapter adapter(std::move(sink),
+                                std::make_unique<br_logger::PatternFormatter>("%L %m", false));
+  br_logger::LogEntry entries[] = {make_entry(1, br_logger::LogLevel::INFO),
+                                   make_entry(2, br_logger::LogLevel::ERROR),
+                                   make_entry(3, br_logger::LogLevel::DEBUG)};
+  adapter.WriteBatch(entries, 3);
+  adapter.OnIdle();
+  EXPECT_EQ(text_sink->text, "ERROR m\"2\n");
+}
+
+TEST(ParallelFormatAdapter, PlainSinkFallsBackToWriteBatch)
+{
+  std::vector<uint64_t> received;
+  auto sink = std::make_unique<br_logger::CallbackSink>(
+      [&](const br_logger::LogEntry& e) { received.push_back(e.sequence_id); });
+  ParallelFormatAdapter adapter(std::move(sink), std::make_unique<br_logger::JsonFormatter>());
+  for (uint64_t i = 0; i < 100; ++i)
+  {
+    adapter.Write(make_entry(i));
+  }
+  adapter.Flush();
+  ASSERT_EQ(received.size(), 100u);
+  for (uint64_t i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(received[i], i);
+  }
+}
+
+#endif  // BR_LOG_HAS_THREAD
@@ -8,26 +8,25 @@
 #include "../include/br_logger/log_level.hpp"
 #include "../include/br_logger/platform.hpp"
 
+static constexpr br_logger::LogSite K_TEST_SITE{
+    "/src/main.cpp", "main.cpp", "process", "void process(int)",
+    42, 0, br_logger::LogLevel::INFO, "", 0};
+
 static br_logger::LogEntry make_test_entry()
 {
   br_logger::LogEntry entry{};
   entry.wall_clock_ns = 1739692200123456000ULL;
   entry.timestamp_ns = 123456789ULL;
   entry.level = br_logger::LogLevel::INFO;
-  entry.file_path = "/src/main.cpp";
-  entry.file_name = "main.cpp";
-  entry.function_name = "process";
-  entry.pretty_function = "void process(int)";
-  entry.line = 42;
-  entry.column = 0;
+  entry.site = &K_TEST_SITE;
   entry.thread_id = 1234;
   entry.process_id = 5678;
   std::strncpy(entry.thread_name, "worker", sizeof(entry.thread_name));
   entry.tag_count = 2;
-  std::strncpy(entry.tags[0].key, "env", BR_LOG_MAX_TAG_KEY_LEN);
-  std::strncpy(entry.tags[0].value, "prod", BR_LOG_MAX_TAG_VAL_LEN);
-  std::strncpy(entry.tags[1].key, "req", BR_LOG_MAX_TAG_KEY_LEN);
-  std::strncpy(entry.tags[1].value, "abc123", BR_LOG_MAX_TAG_VAL_LEN);
+  entry.tags[0].key = br_logger::TagDictionary::Instance().Intern("env");
+  entry.tags[0].value = br_logger::TagDictionary::Instance().Intern("prod");
+  entry.tags[1].key = br_logger::TagDictionary::Instance().Intern("req");
+  entry.tags[1].value = br_logger::TagDictionary::Instance().Intern("abc123");
   entry.sequence_id = 1001;
   const char* msg = "hello world";
   entry.msg_len = static_cast<uint16_t>(std::strlen(msg));
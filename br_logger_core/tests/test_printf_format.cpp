@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+
+#include <cinttypes>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../include/br_logger/logger.hpp"
+#include "../include/br_logger/printf_format.hpp"
+#include "../include/br_logger/sinks/callback_sink.hpp"
+
+using br_logger::detail::format_printf;
+using br_logger::detail::printf_error;
+using br_logger::detail::PrintfError;
+
+#define BR_TEST_FORMAT(name, text)                                   \
+  struct name                                                        \
+  {                                                                  \
+    static constexpr const char* value() { return text; }            \
+  }
+
+// 作为对照的 snprintf：部分用例故意截断、传入空字符串指针或使用被忽略的标志，
+// 只在这一次调用上关闭编译器的格式检查
+#if defined(__clang__)
+#define BR_TEST_IGNORE_FORMAT_BEGIN \
+  _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wformat\"")
+#define BR_TEST_IGNORE_FORMAT_END _Pragma("GCC diagnostic pop")
+#elif defined(__GNUC__)
+#define BR_TEST_IGNORE_FORMAT_BEGIN                                             \
+  _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wformat\"") \
+      _Pragma("GCC diagnostic ignored \"-Wformat-truncation\"")
+#define BR_TEST_IGNORE_FORMAT_END _Pragma("GCC diagnostic pop")
+#else
+#define BR_TEST_IGNORE_FORMAT_BEGIN
+#define BR_TEST_IGNORE_FORMAT_END
+#endif
+
+// 同一格式串与参数分别交给 snprintf 与 format_printf，输出须完全一致
+#define EXPECT_LIKE_SNPRINTF(fmt, ...)                                                  \
+  do                                                                                    \
+  {                                                                                     \
+    BR_TEST_FORMAT(Source, fmt);                                                        \
+    char expected[512];                                                                 \
+    BR_TEST_IGNORE_FORMAT_BEGIN                                                         \
+    std::snprintf(expected, sizeof(expected), fmt, __VA_ARGS__);                        \
+    BR_TEST_IGNORE_FORMAT_END                                                           \
+    char actual[512];                                                                   \
+    size_t len = format_printf<Source>(actual, sizeof(actual), __VA_ARGS__);            \
+    EXPECT_EQ(std::string(actual, len), std::string(expected)) << fmt;                  \
+    EXPECT_EQ(actual[len], '\0');                                                       \
+  } while (0)
+
+namespace
+{
+
+enum Color
+{
+  RED = 1,
+  GREEN = 2
+};
+
+BR_TEST_FORMAT(IntFormat, "%d");
+BR_TEST_FORMAT(StringFormat, "%s");
+BR_TEST_FORMAT(FloatFormat, "%f");
+BR_TEST_FORMAT(LongFormat, "%ld");
+BR_TEST_FORMAT(PointerFormat, "%p");
+BR_TEST_FORMAT(CharFormat, "%c");
+BR_TEST_FORMAT(StarFormat, "%*.*f");
+BR_TEST_FORMAT(WriteBackFormat, "%n");
+BR_TEST_FORMAT(PositionalFormat, "%1$d");
+BR_TEST_FORMAT(UnknownFormat, "%y");
+BR_TEST_FORMAT(IncompleteFormat, "50%");
+BR_TEST_FORMAT(BadLengthFormat, "%Ld");
+BR_TEST_FORMAT(WideStringFormat, "%ls");
+
+}  // namespace
+
+static_assert(printf_error<IntFormat, int>() == PrintfError::None);
+static_assert(printf_error<IntFormat, short>() == PrintfError::None);
+static_assert(printf_error<IntFormat, char>() == PrintfError::None);
+static_assert(printf_error<IntFormat, unsigned>() == PrintfError::None);
+static_assert(printf_error<IntFormat, Color>() == PrintfError::None);
+static_assert(printf_error<IntFormat, const char*>() == PrintfError::IntegerExpected);
+static_assert(printf_error<IntFormat, double>() == PrintfError::IntegerExpected);
+static_assert(printf_error<IntFormat, long long>() == PrintfError::IntegerSizeMismatch);
+static_assert(printf_error<IntFormat>() == PrintfError::TooFewArgs);
+static_assert(printf_error<IntFormat, int, int>() == PrintfError::TooManyArgs);
+static_assert(printf_error<LongFormat, long>() == PrintfError::None);
+static_assert(printf_error<StringFormat, const char (&)[4]>() == PrintfError::None);
+static_assert(printf_error<StringFormat, char*>() == PrintfError::None);
+static_assert(printf_error<StringFormat, std::string>() == PrintfError::StringExpected);
+static_assert(printf_error<StringFormat, int>() == PrintfError::StringExpected);
+static_assert(printf_error<FloatFormat, float>() == PrintfError::None);
+static_assert(printf_error<FloatFormat, int>() == PrintfError::FloatExpected);
+static_assert(printf_error<FloatFormat, long double>() == PrintfError::LongDoubleMismatch);
+static_assert(printf_error<PointerFormat, int*>() == PrintfError::None);
+static_assert(printf_error<PointerFormat, std::nullptr_t>() == PrintfError::None);
+static_assert(printf_error<PointerFormat, int>() == PrintfError::PointerExpected);
+static_assert(printf_error<CharFormat, char>() == PrintfError::None);
+static_assert(printf_error<CharFormat, const char*>() == PrintfError::CharExpected);
+static_assert(printf_error<StarFormat, int, int, double>() == PrintfError::None);
+static_assert(printf_error<StarFormat, double, int, double>() == PrintfError::StarExpectsInt);
+static_assert(printf_error<WriteBackFormat, int*>() == PrintfError::Unsupported);
+static_assert(printf_error<PositionalFormat, int>() == PrintfError::Unsupported);
+static_assert(printf_error<WideStringFormat, const wchar_t*>() == PrintfError::Unsupported);
+static_assert(printf_error<UnknownFormat, int>() == PrintfError::UnknownConversion);
+static_assert(printf_error<IncompleteFormat, int>() == PrintfError::Incomplete);
+static_assert(printf_error<BadLengthFormat, int>() == PrintfError::BadLength);
+
+TEST(PrintfFormat, Integers)
+{
+  EXPECT_LIKE_SNPRINTF("%d %d %d %d", 0, -1, INT_MIN, INT_MAX);
+  EXPECT_LIKE_SNPRINTF("[%5d|%-5d|%05d|%+d|% d|%+05d]", 42, 42, -42, 42, 42, -7);
+  EXPECT_LIKE_SNPRINTF("[%.3d|%.0d|%8.3d|%-+8.3d|%08.3d]", 7, 0, -7, 7, 7);
+  EXPECT_LIKE_SNPRINTF("%i %u %u", 12, 3000000000u, static_cast<unsigned>(-1));
+  EXPECT_LIKE_SNPRINTF("%x %X %#x %#X %#x %o %#o %#o %#.0o", 255u, 255u, 255u, 3054u, 0u, 8u,
+                       8u, 0u, 0u);
+  EXPECT_LIKE_SNPRINTF("[%#10x|%-#10x|%#010x|%.5x]", 0xbeefu, 0xbeefu, 0xbeefu, 0xau);
+  EXPECT_LIKE_SNPRINTF("%hhd %hhu %hd %hu", 300, 300, 70000, 70000);
+  EXPECT_LIKE_SNPRINTF("%ld %lu %lld %llu", LONG_MIN, ULONG_MAX, LLONG_MIN, ULLONG_MAX);
+  EXPECT_LIKE_SNPRINTF("%zu %zd %jd %td", sizeof(int), static_cast<ssize_t>(-3),
+                       static_cast<intmax_t>(INT64_MIN), static_cast<ptrdiff_t>(-9));
+  EXPECT_LIKE_SNPRINTF("%" PRId64 " %" PRIu64 " %" PRIx64, INT64_MIN, UINT64_MAX,
+                       static_cast<uint64_t>(0xdeadbeefcafeULL));
+  EXPECT_LIKE_SNPRINTF("%d %d %d", 'a', static_cast<short>(-5), static_cast<int>(true));
+}
+
+TEST(PrintfFormat, EnumsAndBoolsUseIntegerValue)
+{
+  BR_TEST_FORMAT(Source, "%d/%d/%u");
+  char buf[64];
+  size_t len = format_printf<Source>(buf, sizeof(buf), GREEN, true, static_cast<uint8_t>(200));
+  EXPECT_EQ(std::string(buf, len), "2/1/200");
+}
+
+TEST(PrintfFormat, CharsStringsAndPointers)
+{
+  const char* null_str = nullptr;
+  char mutable_str[] = "mutable";
+  int object = 0;
+  void* null_ptr = nullptr;
+  EXPECT_LIKE_SNPRINTF("[%c|%3c|%-3c]", 'x', 'y', 'z');
+  EXPECT_LIKE_SNPRINTF("[%s|%10s|%-10s|%.2s|%10.2s|%.10s]", "abc", "abc", "abc", "abc",
+                       "abc", "abc");
+  EXPECT_LIKE_SNPRINTF("[%s|%s]", mutable_str, "");
+  EXPECT_LIKE_SNPRINTF("[%s|%.3s|%10s]", null_str, null_str, null_str);
+  EXPECT_LIKE_SNPRINTF("[%p|%p|%20p|%-20p]", static_cast<void*>(&object), null_ptr,
+                       static_cast<void*>(&object), static_cast<void*>(&object));
+}
+
+TEST(PrintfFormat, StarWidthAndPrecision)
+{
+  EXPECT_LIKE_SNPRINTF("[%*d|%*d|%-*d]", 5, 42, -5, 42, 4, 1);
+  EXPECT_LIKE_SNPRINTF("[%.*s|%.*s|%*.*f]", 2, "hello", -1, "hello", 9, 3, 2.5);
+  EXPECT_LIKE_SNPRINTF("[%.*d|%.*f]", 0, 0, -1, 1.25);
+}
+
+TEST(PrintfFormat, Floats)
+{
+  EXPECT_LIKE_SNPRINTF("%f %.2f %.0f %.0f %.1f", 3.14159, 3.14159, 0.5, 1.5, 0.05);
+  EXPECT_LIKE_SNPRINTF("[%10.3f|%-10.3f|%010.3f|%+f|% f|%+010.2f]", 3.14159, 3.14159,
+                       -3.14159, 1.0, 1.0, -2.5);
+  EXPECT_LIKE_SNPRINTF("%e %E %.0e %.3e", 1234.5678, 0.0001234, 5e-10, -1e20);
+  EXPECT_LIKE_SNPRINTF("%g %G %g %g %g %.0g %.10g", 1234.5678, 0.0001234, 1e-10, 100000.0,
+                       1000000.0, 2.5, 1.0 / 3);
+  EXPECT_LIKE_SNPRINTF("%a %A %a %.3a %a", 1.0, -0.5, 0.0, 3.14159, 1e-310);
+  EXPECT_LIKE_SNPRINTF("[%f|%F|%6f|%-6f|%06f|%+f|%e|%a|%A]", INFINITY, -INFINITY, INFINITY,
+                       INFINITY, -INFINITY, INFINITY, NAN, INFINITY, NAN);
+  EXPECT_LIKE_SNPRINTF("%f %f %lf", 1.5f, -0.0, 2.25);
+  EXPECT_LIKE_SNPRINTF("%Lf %.3Le %Lg", 1.5L, 123456.789L, 0.1L);
+  EXPECT_LIKE_SNPRINTF("%f %.3f", 1e300, -1e200);
+  EXPECT_LIKE_SNPRINTF("%.60f", 0.1);
+  EXPECT_LIKE_SNPRINTF("[%#g|%#.0f|%#.3e|%#x]", 1.0, 2.0, 1.0, 0u);
+}
+
+TEST(PrintfFormat, LiteralsAndEscapes)
+{
+  EXPECT_LIKE_SNPRINTF("100%% of %d%%", 5);
+  EXPECT_LIKE_SNPRINTF("%%%d%%%%", 1);
+  EXPECT_LIKE_SNPRINTF("plain %s", "text");
+}
+
+TEST(PrintfFormat, TruncatesLikeSnprintf)
+{
+  BR_TEST_FORMAT(Source, "value=%08.3f name=%-6s id=%#x end");
+  const char* fmt = Source::value();
+  for (size_t size = 1; size < 48; ++size)
+  {
+    char expected[64];
+    std::snprintf(expected, size, fmt, -3.25, "ab", 0xabcu);
+    char actual[64];
+    size_t len = format_printf<Source>(actual, size, -3.25, "ab", 0xabcu);
+    EXPECT_EQ(std::string(actual, len), std::string(expected)) << size;
+    EXPECT_EQ(actual[len], '\0');
+  }
+  char untouched = 'q';
+  EXPECT_EQ(format_printf<Source>(&untouched, 0, 1.0, "a", 1u), 0u);
+  EXPECT_EQ(untouched, 'q');
+}
+
+#ifndef BR_LOG_USE_FMTLIB
+TEST(PrintfFormat, LogMacrosUseCompiledFormat)
+{
+  static std::vector<std::string> messages;
+  static std::mutex mutex;
+  auto& logger = br_logger::Logger::Instance();
+  logger.AddSink(std::make_unique<br_logger::CallbackSink>(
+      [](const br_logger::LogEntry& entry)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        messages.emplace_back(entry.msg, entry.msg_len);
+      }));
+  logger.SetLevel(br_logger::LogLevel::TRACE);
+
+  int x = 42;
+  uint64_t big = UINT64_MAX;
+  const char* name = "disk";
+  LOG_INFO("x=%d", x);
+  LOG_INFO("%s usage at %.1f%% (%" PRIu64 ")", name, 97.25, big);
+  LOG_INFO("100%% literal, no args");
+  logger.Drain(16);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(messages.size(), 3u);
+  EXPECT_EQ(messages[0], "x=42");
+  EXPECT_EQ(messages[1], "disk usage at 97.2% (18446744073709551615)");
+  EXPECT_EQ(messages[2], "100%% literal, no args");
+}
+#endif
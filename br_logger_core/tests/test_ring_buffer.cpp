@@ -3,6 +3,8 @@
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <cstring>
+#include <string>
 #include <thread>
 #include <unordered_set>
 #include <vector>
@@ -246,3 +248,282 @@ TEST(MPSCRingBuffer, StressTest)
     EXPECT_EQ(last_sequence[producer], K_STRESS_ITEMS - 1);
   }
 }
+
+using br_logger::MPSCByteRingBuffer;
+
+namespace
+{
+
+struct VarRecord
+{
+  uint32_t producer_id;
+  uint32_t sequence;
+  uint32_t payload_len;
+};
+
+uint32_t var_record_size(uint32_t sequence) { return sizeof(VarRecord) + (sequence % 200); }
+
+}  // namespace
+
+TEST(MPSCByteRingBuffer, SinglePushPop)
+{
+  MPSCByteRingBuffer<1024> buffer;
+  const char msg[] = "hello";
+  EXPECT_TRUE(buffer.TryPush(msg, sizeof(msg)));
+
+  char out[64]{};
+  EXPECT_EQ(buffer.TryPop(out, sizeof(out)), sizeof(msg));
+  EXPECT_STREQ(out, "hello");
+  EXPECT_TRUE(buffer.Empty());
+}
+
+TEST(MPSCByteRingBuffer, EmptyPopFails)
+{
+  MPSCByteRingBuffer<1024> buffer;
+  char out[16];
+  EXPECT_EQ(buffer.TryPop(out, sizeof(out)), 0u);
+}
+
+TEST(MPSCByteRingBuffer, SmallRecordsUseFewBlocks)
+{
+  MPSCByteRingBuffer<1024> buffer;  // 16 blocks of 64 bytes
+  char small[10] = {};
+  int pushed = 0;
+  while (buffer.TryPush(small, sizeof(small)))
+  {
+    ++pushed;
+  }
+  EXPECT_EQ(pushed, 16);
+}
+
+TEST(MPSCByteRingBuffer, VariableSizesPreserveOrderAndContent)
+{
+  MPSCByteRingBuffer<4096> buffer;
+  for (uint32_t i = 0; i < 10; ++i)
+  {
+    std::vector<uint8_t> rec(1 + i * 37, static_cast<uint8_t>(i));
+    ASSERT_TRUE(buffer.TryPush(rec.data(), static_cast<uint32_t>(rec.size())));
+  }
+  for (uint32_t i = 0; i < 10; ++i)
+  {
+    uint8_t out[512];
+    uint32_t n = buffer.TryPop(out, sizeof(out));
+    ASSERT_EQ(n, 1 + i * 37);
+    for (uint32_t b = 0; b < n; ++b)
+    {
+      ASSERT_EQ(out[b], static_cast<uint8_t>(i));
+    }
+  }
+  EXPECT_TRUE(buffer.Empty());
+}
+
+TEST(MPSCByteRingBuffer, WrapAroundInsertsPadding)
+{
+  MPSCByteRingBuffer<1024> buffer;  // 16 blocks
+  char rec[200];                    // 4 blocks
+
+  for (int round = 0; round < 20; ++round)
+  {
+    std::memset(rec, 'a' + round % 26, sizeof(rec));
+    ASSERT_TRUE(buffer.TryPush(rec, sizeof(rec)));
+    ASSERT_TRUE(buffer.TryPush(rec, 100));
+    char out[256];
+    ASSERT_EQ(buffer.TryPop(out, sizeof(out)), sizeof(rec));
+    EXPECT_EQ(out[0], 'a' + round % 26);
+    EXPECT_EQ(out[sizeof(rec) - 1], 'a' + round % 26);
+    ASSERT_EQ(buffer.TryPop(out, sizeof(out)), 100u);
+  }
+  EXPECT_TRUE(buffer.Empty());
+}
+
+TEST(MPSCByteRingBuffer, OversizedRecordRejected)
+{
+  MPSCByteRingBuffer<1024> buffer;
+  std::vector<char> big(MPSCByteRingBuffer<1024>::K_MAX_RECORD_SIZE + 1);
+  EXPECT_FALSE(buffer.TryPush(big.data(), static_cast<uint32_t>(big.size())));
+  EXPECT_FALSE(buffer.TryPush(big.data(), 0));
+}
+
+TEST(MPSCByteRingBuffer, MultiProducerVariableSize)
+{
+  MPSCByteRingBuffer<16384> buffer;
+  std::atomic<uint32_t> remaining{K_PRODUCER_COUNT * K_ITEMS_PER_PRODUCER};
+  std::vector<std::thread> producers;
+
+  for (uint32_t producer = 0; producer < K_PRODUCER_COUNT; ++producer)
+  {
+    producers.emplace_back(
+        [producer, &buffer]()
+        {
+          uint8_t rec[512];
+          for (uint32_t i = 0; i < K_ITEMS_PER_PRODUCER; ++i)
+          {
+            VarRecord hdr{producer, i, var_record_size(i)};
+            std::memcpy(rec, &hdr, sizeof(hdr));
+            std::memset(rec + sizeof(hdr), static_cast<int>(i & 0xFF),
+                        hdr.payload_len - sizeof(hdr));
+            while (!buffer.TryPush(rec, hdr.payload_len))
+            {
+              std::this_thread::yield();
+            }
+          }
+        });
+  }
+
+  std::vector<uint32_t> next_sequence(K_PRODUCER_COUNT, 0);
+  while (remaining.load(std::memory_order_relaxed) > 0)
+  {
+    uint8_t out[512];
+    uint32_t n = buffer.TryPop(out, sizeof(out));
+    if (n == 0)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    VarRecord hdr{};
+    std::memcpy(&hdr, out, sizeof(hdr));
+    ASSERT_LT(hdr.producer_id, K_PRODUCER_COUNT);
+    EXPECT_EQ(n, hdr.payload_len);
+    EXPECT_EQ(hdr.sequence, next_sequence[hdr.producer_id]);
+    EXPECT_EQ(out[n - 1], n > sizeof(hdr) ? static_cast<uint8_t>(hdr.sequence & 0xFF)
+                                          : out[n - 1]);
+    next_sequence[hdr.producer_id] = hdr.sequence + 1;
+    remaining.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  for (auto& thread : producers)
+  {
+    thread.join();
+  }
+  for (uint32_t producer = 0; producer < K_PRODUCER_COUNT; ++producer)
+  {
+    EXPECT_EQ(next_sequence[producer], K_ITEMS_PER_PRODUCER);
+  }
+}
+
+TEST(MPSCRingBuffer, ReserveCommitPeekRelease)
+{
+  MPSCRingBuffer<TestItem, 4> buffer;
+
+  auto reservation = buffer.TryReserve();
+  ASSERT_TRUE(reservation);
+  reservation.data->producer_id = 7;
+  reservation.data->sequence = 42;
+  EXPECT_EQ(buffer.Peek(), nullptr);  // 未提交前不可见
+  buffer.Commit(reservation);
+
+  const TestItem* item = buffer.Peek();
+  ASSERT_NE(item, nullptr);
+  EXPECT_EQ(item->producer_id, 7u);
+  EXPECT_EQ(item->sequence, 42u);
+  buffer.Release();
+  EXPECT_TRUE(buffer.Empty());
+}
+
+TEST(MPSCRingBuffer, ReserveFailsWhenFull)
+{
+  MPSCRingBuffer<TestItem, 4> buffer;
+  for (int i = 0; i < 4; ++i)
+  {
+    auto reservation = buffer.TryReserve();
+    ASSERT_TRUE(reservation);
+    buffer.Commit(reservation);
+  }
+  EXPECT_FALSE(buffer.TryReserve());
+  buffer.Release();
+  EXPECT_TRUE(buffer.TryReserve());
+}
+
+TEST(MPSCByteRingBuffer, ReserveCommitPeekRelease)
+{
+  MPSCByteRingBuffer<1024> buffer;
+
+  auto reservation = buffer.TryReserve(200);
+  ASSERT_TRUE(reservation);
+  std::memcpy(reservation.data, "direct", 7);
+  uint32_t size = 0;
+  EXPECT_EQ(buffer.Peek(size), nullptr);  // 未提交前不可见
+  buffer.Commit(reservation, 7);            // 实际写入小于预留
+
+  const uint8_t* data = buffer.Peek(size);
+  ASSERT_NE(data, nullptr);
+  EXPECT_EQ(size, 7u);
+  EXPECT_STREQ(reinterpret_cast<const char*>(data), "direct");
+  buffer.Release();
+  EXPECT_TRUE(buffer.Empty());
+}
+
+TEST(MPSCByteRingBuffer, CommitZeroAbandonsReservation)
+{
+  MPSCByteRingBuffer<1024> buffer;
+  auto abandoned = buffer.TryReserve(100);
+  ASSERT_TRUE(abandoned);
+  ASSERT_TRUE(buffer.TryPush("next", 5));
+  buffer.Commit(abandoned, 0);
+
+  char out[16]{};
+  EXPECT_EQ(buffer.TryPop(out, sizeof(out)), 5u);
+  EXPECT_STREQ(out, "next");
+  EXPECT_TRUE(buffer.Empty());
+}
+
+TEST(MPSCRingBuffer, PeekAndPopBatch)
+{
+  MPSCRingBuffer<TestItem, 8> buffer;
+  for (uint32_t i = 0; i < 6; ++i)
+  {
+    ASSERT_TRUE(buffer.TryPush(TestItem{0, i}));
+  }
+  // 中间有未提交的槽位时批量读取在此停下
+  auto pending = buffer.TryReserve();
+  ASSERT_TRUE(pending);
+  ASSERT_TRUE(buffer.TryPush(TestItem{0, 7}));
+
+  ASSERT_EQ(buffer.PeekBatch(4), 4u);
+  EXPECT_EQ(buffer.PeekAt(3).sequence, 3u);
+  buffer.ReleaseBatch(4);
+
+  TestItem out[8];
+  ASSERT_EQ(buffer.TryPopBatch(out, 8), 2u);
+  EXPECT_EQ(out[0].sequence, 4u);
+  EXPECT_EQ(out[1].sequence, 5u);
+
+  pending.data->sequence = 6;
+  buffer.Commit(pending);
+  ASSERT_EQ(buffer.TryPopBatch(out, 8), 2u);
+  EXPECT_EQ(out[0].sequence, 6u);
+  EXPECT_EQ(out[1].sequence, 7u);
+  EXPECT_TRUE(buffer.Empty());
+}
+
+TEST(MPSCByteRingBuffer, PeekNextReleaseToAcrossPadding)
+{
+  MPSCByteRingBuffer<1024> buffer;  // 16 块
+  char record[512] = {};
+  for (int i = 0; i < 3; ++i)
+  {
+    record[0] = static_cast<char>('a' + i);
+    ASSERT_TRUE(buffer.TryPush(record, 300));  // 每条 5 块
+  }
+  char out[512];
+  ASSERT_EQ(buffer.TryPop(out, sizeof(out)), 300u);
+  ASSERT_EQ(buffer.TryPop(out, sizeof(out)), 300u);
+  // 尾部只剩 1 块：'d' 前插入填充记录，从头开始
+  record[0] = 'd';
+  ASSERT_TRUE(buffer.TryPush(record, 300));
+  record[0] = 'e';
+  ASSERT_TRUE(buffer.TryPush(record, 100));
+
+  std::string seen;
+  uint32_t size = 0;
+  uint32_t cursor = buffer.ReadCursor();
+  while (const uint8_t* data = buffer.PeekNext(cursor, size))
+  {
+    seen += static_cast<char>(data[0]);
+  }
+  EXPECT_EQ(seen, "cde");
+  EXPECT_FALSE(buffer.TryPush(record, 500));  // 归还前空间仍被占用
+  buffer.ReleaseTo(cursor);
+  EXPECT_TRUE(buffer.Empty());
+  EXPECT_TRUE(buffer.TryPush(record, 500));
+}
@@ -12,6 +12,10 @@
 #include "../include/br_logger/log_level.hpp"
 #include "../include/br_logger/sinks/ring_memory_sink.hpp"
 
+static constexpr br_logger::LogSite K_TEST_SITE{
+    "/src/main.cpp", "main.cpp", "process", "void process(int)",
+    42, 0, br_logger::LogLevel::INFO, "", 0};
+
 static br_logger::LogEntry make_test_entry(
     br_logger::LogLevel level = br_logger::LogLevel::INFO,
     const char* msg = "test message", uint64_t seq = 1001)
@@ -20,12 +24,7 @@ static br_logger::LogEntry make_test_entry(
   entry.wall_clock_ns = 1739692200123456000ULL;
   entry.timestamp_ns = 123456789ULL;
   entry.level = level;
-  entry.file_path = "/src/main.cpp";
-  entry.file_name = "main.cpp";
-  entry.function_name = "process";
-  entry.pretty_function = "void process(int)";
-  entry.line = 42;
-  entry.column = 0;
+  entry.site = &K_TEST_SITE;
   entry.thread_id = 1234;
   entry.process_id = 5678;
   std::strncpy(entry.thread_name, "worker", sizeof(entry.thread_name));
@@ -15,8 +15,13 @@
 #include "../include/br_logger/formatters/pattern_formatter.hpp"
 #include "../include/br_logger/log_entry.hpp"
 #include "../include/br_logger/log_level.hpp"
+#include "../include/br_logger/sinks/parallel_format_adapter.hpp"
 #include "../include/br_logger/sinks/rotating_file_sink.hpp"
 
+static constexpr br_logger::LogSite K_TEST_SITE{
+    "/src/main.cpp", "main.cpp", "process", "void process(int)",
+    42, 0, br_logger::LogLevel::INFO, "", 0};
+
 static br_logger::LogEntry make_entry(
     br_logger::LogLevel level = br_logger::LogLevel::INFO,
     const char* msg = "test message")
@@ -25,12 +30,7 @@ static br_logger::LogEntry make_entry(
   entry.wall_clock_ns = 1739692200123456000ULL;
   entry.timestamp_ns = 123456789ULL;
   entry.level = level;
-  entry.file_path = "/src/main.cpp";
-  entry.file_name = "main.cpp";
-  entry.function_name = "process";
-  entry.pretty_function = "void process(int)";
-  entry.line = 42;
-  entry.column = 0;
+  entry.site = &K_TEST_SITE;
   entry.thread_id = 1234;
   entry.process_id = 5678;
   std::strncpy(entry.thread_name, "worker", sizeof(entry.thread_name));
@@ -389,3 +389,72 @@ TEST_F(RotatingFileSinkTest, ExistingFileAppendsOnReopen)
   EXPECT_NE(content.find("session_one"), std::string::npos);
   EXPECT_NE(content.find("session_two"), std::string::npos);
 }
+
+TEST_F(RotatingFileSinkTest, WriteBatchRotatesBetweenLines)
+{
+  br_logger::RotatingFileSink sink(base_path_, 30, 3);
+  sink.SetFormatter(std::make_unique<MockFileFmt>());
+  sink.SetLevel(br_logger::LogLevel::INFO);
+
+  br_logger::LogEntry entries[] = {
+      make_entry(br_logger::LogLevel::INFO, "batch_line_one"),
+      make_entry(br_logger::LogLevel::DEBUG, "filtered"),
+      make_entry(br_logger::LogLevel::INFO, "batch_line_two"),
+      make_entry(br_logger::LogLevel::INFO, "batch_line_three"),
+  };
+  sink.WriteBatch(entries, 4);
+  sink.Flush();
+
+  // 每个文件不超过 30 字节，整行写入，不会被拆到两个文件
+  EXPECT_EQ(ReadFile(base_path_ + ".1.log"), "batch_line_one\nbatch_line_two\n");
+  EXPECT_EQ(ReadFile(base_path_), "batch_line_three\n");
+}
+
+TEST_F(RotatingFileSinkTest, BatchIsBufferedUntilIdle)
+{
+  br_logger::RotatingFileSink sink(base_path_, 1 << 20, 3);
+  sink.SetFormatter(std::make_unique<MockFileFmt>());
+
+  br_logger::LogEntry entries[8];
+  for (int i = 0; i < 8; ++i)
+  {
+    entries[i] = make_entry(br_logger::LogLevel::INFO, "buffered_line");
+  }
+  sink.WriteBatch(entries, 8);
+  EXPECT_EQ(FileSize(base_path_), 0u);
+
+  // 后端取空队列时整批一次写出
+  sink.OnIdle();
+  EXPECT_EQ(FileSize(base_path_), 8 * sizeof("buffered_line"));
+  EXPECT_EQ(sink.WriterStats().syscalls, 1u);
+}
+
+#if BR_LOG_HAS_THREAD
+TEST_F(RotatingFileSinkTest, ParallelFormattedOutputMatchesWriteBatch)
+{
+  std::string direct_path = tmp_dir_ + "/direct.log";
+  {
+    br_logger::RotatingFileSink direct(direct_path, 300, 5);
+    direct.SetFormatter(std::make_unique<MockFileFmt>());
+    br_logger::ParallelFormatAdapter parallel(
+        std::make_unique<br_logger::RotatingFileSink>(base_path_, 300, 5),
+        std::make_unique<MockFileFmt>());
+    for (int i = 0; i < 100; ++i)
+    {
+      std::string msg = "line_" + std::to_string(i);
+      auto entry = make_entry(br_logger::LogLevel::INFO, msg.c_str());
+      direct.Write(entry);
+      parallel.Write(entry);
+    }
+    direct.Flush();
+    parallel.Flush();
+  }
+  EXPECT_EQ(ReadFile(base_path_), ReadFile(direct_path));
+  for (int i = 1; i <= 2; ++i)
+  {
+    std::string suffix = "." + std::to_string(i) + ".log";
+    EXPECT_TRUE(FileExists(base_path_ + suffix));
+    EXPECT_EQ(ReadFile(base_path_ + suffix), ReadFile(direct_path + suffix));
+  }
+}
+#endif
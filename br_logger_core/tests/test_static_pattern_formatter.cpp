@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+#include "../include/br_logger/formatters/pattern_formatter.hpp"
+#include "../include/br_logger/formatters/static_pattern_formatter.hpp"
+#include "../include/br_logger/log_entry.hpp"
+#include "../include/br_logger/platform.hpp"
+
+static constexpr br_logger::LogSite K_TEST_SITE{
+    "/src/main.cpp", "main.cpp", "process", "void process(int)",
+    42, 0, br_logger::LogLevel::INFO, "", 0};
+
+static br_logger::LogEntry make_test_entry(br_logger::LogLevel level = br_logger::LogLevel::INFO)
+{
+  br_logger::LogEntry entry{};
+  entry.wall_clock_ns = 1739692200123456000ULL;
+  entry.level = level;
+  entry.site = &K_TEST_SITE;
+  entry.thread_id = 1234;
+  entry.process_id = 5678;
+  std::strncpy(entry.thread_name, "worker", sizeof(entry.thread_name));
+  entry.tag_count = 2;
+  entry.tags[0].key = br_logger::TagDictionary::Instance().Intern("env");
+  entry.tags[0].value = br_logger::TagDictionary::Instance().Intern("prod");
+  entry.tags[1].key = br_logger::TagDictionary::Instance().Intern("req");
+  entry.tags[1].value = br_logger::TagDictionary::Instance().Intern("abc123");
+  entry.sequence_id = 18446744073709551615ULL;
+  const char* msg = "hello world";
+  entry.msg_len = static_cast<uint16_t>(std::strlen(msg));
+  std::strncpy(entry.msg, msg, BR_LOG_MAX_MSG_LEN);
+  return entry;
+}
+
+static std::string format_with(br_logger::IFormatter& formatter, const br_logger::LogEntry& entry,
+                               size_t buf_size = 512)
+{
+  char buf[512];
+  size_t len = formatter.Format(entry, buf, buf_size);
+  EXPECT_EQ(len, std::strlen(buf));
+  return std::string(buf, len);
+}
+
+// 对同一模式比较 StaticPatternFormatter 与 PatternFormatter 在各级别、彩色开关、无 site、
+// 无 tag 以及各种缓冲区大小下的输出
+#define EXPECT_SAME_AS_DYNAMIC(pattern)                                                    \
+  do                                                                                       \
+  {                                                                                        \
+    BR_LOG_STATIC_PATTERN_FORMATTER(Static, pattern);                                      \
+    for (bool color : {true, false})                                                       \
+    {                                                                                      \
+      Static fast(color);                                                                  \
+      br_logger::PatternFormatter dynamic(pattern, color);                                 \
+      for (int level = 0; level <= 6; ++level)                                             \
+      {                                                                                    \
+        auto entry = make_test_entry(static_cast<br_logger::LogLevel>(level));             \
+        EXPECT_EQ(format_with(fast, entry), format_with(dynamic, entry)) << pattern;       \
+        entry.site = nullptr;                                                              \
+        entry.tag_count = 0;                                                               \
+        EXPECT_EQ(format_with(fast, entry), format_with(dynamic, entry)) << pattern;       \
+      }                                                                                    \
+      auto entry = make_test_entry();                                                      \
+      for (size_t size = 1; size < 80; ++size)                                             \
+      {                                                                                    \
+        EXPECT_EQ(format_with(fast, entry, size), format_with(dynamic, entry, size))       \
+            << pattern << " buf_size=" << size;                                            \
+      }                                                                                    \
+    }                                                                                      \
+  } while (0)
+
+TEST(StaticPatternFormatter, MatchesDynamicForEveryPlaceholder)
+{
+  EXPECT_SAME_AS_DYNAMIC("%D");
+  EXPECT_SAME_AS_DYNAMIC("%T");
+  EXPECT_SAME_AS_DYNAMIC("%e");
+  EXPECT_SAME_AS_DYNAMIC("%L");
+  EXPECT_SAME_AS_DYNAMIC("%l");
+  EXPECT_SAME_AS_DYNAMIC("%f");
+  EXPECT_SAME_AS_DYNAMIC("%F");
+  EXPECT_SAME_AS_DYNAMIC("%n");
+  EXPECT_SAME_AS_DYNAMIC("%N");
+  EXPECT_SAME_AS_DYNAMIC("%#");
+  EXPECT_SAME_AS_DYNAMIC("%t");
+  EXPECT_SAME_AS_DYNAMIC("%P");
+  EXPECT_SAME_AS_DYNAMIC("%k");
+  EXPECT_SAME_AS_DYNAMIC("%q");
+  EXPECT_SAME_AS_DYNAMIC("%g");
+  EXPECT_SAME_AS_DYNAMIC("%m");
+  EXPECT_SAME_AS_DYNAMIC("%C");
+  EXPECT_SAME_AS_DYNAMIC("%R");
+  EXPECT_SAME_AS_DYNAMIC("100%%");
+}
+
+TEST(StaticPatternFormatter, MatchesDynamicForFullPatterns)
+{
+  EXPECT_SAME_AS_DYNAMIC("[%D %T%e] [%C%L%R] [tid:%t] [%f:%#::%n] %g %m");
+  EXPECT_SAME_AS_DYNAMIC("%F:%# %N pid=%P %k #%q %l|%m");
+  EXPECT_SAME_AS_DYNAMIC("");
+  EXPECT_SAME_AS_DYNAMIC("plain text only");
+  EXPECT_SAME_AS_DYNAMIC("%x %y %% %");
+  EXPECT_SAME_AS_DYNAMIC("%%%m%%");
+  EXPECT_SAME_AS_DYNAMIC("50%-");
+  EXPECT_SAME_AS_DYNAMIC("%5x %-3%m %=");
+}
+
+TEST(StaticPatternFormatter, LiteralsAreMerged)
+{
+  BR_LOG_STATIC_PATTERN_FORMATTER(Merged, "a%%b%xc%L[%");
+  static_assert(Merged::OpCount() == 3, "literal / level / literal");
+  Merged formatter(false);
+  auto entry = make_test_entry();
+  EXPECT_EQ(format_with(formatter, entry), "a%b%xcINFO[%");
+}
+
+TEST(StaticPatternFormatter, WidthAlignAndTruncate)
+{
+  auto entry = make_test_entry(br_logger::LogLevel::WARN);
+  BR_LOG_STATIC_PATTERN_FORMATTER(Right, "[%6L]");
+  BR_LOG_STATIC_PATTERN_FORMATTER(Left, "[%-6L]");
+  BR_LOG_STATIC_PATTERN_FORMATTER(Center, "[%=7L]");
+  BR_LOG_STATIC_PATTERN_FORMATTER(Truncated, "[%3!L|%-3!f|%=3!m|%3L]");
+  BR_LOG_STATIC_PATTERN_FORMATTER(Wide, "%-12f:%5#");
+  Right right(false);
+  Left left(false);
+  Center center(false);
+  Truncated truncated(false);
+  Wide wide(false);
+  EXPECT_EQ(format_with(right, entry), "[  WARN]");
+  EXPECT_EQ(format_with(left, entry), "[WARN  ]");
+  EXPECT_EQ(format_with(center, entry), "[ WARN  ]");
+  EXPECT_EQ(format_with(truncated, entry), "[WAR|mai|hel|WARN]");
+  EXPECT_EQ(format_with(wide, entry), "main.cpp    :   42");
+}
+
+TEST(StaticPatternFormatter, PaddingRespectsBufferSize)
+{
+  auto entry = make_test_entry();
+  BR_LOG_STATIC_PATTERN_FORMATTER(Padded, "%8L|%-8l|%=8t");
+  Padded formatter(false);
+  std::string full = format_with(formatter, entry);
+  EXPECT_EQ(full, "    INFO|I       |  1234  ");
+  for (size_t size = 1; size <= full.size() + 1; ++size)
+  {
+    EXPECT_EQ(format_with(formatter, entry, size), full.substr(0, size - 1)) << size;
+  }
+}
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+TEST(StaticPatternFormatter, StringLiteralTemplateArgument)
+{
+  br_logger::StaticPatternFormatter<"[%C%-5L%R] %m"> formatter(true);
+  auto entry = make_test_entry();
+  EXPECT_EQ(format_with(formatter, entry), "[\033[32mINFO \033[0m] hello world");
+}
+#endif
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+#include "br_logger/clock_source.hpp"
+#include "br_logger/log_context.hpp"
+#include "br_logger/log_entry.hpp"
+#include "br_logger/log_record.hpp"
+
+using br_logger::LogContext;
+using br_logger::LogEntry;
+using br_logger::TagDictionary;
+
+namespace
+{
+
+// 把驻留表填满，其余用例都在满表状态下运行，因此单独成为一个测试程序
+void fill_dictionary()
+{
+  auto& dict = TagDictionary::Instance();
+  constexpr size_t K_CAPACITY = TagDictionary::K_MAX_SEGMENTS * TagDictionary::K_SEGMENT_SIZE;
+  for (size_t i = 0; dict.Size() < K_CAPACITY; ++i)
+  {
+    dict.Intern("fill_" + std::to_string(i));
+  }
+}
+
+std::string_view find_value(const LogEntry& entry, const char* key)
+{
+  for (uint8_t i = 0; i < entry.tag_count; ++i)
+  {
+    if (TagDictionary::Instance().Resolve(entry.tags[i].key) == key)
+    {
+      return br_logger::tag_value(entry, entry.tags[i]);
+    }
+  }
+  return "<missing>";
+}
+
+}  // namespace
+
+TEST(TagDictionary, ValuesPastCapacityKeepTheirText)
+{
+  auto& dict = TagDictionary::Instance();
+  dict.Intern("session");
+  dict.Intern("region");
+  fill_dictionary();
+  EXPECT_EQ(dict.Intern("one_more"), TagDictionary::K_OVERFLOW_ID);
+
+  LogContext::Instance().SetGlobalTag("region", "eu-west");
+  for (int i = 0; i < 3; ++i)
+  {
+    std::string value = "session-" + std::to_string(i);
+    LogContext::ScopedTag repeated("session", value.c_str());
+    LogContext::ScopedTag again("session", value.c_str());
+    LogEntry entry{};
+    LogContext::Instance().FillTags(entry);
+    EXPECT_EQ(find_value(entry, "session"), value);
+    EXPECT_EQ(find_value(entry, "region"), "eu-west");
+  }
+  LogContext::Instance().RemoveGlobalTag("region");
+}
+
+TEST(TagDictionary, InlineValuesSurviveRecordRoundTrip)
+{
+  auto& dict = TagDictionary::Instance();
+  dict.Intern("session");
+  dict.Intern("region");
+  fill_dictionary();
+  LogContext::ScopedTag first("session", "/var/log/a.txt");
+  LogContext::ScopedTag second("region", "req-0001");
+
+  LogEntry entry{};
+  LogContext::Instance().FillTags(entry);
+  entry.timestamp_ns = 1;
+  entry.msg_len = 2;
+  std::memcpy(entry.msg, "hi", 3);
+  ASSERT_GT(entry.tag_text_len, 0u);
+
+  uint8_t record[br_logger::K_MAX_RECORD_SIZE];
+  size_t size = br_logger::encode_record(entry, record);
+  EXPECT_EQ(size, br_logger::record_size(entry));
+
+  LogEntry decoded{};
+  br_logger::ClockConverter clock;
+  br_logger::decode_record(record, decoded, clock);
+  EXPECT_EQ(find_value(decoded, "session"), "/var/log/a.txt");
+  EXPECT_EQ(find_value(decoded, "region"), "req-0001");
+  EXPECT_EQ(std::string(decoded.msg, decoded.msg_len), "hi");
+}
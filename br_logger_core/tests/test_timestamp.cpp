@@ -1,8 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <regex>
+#include <string>
 
+#include "br_logger/clock_source.hpp"
 #include "br_logger/timestamp.hpp"
 
 using namespace br_logger;
@@ -81,3 +85,152 @@ TEST(Timestamp, FormatKnownTimestamp)
   EXPECT_NE(std::strstr(buf, ".123456"), nullptr)
       << "Expected microseconds .123456, got: " << buf;
 }
+
+namespace
+{
+
+// 临时设置 TZ，析构时恢复
+struct ScopedTz
+{
+  std::string saved;
+  bool had = false;
+
+  explicit ScopedTz(const char* tz)
+  {
+    const char* old = std::getenv("TZ");
+    had = old != nullptr;
+    saved = had ? old : "";
+    ::setenv("TZ", tz, 1);
+    ::tzset();
+  }
+  ~ScopedTz()
+  {
+    had ? ::setenv("TZ", saved.c_str(), 1) : ::unsetenv("TZ");
+    ::tzset();
+  }
+};
+
+std::string reference_timestamp(uint64_t wall_ns)
+{
+  time_t sec = static_cast<time_t>(wall_ns / 1'000'000'000ULL);
+  struct tm tm_val{};
+  localtime_r(&sec, &tm_val);
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d.%06u", tm_val.tm_year + 1900,
+                tm_val.tm_mon + 1, tm_val.tm_mday, tm_val.tm_hour, tm_val.tm_min, tm_val.tm_sec,
+                static_cast<unsigned>(wall_ns / 1000 % 1'000'000));
+  return buf;
+}
+
+}  // namespace
+
+// 缓存的偏移在夏令时切换（含半小时偏移的时区）前后都与 localtime_r 一致
+TEST(Timestamp, CachedOffsetFollowsDstTransitions)
+{
+  const char* zones[] = {"EST5EDT,M3.2.0,M11.1.0", "<+1030>-10:30<+11>-11,M10.1.0,M4.1.0", "UTC0"};
+  const uint64_t starts[] = {1710054000ULL, 1730613600ULL, 1728142200ULL, 1712415600ULL};
+  for (const char* zone : zones)
+  {
+    ScopedTz tz(zone);
+    for (uint64_t start : starts)
+    {
+      // 切换点前后各两小时，步长 7 秒 + 不同的小数部分
+      for (uint64_t sec = start - 7200; sec < start + 7200; sec += 7)
+      {
+        uint64_t ns = sec * 1'000'000'000ULL + (sec % 1000) * 1'000'123ULL;
+        char buf[64]{};
+        format_timestamp(ns, buf, sizeof(buf));
+        ASSERT_EQ(std::string(buf), reference_timestamp(ns)) << zone << " sec=" << sec;
+      }
+    }
+  }
+}
+
+TEST(Timestamp, TimezoneChangeIsPickedUp)
+{
+  uint64_t ts = 1708099200ULL * 1'000'000'000ULL;
+  char buf[32]{};
+  {
+    ScopedTz tz("UTC0");
+    format_clock_time(ts, buf, sizeof(buf));
+    EXPECT_STREQ(buf, "16:00:00");
+  }
+  {
+    ScopedTz tz("JST-9");
+    format_clock_time(ts + 1'000'000'000ULL, buf, sizeof(buf));
+    EXPECT_STREQ(buf, "01:00:01");
+    format_date(ts + 1'000'000'000ULL, buf, sizeof(buf));
+    EXPECT_STREQ(buf, "2024-02-17");
+  }
+}
+
+TEST(Timestamp, MicrosAndClockTime)
+{
+  ScopedTz tz("UTC0");
+  uint64_t ts = 1708099200ULL * 1'000'000'000ULL + 7'000ULL;
+  char buf[32]{};
+  EXPECT_EQ(format_micros(ts, buf, sizeof(buf)), 7u);
+  EXPECT_STREQ(buf, ".000007");
+  EXPECT_EQ(format_time(ts, buf, sizeof(buf)), 15u);
+  EXPECT_STREQ(buf, "16:00:00.000007");
+}
+
+TEST(ClockSource, PreciseIsAlwaysAvailable)
+{
+  EXPECT_TRUE(clock_source_available(ClockSource::PRECISE));
+}
+
+TEST(ClockSource, ConvertedTicksTrackMonotonicAndWallClock)
+{
+  ClockConverter converter;
+  for (auto source : {ClockSource::PRECISE, ClockSource::COARSE, ClockSource::TSC})
+  {
+    if (!clock_source_available(source))
+    {
+      continue;
+    }
+    converter.Refresh();
+    uint64_t mono_before = monotonic_now_ns();
+    uint64_t wall_before = wall_clock_now_ns();
+    uint64_t ticks = read_clock(source);
+    uint64_t mono_after = monotonic_now_ns();
+
+    uint64_t mono = 0;
+    uint64_t wall = 0;
+    converter.Convert(static_cast<uint8_t>(source), ticks, mono, wall);
+    // COARSE 的分辨率为一个内核 tick，允许 20ms 误差；其余 1ms
+    uint64_t tolerance = source == ClockSource::COARSE ? 20'000'000ULL : 1'000'000ULL;
+    EXPECT_GE(mono + tolerance, mono_before) << static_cast<int>(source);
+    EXPECT_LE(mono, mono_after + tolerance) << static_cast<int>(source);
+    EXPECT_GE(wall + tolerance, wall_before) << static_cast<int>(source);
+    EXPECT_LE(wall, wall_before + (mono_after - mono_before) + tolerance)
+        << static_cast<int>(source);
+  }
+}
+
+TEST(ClockSource, TscTicksBeforeRefreshConvertBackwards)
+{
+  if (!clock_source_available(ClockSource::TSC))
+  {
+    GTEST_SKIP() << "invariant TSC not available";
+  }
+  ClockConverter converter;
+  uint64_t early = read_clock(ClockSource::TSC);
+  uint64_t early_mono = monotonic_now_ns();
+  converter.Refresh();
+
+  uint64_t mono = 0;
+  uint64_t wall = 0;
+  converter.Convert(static_cast<uint8_t>(ClockSource::TSC), early, mono, wall);
+  EXPECT_LE(mono, monotonic_now_ns());
+  EXPECT_NEAR(static_cast<double>(mono), static_cast<double>(early_mono), 1'000'000.0);
+}
+
+TEST(ClockSource, PreciseTicksAreMonotonicNanoseconds)
+{
+  ClockConverter converter;
+  uint64_t mono = 0;
+  uint64_t wall = 0;
+  converter.Convert(static_cast<uint8_t>(ClockSource::PRECISE), 12345, mono, wall);
+  EXPECT_EQ(mono, 12345u);
+}
@@ -14,10 +14,13 @@ void ROS2Sink::Write(const LogEntry& entry)
     return;
   }
 
-  rcutils_log_location_t location;
-  location.function_name = entry.function_name;
-  location.file_name = entry.file_name;
-  location.line_number = entry.line;
+  rcutils_log_location_t location{};
+  if (entry.site)
+  {
+    location.function_name = entry.site->function_name;
+    location.file_name = entry.site->file_name;
+    location.line_number = entry.site->line;
+  }
 
   rcutils_log(&location, MapLevel(entry.level), ros_logger_.get_name(), "%s", entry.msg);
 }